@@ -13,13 +13,60 @@
 #include <gui/modules/widget.h>
 #include <dialogs/dialogs.h>
 #include <notification/notification_messages.h>
+#include <string.h>
+
+#include "evil_bw16_proto.h"
 
 #define EVIL_BW16_TEXT_BOX_STORE_SIZE (4096)
 #define EVIL_BW16_TEXT_INPUT_STORE_SIZE (512)
-#define EVIL_BW16_UART_BAUD_RATE (115200)
+#define EVIL_BW16_UART_BAUD_RATE (115200)  // BW16 boot rate, faster ones are negotiated
 #define EVIL_BW16_UART_RX_BUF_SIZE (2048)
-#define EVIL_BW16_MAX_NETWORKS (50)
+#define EVIL_BW16_UART_RX_BUF_MAX (16384)  // RAM budget for the adaptive RX ring
+#define EVIL_BW16_MAX_NETWORKS (50)  // Rows in the live scan view, networks per bench scan
+#define EVIL_BW16_NETWORK_TABLE_MAX (1024)  // Scan list cap whatever the budget
+#define EVIL_BW16_NETWORK_RAM_DEFAULT (8)  // KB for the scan list, see evil_bw16_network_table.c
+#define EVIL_BW16_NETWORK_NONE (0xFFFF)
+#define EVIL_BW16_BSSID_STR_LEN (18)
+#define EVIL_BW16_SSID_MAX_LEN (32)  // 802.11 limit; longer SSIDs are cut
+#define EVIL_BW16_NETWORK_MAX_AGE_MS (5 * 60 * 1000)  // Networks not heard for this long leave the scan list
 #define EVIL_BW16_MAX_TARGETS (10)
+#define EVIL_BW16_LOG_STORE_SIZE (4096)  // Bytes of log text kept for the terminal
+#define EVIL_BW16_LOG_STORE_LINES (128)  // Power of two
+#define EVIL_BW16_DEBUG_LOG_PATH EXT_PATH("apps_data/evil_bw16_debug.txt")
+#define EVIL_BW16_CAPTURE_PATH EXT_PATH("apps_data/evil_bw16_capture.bin")
+#define EVIL_BW16_CAPTURE_MAX_CHUNK (512)
+#define EVIL_BW16_NOTIFY_INTERVAL_MS (100)  // Shortest gap between worker -> GUI wakeups
+
+// Log verbosity
+// EVIL_BW16_LOG_LEVEL_MAX is the compile-time ceiling: messages above it are compiled out
+// (add cdefines=["EVIL_BW16_LOG_LEVEL_MAX=2"] to application.fam for a lean build).
+// Below it, the runtime level is checked before any argument is evaluated or formatted.
+#define EVIL_BW16_LOG_LEVEL_NONE (0)
+#define EVIL_BW16_LOG_LEVEL_ERROR (1)
+#define EVIL_BW16_LOG_LEVEL_WARN (2)
+#define EVIL_BW16_LOG_LEVEL_INFO (3)
+#define EVIL_BW16_LOG_LEVEL_DEBUG (4)
+
+#ifndef EVIL_BW16_LOG_LEVEL_MAX
+#define EVIL_BW16_LOG_LEVEL_MAX EVIL_BW16_LOG_LEVEL_DEBUG
+#endif
+
+extern uint8_t evil_bw16_log_level;  // Live copy of EvilBw16Config.log_level
+
+#define EVIL_BW16_LOG_ENABLED(level) \
+    ((level) <= EVIL_BW16_LOG_LEVEL_MAX && (level) <= evil_bw16_log_level)
+
+#define EVIL_BW16_LOG(level, furi_log, ...)    \
+    do {                                       \
+        if(EVIL_BW16_LOG_ENABLED(level)) {     \
+            furi_log("EvilBw16", __VA_ARGS__); \
+        }                                      \
+    } while(0)
+
+#define EVIL_BW16_LOG_E(...) EVIL_BW16_LOG(EVIL_BW16_LOG_LEVEL_ERROR, FURI_LOG_E, __VA_ARGS__)
+#define EVIL_BW16_LOG_W(...) EVIL_BW16_LOG(EVIL_BW16_LOG_LEVEL_WARN, FURI_LOG_W, __VA_ARGS__)
+#define EVIL_BW16_LOG_I(...) EVIL_BW16_LOG(EVIL_BW16_LOG_LEVEL_INFO, FURI_LOG_I, __VA_ARGS__)
+#define EVIL_BW16_LOG_D(...) EVIL_BW16_LOG(EVIL_BW16_LOG_LEVEL_DEBUG, FURI_LOG_D, __VA_ARGS__)
 
 // Scene definitions
 typedef enum {
@@ -34,6 +81,9 @@ typedef enum {
     EvilBw16SceneConfig,
     EvilBw16SceneDeviceInfo,
     EvilBw16SceneUartTerminal,
+#ifdef EVIL_BW16_DEVTOOLS
+    EvilBw16SceneReplay,
+#endif
     EvilBw16SceneNum,
 } EvilBw16Scene;
 
@@ -48,6 +98,9 @@ typedef enum {
     EvilBw16ViewTextInput,
     EvilBw16ViewPopup,
     EvilBw16ViewWidget,
+    EvilBw16ViewTerminal,
+    EvilBw16ViewSnifferStats,
+    EvilBw16ViewScannerLive,
 } EvilBw16View;
 
 // Command types
@@ -78,7 +131,10 @@ typedef enum {
     EvilBw16ResponseAttackStatus,
     EvilBw16ResponseCommand,
     EvilBw16ResponseChannelHop,
+    EvilBw16ResponseMgmt,
+    EvilBw16ResponseData,
     EvilBw16ResponseUnknown,
+    EvilBw16ResponseTypeNum,
 } EvilBw16ResponseType;
 
 // Attack modes
@@ -111,18 +167,108 @@ typedef enum {
     EvilBw16GpioPins15_16 = 1,  // LPUART (pins 15/16)
 } EvilBw16GpioPins;
 
-// WiFi Network structure
+// WiFi Network structure, 24 bytes. The SSID is kept in the scan list's arena.
 typedef struct {
-    uint8_t index;           // Internal array index for menu selection
-    uint8_t device_index;    // Original index from BW16 device (for commands)
-    char ssid[64];
-    char bssid[18];
-    int channel;
-    int rssi;
-    EvilBw16Band band;
-    bool selected;
+    uint8_t bssid[6];        // Key of the scan list, see evil_bw16_format_bssid()
+    uint16_t ssid;           // Arena offset, see evil_bw16_network_table_get_ssid()
+    uint32_t first_seen;     // Ticks, set by the scan list
+    uint32_t last_seen;
+    int16_t rssi_avg;        // Smoothed, in 1/16 dBm; see evil_bw16_network_rssi_avg()
+    uint16_t seen_count;     // Scans it was heard in
+    int8_t rssi;             // Latest report
+    uint8_t channel;
+    uint8_t device_index;    // Index in the BW16's latest scan that listed it (for commands)
+    uint8_t band : 2;        // EvilBw16Band
+    uint8_t selected : 1;
 } EvilBw16Network;
 
+// Non-owning view of one received line (not NUL-terminated)
+typedef struct {
+    const char* data;
+    size_t len;
+} EvilBw16LineView;
+
+// Line filter rule: drop any line containing pattern
+typedef struct {
+    const char* pattern;
+    char first_char;  // If set, the rule only applies to lines starting with this character
+} EvilBw16FilterRule;
+
+typedef struct EvilBw16LineFilter EvilBw16LineFilter;
+
+// Per-line processing time histogram: four log-linear buckets per power of two microseconds
+#define EVIL_BW16_PROFILE_BUCKETS (64)
+
+typedef struct {
+    uint32_t lines;
+    uint64_t cycles;      // Total CPU cycles spent handling lines
+    uint32_t max_cycles;
+    uint32_t histogram[EVIL_BW16_PROFILE_BUCKETS];
+} EvilBw16UartProfile;
+
+// RX health counters, see evil_bw16_uart_get_stats()
+typedef struct {
+    uint32_t dropped_bytes;    // Lost to a full RX ring
+    uint32_t truncated_lines;  // Discarded for exceeding the line buffer
+    uint32_t high_water;       // Highest RX ring fill level seen
+    uint32_t ring_size;
+    uint32_t ring_grows;
+    bool binary_protocol;      // Output currently arrives framed, see evil_bw16_proto.h
+    uint32_t frames;           // Binary frames decoded
+    uint32_t frame_crc_errors; // Binary frames dropped for a bad CRC
+    uint32_t proto_fallbacks;  // Times the link fell back to text on undecodable input
+} EvilBw16UartStats;
+
+typedef struct EvilBw16Replay EvilBw16Replay;
+typedef struct EvilBw16CaptureWriter EvilBw16CaptureWriter;
+typedef struct EvilBw16LogStore EvilBw16LogStore;
+typedef struct EvilBw16CaptureReader EvilBw16CaptureReader;
+typedef struct EvilBw16TerminalView EvilBw16TerminalView;
+typedef struct EvilBw16StorageWriter EvilBw16StorageWriter;
+typedef struct EvilBw16Notifier EvilBw16Notifier;
+typedef struct EvilBw16SnifferView EvilBw16SnifferView;
+typedef struct EvilBw16ScannerView EvilBw16ScannerView;
+typedef void (*EvilBw16ScannerViewCallback)(void* context);
+typedef struct EvilBw16Sim EvilBw16Sim;
+typedef struct EvilBw16NetworkTable EvilBw16NetworkTable;
+typedef uint16_t EvilBw16NetworkHandle;  // Names its network until the network is removed
+
+typedef struct {
+    size_t count;
+    size_t capacity;     // Networks the budget holds
+    size_t budget;       // Bytes
+    size_t bytes;        // Allocated now
+    size_t ssid_bytes;   // Arena in use
+    uint32_t ssids_shared; // New networks whose SSID was already in the arena
+    uint32_t duplicates; // Reports of a BSSID already heard in the same scan
+    uint32_t merged;     // Networks heard again in a later scan
+    uint32_t rejected;   // New networks over capacity
+    uint32_t evicted;    // Older networks dropped to make room for new ones
+} EvilBw16NetworkTableStats;
+
+// Orders the scan list keeps up to date as results merge
+typedef enum {
+    EvilBw16NetworkSortArrival,  // First seen first
+    EvilBw16NetworkSortRssi,     // Strongest smoothed RSSI first
+    EvilBw16NetworkSortChannel,
+    EvilBw16NetworkSortBand,     // 2.4GHz, then 5GHz
+    EvilBw16NetworkSortSsid,     // Alphabetical, hidden last
+    EvilBw16NetworkSortNum,
+} EvilBw16NetworkSort;
+
+typedef struct {
+    EvilBw16Band band;  // EvilBw16BandUnknown for both bands
+    int8_t min_rssi;    // Smoothed; INT8_MIN for no limit
+} EvilBw16NetworkFilter;
+
+// Output of the simulated BW16 since it was started
+typedef struct {
+    uint32_t commands;
+    uint32_t scans;
+    uint32_t frames;  // Sniffed frames generated
+    uint32_t bytes;   // Bytes put on the simulated line
+} EvilBw16SimStats;
+
 // Configuration structure
 typedef struct {
     uint32_t cycle_delay;
@@ -133,6 +279,11 @@ typedef struct {
     bool led_enabled;
     bool debug_mode;
     EvilBw16GpioPins gpio_pins;  // GPIO pin selection
+    uint32_t baud_rate;          // Highest UART rate to negotiate
+    bool adaptive_rx_buffer;     // Grow the RX ring when it keeps running near full
+    uint8_t log_level;           // EVIL_BW16_LOG_LEVEL_*, see evil_bw16_set_log_level
+    bool binary_protocol;        // Ask the BW16 for framed output, text stays the fallback
+    uint8_t network_ram_kb;      // Scan list budget
 } EvilBw16Config;
 
 // Attack state
@@ -154,9 +305,42 @@ typedef struct {
     uint32_t packet_count;
 } EvilBw16SnifferState;
 
+// Sniffed frame subtypes, see evil_bw16_sniffer_stats.c
+typedef enum {
+    EvilBw16FrameBeacon,
+    EvilBw16FrameProbeReq,
+    EvilBw16FrameProbeResp,
+    EvilBw16FrameAuth,
+    EvilBw16FrameDeauth,
+    EvilBw16FrameAssoc,
+    EvilBw16FrameDisassoc,
+    EvilBw16FrameAction,
+    EvilBw16FrameEapol,
+    EvilBw16FrameData,
+    EvilBw16FrameOther,
+    EvilBw16FrameSubtypeNum,
+} EvilBw16FrameSubtype;
+
+#define EVIL_BW16_SNIFF_CHANNEL_SLOTS (51)  // 2.4 GHz 1-14, 5 GHz 32-177
+
+// Running sniffer counters, a fixed 264 bytes
+typedef struct {
+    uint32_t total;
+    uint32_t subtype[EvilBw16FrameSubtypeNum];
+    uint32_t band[2];  // 2.4 GHz, 5 GHz
+    uint32_t channel[EVIL_BW16_SNIFF_CHANNEL_SLOTS];
+    uint32_t no_channel;  // Frames without a recognisable channel
+} EvilBw16SnifferCounters;
+
 // UART worker
 typedef struct EvilBw16UartWorker EvilBw16UartWorker;
 
+// Handler for one class of received line, see evil_bw16_uart_set_response_handler()
+typedef void (*EvilBw16ResponseHandler)(EvilBw16LineView line, void* context);
+
+// Receives commands instead of the BW16, see evil_bw16_uart_set_tx_tap()
+typedef void (*EvilBw16TxTap)(const char* command, void* context);
+
 // Main app structure
 typedef struct {
     Gui* gui;
@@ -182,13 +366,16 @@ typedef struct {
     FuriStreamBuffer* uart_rx_stream;
     
     // Data storage
-    EvilBw16Network networks[EVIL_BW16_MAX_NETWORKS];
-    uint8_t network_count;
+    EvilBw16NetworkTable* networks;  // Filled by the UART worker
     bool scan_in_progress;
+    bool scan_timed_out;  // Last scan ended on the timeout, not "Scan completed"
+    EvilBw16NetworkSort results_sort;
+    EvilBw16NetworkFilter results_filter;
     
     EvilBw16Config config;
     EvilBw16AttackState attack_state;
     EvilBw16SnifferState sniffer_state;
+    EvilBw16SnifferCounters sniffer_counters;  // Written by the UART worker only
     
     // UI state
     uint8_t selected_menu_index;
@@ -198,8 +385,19 @@ typedef struct {
     // Status
     bool device_connected;
     char device_info[256];
-    FuriString* log_string;
-    FuriString* uart_log_string;
+    EvilBw16LogStore* log_store;  // RX and TX lines shown by the UART terminal
+    EvilBw16TerminalView* terminal_view;
+    uint32_t terminal_log_seq;    // Log store sequence the terminal last drew
+    EvilBw16SnifferView* sniffer_view;
+    EvilBw16ScannerView* scanner_view;
+    EvilBw16StorageWriter* debug_log;  // INFO lines, written in the background
+    EvilBw16Notifier* notifier;        // Rate limits worker -> GUI events
+    
+#ifdef EVIL_BW16_DEVTOOLS
+    // Diagnostics
+    EvilBw16Replay* replay;
+    EvilBw16Sim* simulator;  // Allocated when first switched on
+#endif
 } EvilBw16App;
 
 // Scene manager events
@@ -217,8 +415,22 @@ typedef enum {
     EvilBw16EventUartTerminalRefresh,
     EvilBw16EventBack,
     EvilBw16EventExit,
+    EvilBw16EventReplayDone,
+    EvilBw16EventScanResult,
+    EvilBw16EventLinkReady,
+    // Coalesced worker notifications; well clear of submenu indices, which share this space
+    EvilBw16EventNotify = 0x1000,
 } EvilBw16Event;
 
+// Event classes the UART worker marks dirty, see evil_bw16_notify.c. Each one is
+// handed to the scene manager as the matching EvilBw16Event.
+typedef enum {
+    EvilBw16NotifyTerminal = (1 << 0),  // EvilBw16EventUartTerminalRefresh
+    EvilBw16NotifyPacket = (1 << 1),    // EvilBw16EventPacketReceived
+    EvilBw16NotifyScan = (1 << 2),      // EvilBw16EventScanResult
+    EvilBw16NotifyLink = (1 << 3),      // EvilBw16EventLinkReady
+} EvilBw16NotifyFlags;
+
 // Function prototypes
 
 // Main app functions
@@ -238,6 +450,9 @@ void evil_bw16_scene_on_enter_sniffer_results(void* context);
 void evil_bw16_scene_on_enter_config(void* context);
 void evil_bw16_scene_on_enter_device_info(void* context);
 void evil_bw16_scene_on_enter_uart_terminal(void* context);
+#ifdef EVIL_BW16_DEVTOOLS
+void evil_bw16_scene_on_enter_replay(void* context);
+#endif
 
 bool evil_bw16_scene_on_event_start(void* context, SceneManagerEvent event);
 bool evil_bw16_scene_on_event_main_menu(void* context, SceneManagerEvent event);
@@ -250,6 +465,9 @@ bool evil_bw16_scene_on_event_sniffer_results(void* context, SceneManagerEvent e
 bool evil_bw16_scene_on_event_config(void* context, SceneManagerEvent event);
 bool evil_bw16_scene_on_event_device_info(void* context, SceneManagerEvent event);
 bool evil_bw16_scene_on_event_uart_terminal(void* context, SceneManagerEvent event);
+#ifdef EVIL_BW16_DEVTOOLS
+bool evil_bw16_scene_on_event_replay(void* context, SceneManagerEvent event);
+#endif
 
 void evil_bw16_scene_on_exit_start(void* context);
 void evil_bw16_scene_on_exit_main_menu(void* context);
@@ -262,6 +480,9 @@ void evil_bw16_scene_on_exit_sniffer_results(void* context);
 void evil_bw16_scene_on_exit_config(void* context);
 void evil_bw16_scene_on_exit_device_info(void* context);
 void evil_bw16_scene_on_exit_uart_terminal(void* context);
+#ifdef EVIL_BW16_DEVTOOLS
+void evil_bw16_scene_on_exit_replay(void* context);
+#endif
 
 // UART Worker Functions
 EvilBw16UartWorker* evil_bw16_uart_init(EvilBw16App* app);
@@ -270,9 +491,32 @@ void evil_bw16_uart_restart(EvilBw16App* app);
 void evil_bw16_uart_tx(EvilBw16UartWorker* worker, const uint8_t* data, size_t len);
 void evil_bw16_uart_tx_string(EvilBw16UartWorker* worker, const char* str);
 void evil_bw16_uart_send_command(EvilBw16UartWorker* worker, const char* command);
-bool evil_bw16_uart_read_line(EvilBw16UartWorker* worker, char* buffer, size_t buffer_size, uint32_t timeout_ms);
 size_t evil_bw16_uart_rx_available(EvilBw16UartWorker* worker);
+void evil_bw16_uart_flush_rx(EvilBw16UartWorker* worker);
+EvilBw16LineFilter* evil_bw16_uart_get_webui_filter(EvilBw16UartWorker* worker);
+void evil_bw16_uart_set_response_handler(EvilBw16UartWorker* worker, EvilBw16ResponseType type, EvilBw16ResponseHandler handler, void* context);
+uint32_t evil_bw16_uart_get_dropped_bytes(EvilBw16UartWorker* worker);
+void evil_bw16_uart_get_stats(EvilBw16UartWorker* worker, EvilBw16UartStats* stats);
+void evil_bw16_uart_profile_start(EvilBw16UartWorker* worker);
+void evil_bw16_uart_profile_stop(EvilBw16UartWorker* worker, EvilBw16UartProfile* profile);
+uint32_t evil_bw16_profile_percentile_us(const EvilBw16UartProfile* profile, uint8_t percent);
 bool evil_bw16_uart_wait_for_response(EvilBw16UartWorker* worker, const char* expected_prefix, char* response_buffer, size_t buffer_size, uint32_t timeout_ms);
+void evil_bw16_uart_renegotiate(EvilBw16UartWorker* worker);
+bool evil_bw16_uart_is_negotiating(EvilBw16UartWorker* worker);
+uint32_t evil_bw16_uart_get_baud_rate(EvilBw16UartWorker* worker);
+bool evil_bw16_uart_negotiate_protocol(EvilBw16UartWorker* worker, bool binary);
+bool evil_bw16_uart_is_binary(EvilBw16UartWorker* worker);
+#ifdef EVIL_BW16_DEVTOOLS
+// Hooks for the replay benchmark and the simulator
+size_t evil_bw16_uart_inject_rx(EvilBw16UartWorker* worker, const uint8_t* data, size_t len, bool drop_when_full);
+void evil_bw16_uart_pause_rx(EvilBw16UartWorker* worker, bool paused);
+void evil_bw16_uart_force_protocol(EvilBw16UartWorker* worker, bool binary);
+void evil_bw16_uart_set_tx_tap(EvilBw16UartWorker* worker, EvilBw16TxTap tap, void* context);
+bool evil_bw16_uart_capture_start(EvilBw16UartWorker* worker, const char* path);
+void evil_bw16_uart_capture_stop(EvilBw16UartWorker* worker);
+bool evil_bw16_uart_capture_is_active(EvilBw16UartWorker* worker);
+uint32_t evil_bw16_uart_capture_get_bytes(EvilBw16UartWorker* worker);
+#endif
 
 // Command Functions
 void evil_bw16_send_command(EvilBw16App* app, const char* command);
@@ -287,16 +531,178 @@ void evil_bw16_send_info_command(EvilBw16App* app);
 void evil_bw16_send_config_to_device(EvilBw16App* app);
 
 // Response Parsing
-EvilBw16ResponseType evil_bw16_parse_response_type(const char* response);
-bool evil_bw16_parse_scan_result(const char* response, EvilBw16Network* network);
+EvilBw16ResponseType evil_bw16_classify_line(EvilBw16LineView line);
+bool evil_bw16_parse_scan_result(EvilBw16LineView line, EvilBw16Network* network, EvilBw16LineView* ssid);
+
+// Line view helpers
+const char* evil_bw16_line_find(EvilBw16LineView line, const char* needle, size_t needle_len);
+bool evil_bw16_line_next_field(EvilBw16LineView* rest, char separator, EvilBw16LineView* field);
+bool evil_bw16_line_parse_int(EvilBw16LineView field, int* value);
+
+static inline EvilBw16LineView evil_bw16_line_view(const char* data, size_t len) {
+    EvilBw16LineView line = {.data = data, .len = len};
+    return line;
+}
+
+static inline EvilBw16LineView evil_bw16_line_skip(EvilBw16LineView line, size_t count) {
+    if(count > line.len) count = line.len;
+    return evil_bw16_line_view(line.data + count, line.len - count);
+}
+
+// Inlined so strlen() of a literal prefix folds to a constant
+static inline bool evil_bw16_line_starts_with(EvilBw16LineView line, const char* prefix) {
+    const size_t prefix_len = strlen(prefix);
+    return line.len >= prefix_len && memcmp(line.data, prefix, prefix_len) == 0;
+}
+
+static inline bool evil_bw16_line_contains(EvilBw16LineView line, const char* needle) {
+    return evil_bw16_line_find(line, needle, strlen(needle)) != NULL;
+}
+
+// Line filter
+EvilBw16LineFilter* evil_bw16_filter_alloc(const EvilBw16FilterRule* rules, size_t rule_count);
+void evil_bw16_filter_free(EvilBw16LineFilter* filter);
+int evil_bw16_filter_match(EvilBw16LineFilter* filter, EvilBw16LineView line);
+size_t evil_bw16_filter_get_rule_count(EvilBw16LineFilter* filter);
+const char* evil_bw16_filter_get_rule_pattern(EvilBw16LineFilter* filter, size_t rule);
+void evil_bw16_filter_get_stats(EvilBw16LineFilter* filter, size_t rule, uint32_t* lines, uint32_t* bytes);
+void evil_bw16_filter_reset_stats(EvilBw16LineFilter* filter);
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Replay benchmark
+EvilBw16Replay* evil_bw16_replay_alloc(EvilBw16App* app);
+void evil_bw16_replay_free(EvilBw16Replay* replay);
+bool evil_bw16_replay_start(EvilBw16Replay* replay, uint32_t baud_rate);
+bool evil_bw16_replay_start_capture(EvilBw16Replay* replay, bool original_timing);
+bool evil_bw16_replay_start_proto_bench(EvilBw16Replay* replay);
+bool evil_bw16_replay_start_sim_bench(EvilBw16Replay* replay, bool sniff);
+bool evil_bw16_replay_start_parser_bench(EvilBw16Replay* replay);
+void evil_bw16_replay_stop(EvilBw16Replay* replay);
+void evil_bw16_replay_format_report(EvilBw16Replay* replay, FuriString* out);
+
+// Simulated BW16
+EvilBw16Sim* evil_bw16_sim_alloc(EvilBw16App* app);
+void evil_bw16_sim_free(EvilBw16Sim* sim);
+void evil_bw16_sim_configure(EvilBw16Sim* sim, uint8_t network_count, uint32_t frame_rate, uint32_t scan_ms);
+bool evil_bw16_sim_start(EvilBw16Sim* sim);
+void evil_bw16_sim_stop(EvilBw16Sim* sim);
+bool evil_bw16_sim_is_running(EvilBw16Sim* sim);
+uint8_t evil_bw16_sim_get_network_count(EvilBw16Sim* sim);
+uint32_t evil_bw16_sim_get_frame_rate(EvilBw16Sim* sim);
+uint32_t evil_bw16_sim_get_scan_ms(EvilBw16Sim* sim);
+void evil_bw16_sim_get_stats(EvilBw16Sim* sim, EvilBw16SimStats* stats);
+
+// RX capture files
+EvilBw16CaptureWriter* evil_bw16_capture_writer_open(const char* path);
+void evil_bw16_capture_writer_append(EvilBw16CaptureWriter* writer, uint32_t tick, const uint8_t* data, size_t len);
+uint32_t evil_bw16_capture_writer_get_bytes(EvilBw16CaptureWriter* writer);
+void evil_bw16_capture_writer_close(EvilBw16CaptureWriter* writer);
+EvilBw16CaptureReader* evil_bw16_capture_reader_open(const char* path);
+bool evil_bw16_capture_reader_next(EvilBw16CaptureReader* reader, uint32_t* tick_delta, const uint8_t** data, size_t* len);
+void evil_bw16_capture_reader_close(EvilBw16CaptureReader* reader);
+#endif
+
+// Sniffer statistics
+void evil_bw16_sniffer_stats_reset(EvilBw16SnifferCounters* counters);
+void evil_bw16_sniffer_stats_record(EvilBw16SnifferCounters* counters, EvilBw16LineView line, bool data_frame);
+void evil_bw16_sniffer_stats_record_frame(EvilBw16SnifferCounters* counters, const EvilBw16ProtoFrameInfo* info);
+const char* evil_bw16_sniffer_subtype_name(EvilBw16FrameSubtype subtype);
+uint8_t evil_bw16_sniffer_slot_channel(size_t slot);
+EvilBw16SnifferView* evil_bw16_sniffer_view_alloc(void);
+void evil_bw16_sniffer_view_free(EvilBw16SnifferView* sniffer_view);
+View* evil_bw16_sniffer_view_get_view(EvilBw16SnifferView* sniffer_view);
+void evil_bw16_sniffer_view_reset(EvilBw16SnifferView* sniffer_view, const EvilBw16SnifferCounters* counters);
+void evil_bw16_sniffer_view_update(EvilBw16SnifferView* sniffer_view, const EvilBw16SnifferCounters* counters, bool sample);
+
+// Scan list
+EvilBw16NetworkTable* evil_bw16_network_table_alloc(size_t budget);
+void evil_bw16_network_table_free(EvilBw16NetworkTable* table);
+void evil_bw16_network_table_set_budget(EvilBw16NetworkTable* table, size_t budget);
+void evil_bw16_network_table_clear(EvilBw16NetworkTable* table);
+void evil_bw16_network_table_lock(EvilBw16NetworkTable* table);
+void evil_bw16_network_table_unlock(EvilBw16NetworkTable* table);
+void evil_bw16_network_table_begin_scan(EvilBw16NetworkTable* table);
+size_t evil_bw16_network_table_age(EvilBw16NetworkTable* table, uint32_t max_age);
+EvilBw16NetworkHandle evil_bw16_network_table_upsert(EvilBw16NetworkTable* table, const EvilBw16Network* network, EvilBw16LineView ssid, bool* created);
+void evil_bw16_network_table_remove(EvilBw16NetworkTable* table, EvilBw16NetworkHandle handle);
+EvilBw16NetworkHandle evil_bw16_network_table_find(EvilBw16NetworkTable* table, const uint8_t* bssid);
+uint32_t evil_bw16_network_table_get_generation(EvilBw16NetworkTable* table);
+size_t evil_bw16_network_table_count(EvilBw16NetworkTable* table);
+EvilBw16NetworkHandle evil_bw16_network_table_at(EvilBw16NetworkTable* table, size_t position);
+EvilBw16NetworkHandle evil_bw16_network_table_sorted_at(EvilBw16NetworkTable* table, EvilBw16NetworkSort sort, size_t position);
+size_t evil_bw16_network_table_heard_count(EvilBw16NetworkTable* table);
+EvilBw16NetworkHandle evil_bw16_network_table_heard_at(EvilBw16NetworkTable* table, size_t position);
+bool evil_bw16_network_table_in_scan(EvilBw16NetworkTable* table, const EvilBw16Network* network);
+EvilBw16Network* evil_bw16_network_table_get(EvilBw16NetworkTable* table, EvilBw16NetworkHandle handle);
+const char* evil_bw16_network_table_get_ssid(EvilBw16NetworkTable* table, const EvilBw16Network* network);
+void evil_bw16_network_table_get_stats(EvilBw16NetworkTable* table, EvilBw16NetworkTableStats* stats);
+void evil_bw16_format_bssid(const uint8_t* bssid, char* out);
+
+// Smoothed RSSI in dBm, rounded
+static inline int8_t evil_bw16_network_rssi_avg(const EvilBw16Network* network) {
+    const int16_t avg = network->rssi_avg;
+    return (int8_t)((avg < 0 ? avg - 8 : avg + 8) / 16);
+}
+
+static inline bool evil_bw16_network_filter_match(const EvilBw16NetworkFilter* filter, const EvilBw16Network* network) {
+    return (filter->band == EvilBw16BandUnknown || network->band == filter->band) &&
+           evil_bw16_network_rssi_avg(network) >= filter->min_rssi;
+}
+
+// Live scan view
+EvilBw16ScannerView* evil_bw16_scanner_view_alloc(void);
+void evil_bw16_scanner_view_free(EvilBw16ScannerView* scanner);
+View* evil_bw16_scanner_view_get_view(EvilBw16ScannerView* scanner);
+void evil_bw16_scanner_view_set_ok_callback(EvilBw16ScannerView* scanner, EvilBw16ScannerViewCallback callback, void* context);
+void evil_bw16_scanner_view_reset(EvilBw16ScannerView* scanner);
+bool evil_bw16_scanner_view_sync(EvilBw16ScannerView* scanner, EvilBw16NetworkTable* networks);
+void evil_bw16_scanner_view_update(EvilBw16ScannerView* scanner);
+
+// Notifier
+EvilBw16Notifier* evil_bw16_notifier_alloc(ViewDispatcher* view_dispatcher);
+void evil_bw16_notifier_free(EvilBw16Notifier* notifier);
+void evil_bw16_notify(EvilBw16Notifier* notifier, uint32_t flags);
+uint32_t evil_bw16_notifier_take(EvilBw16Notifier* notifier);
+uint32_t evil_bw16_notifier_get_suppressed(EvilBw16Notifier* notifier);
+uint32_t evil_bw16_notifier_get_wakeups(EvilBw16Notifier* notifier);
+
+// Storage writer
+EvilBw16StorageWriter* evil_bw16_storage_writer_alloc(const char* path, bool append);
+void evil_bw16_storage_writer_free(EvilBw16StorageWriter* writer);
+bool evil_bw16_storage_writer_write(EvilBw16StorageWriter* writer, const void* data, size_t len);
+bool evil_bw16_storage_writer_write_line(EvilBw16StorageWriter* writer, const char* prefix, EvilBw16LineView line);
+void evil_bw16_storage_writer_truncate(EvilBw16StorageWriter* writer);
+uint32_t evil_bw16_storage_writer_get_dropped(EvilBw16StorageWriter* writer);
+
+// Log store
+EvilBw16LogStore* evil_bw16_log_store_alloc(size_t arena_size, size_t line_capacity);
+void evil_bw16_log_store_free(EvilBw16LogStore* store);
+void evil_bw16_log_store_append(EvilBw16LogStore* store, const char* prefix, EvilBw16LineView line);
+void evil_bw16_log_store_clear(EvilBw16LogStore* store);
+void evil_bw16_log_store_lock(EvilBw16LogStore* store);
+void evil_bw16_log_store_unlock(EvilBw16LogStore* store);
+size_t evil_bw16_log_store_count(EvilBw16LogStore* store);
+EvilBw16LineView evil_bw16_log_store_get(EvilBw16LogStore* store, size_t index);
+uint32_t evil_bw16_log_store_get_first_id(EvilBw16LogStore* store);
+uint32_t evil_bw16_log_store_get_seq(EvilBw16LogStore* store);
+
+// Terminal view
+EvilBw16TerminalView* evil_bw16_terminal_view_alloc(EvilBw16LogStore* store);
+void evil_bw16_terminal_view_free(EvilBw16TerminalView* terminal);
+View* evil_bw16_terminal_view_get_view(EvilBw16TerminalView* terminal);
+void evil_bw16_terminal_view_reset(EvilBw16TerminalView* terminal, const char* header);
+void evil_bw16_terminal_view_update(EvilBw16TerminalView* terminal);
 
 // Utility functions
 void evil_bw16_show_loading(EvilBw16App* app, const char* text);
 void evil_bw16_hide_loading(EvilBw16App* app);
 void evil_bw16_show_popup(EvilBw16App* app, const char* header, const char* text);
 void evil_bw16_append_log(EvilBw16App* app, const char* text);
+void evil_bw16_append_log_line(EvilBw16App* app, EvilBw16LineView line);
 void evil_bw16_clear_log(EvilBw16App* app);
+void evil_bw16_set_log_level(EvilBw16App* app, uint8_t level);
 void evil_bw16_notification_message(EvilBw16App* app, const NotificationSequence* sequence);
 
 // Debug functions
-void debug_write_to_sd(const char* data); 
\ No newline at end of file
+void debug_write_to_sd(EvilBw16App* app, const char* data);
+void debug_write_line_to_sd(EvilBw16App* app, EvilBw16LineView line);
\ No newline at end of file
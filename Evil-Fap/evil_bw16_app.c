@@ -1,7 +1,10 @@
 #include "evil_bw16.h"
+#include <storage/storage.h>
 #include <string.h>
 #include <stdlib.h>
 
+uint8_t evil_bw16_log_level = EVIL_BW16_LOG_LEVEL_INFO;
+
 // Scene handlers table
 void (*const evil_bw16_scene_on_enter_handlers[])(void*) = {
     evil_bw16_scene_on_enter_start,
@@ -15,6 +18,9 @@ void (*const evil_bw16_scene_on_enter_handlers[])(void*) = {
     evil_bw16_scene_on_enter_config,
     evil_bw16_scene_on_enter_device_info,
     evil_bw16_scene_on_enter_uart_terminal,
+#ifdef EVIL_BW16_DEVTOOLS
+    evil_bw16_scene_on_enter_replay,
+#endif
 };
 
 bool (*const evil_bw16_scene_on_event_handlers[])(void*, SceneManagerEvent) = {
@@ -29,6 +35,9 @@ bool (*const evil_bw16_scene_on_event_handlers[])(void*, SceneManagerEvent) = {
     evil_bw16_scene_on_event_config,
     evil_bw16_scene_on_event_device_info,
     evil_bw16_scene_on_event_uart_terminal,
+#ifdef EVIL_BW16_DEVTOOLS
+    evil_bw16_scene_on_event_replay,
+#endif
 };
 
 void (*const evil_bw16_scene_on_exit_handlers[])(void*) = {
@@ -43,6 +52,9 @@ void (*const evil_bw16_scene_on_exit_handlers[])(void*) = {
     evil_bw16_scene_on_exit_config,
     evil_bw16_scene_on_exit_device_info,
     evil_bw16_scene_on_exit_uart_terminal,
+#ifdef EVIL_BW16_DEVTOOLS
+    evil_bw16_scene_on_exit_replay,
+#endif
 };
 
 // Scene manager configuration
@@ -56,9 +68,35 @@ const SceneManagerHandlers evil_bw16_scene_handlers = {
 static bool evil_bw16_custom_callback(void* context, uint32_t custom_event) {
     furi_assert(context);
     EvilBw16App* app = context;
+    
+    if(custom_event == EvilBw16EventNotify) {
+        // Fan the coalesced worker notification out as the per-class events scenes expect
+        uint32_t flags = evil_bw16_notifier_take(app->notifier);
+        bool consumed = false;
+        if(flags & EvilBw16NotifyTerminal) {
+            consumed |= scene_manager_handle_custom_event(app->scene_manager, EvilBw16EventUartTerminalRefresh);
+        }
+        if(flags & EvilBw16NotifyPacket) {
+            consumed |= scene_manager_handle_custom_event(app->scene_manager, EvilBw16EventPacketReceived);
+        }
+        if(flags & EvilBw16NotifyScan) {
+            consumed |= scene_manager_handle_custom_event(app->scene_manager, EvilBw16EventScanResult);
+        }
+        if(flags & EvilBw16NotifyLink) {
+            consumed |= scene_manager_handle_custom_event(app->scene_manager, EvilBw16EventLinkReady);
+        }
+        return consumed;
+    }
+    
     return scene_manager_handle_custom_event(app->scene_manager, custom_event);
 }
 
+static void evil_bw16_tick_event_callback(void* context) {
+    furi_assert(context);
+    EvilBw16App* app = context;
+    scene_manager_handle_tick_event(app->scene_manager);
+}
+
 static bool evil_bw16_back_event_callback(void* context) {
     furi_assert(context);
     EvilBw16App* app = context;
@@ -82,6 +120,14 @@ EvilBw16App* evil_bw16_app_alloc(void) {
     app->config.led_enabled = true;
     app->config.debug_mode = false;
     app->config.gpio_pins = EvilBw16GpioPins13_14;  // Default to pins 13/14
+    app->config.baud_rate = EVIL_BW16_UART_BAUD_RATE;
+    app->config.adaptive_rx_buffer = false;
+    evil_bw16_set_log_level(app, EVIL_BW16_LOG_LEVEL_INFO);
+    app->config.network_ram_kb = EVIL_BW16_NETWORK_RAM_DEFAULT;
+    app->results_sort = EvilBw16NetworkSortRssi;
+    app->results_filter.band = EvilBw16BandUnknown;
+    app->results_filter.min_rssi = INT8_MIN;
+    app->networks = evil_bw16_network_table_alloc(app->config.network_ram_kb * 1024);
     
     // Initialize GUI
     app->gui = furi_record_open(RECORD_GUI);
@@ -93,6 +139,7 @@ EvilBw16App* evil_bw16_app_alloc(void) {
     view_dispatcher_set_event_callback_context(app->view_dispatcher, app);
     view_dispatcher_set_custom_event_callback(app->view_dispatcher, evil_bw16_custom_callback);
     view_dispatcher_set_navigation_event_callback(app->view_dispatcher, evil_bw16_back_event_callback);
+    view_dispatcher_set_tick_event_callback(app->view_dispatcher, evil_bw16_tick_event_callback, 1000);
     view_dispatcher_attach_to_gui(app->view_dispatcher, app->gui, ViewDispatcherTypeFullscreen);
     
     // Initialize scene manager
@@ -118,8 +165,19 @@ EvilBw16App* evil_bw16_app_alloc(void) {
     app->text_box_store = malloc(EVIL_BW16_TEXT_BOX_STORE_SIZE);
     app->text_input_store = malloc(EVIL_BW16_TEXT_INPUT_STORE_SIZE);
     app->text_box_string = furi_string_alloc();
-    app->log_string = furi_string_alloc();
-    app->uart_log_string = furi_string_alloc();
+    app->log_store = evil_bw16_log_store_alloc(EVIL_BW16_LOG_STORE_SIZE, EVIL_BW16_LOG_STORE_LINES);
+    
+    app->terminal_view = evil_bw16_terminal_view_alloc(app->log_store);
+    view_dispatcher_add_view(app->view_dispatcher, EvilBw16ViewTerminal, evil_bw16_terminal_view_get_view(app->terminal_view));
+    
+    app->sniffer_view = evil_bw16_sniffer_view_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, EvilBw16ViewSnifferStats, evil_bw16_sniffer_view_get_view(app->sniffer_view));
+    
+    app->scanner_view = evil_bw16_scanner_view_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, EvilBw16ViewScannerLive, evil_bw16_scanner_view_get_view(app->scanner_view));
+    
+    app->debug_log = evil_bw16_storage_writer_alloc(EVIL_BW16_DEBUG_LOG_PATH, true);
+    app->notifier = evil_bw16_notifier_alloc(app->view_dispatcher);
     
     // Initialize UART worker
     app->uart_worker = evil_bw16_uart_init(app);
@@ -131,6 +189,14 @@ EvilBw16App* evil_bw16_app_alloc(void) {
 void evil_bw16_app_free(EvilBw16App* app) {
     furi_assert(app);
     
+#ifdef EVIL_BW16_DEVTOOLS
+    // Stop a benchmark still feeding the worker
+    if(app->replay) {
+        evil_bw16_replay_free(app->replay);
+    }
+    evil_bw16_sim_free(app->simulator);
+#endif
+    
     // Stop UART worker
     if(app->uart_worker) {
         evil_bw16_uart_free(app->uart_worker);
@@ -140,25 +206,34 @@ void evil_bw16_app_free(EvilBw16App* app) {
         furi_stream_buffer_free(app->uart_rx_stream);
     }
     
+    // Commits the debug lines still queued
+    evil_bw16_storage_writer_free(app->debug_log);
+    evil_bw16_notifier_free(app->notifier);
+    
     // Free text storage
     free(app->text_box_store);
     free(app->text_input_store);
     furi_string_free(app->text_box_string);
-    furi_string_free(app->log_string);
-    furi_string_free(app->uart_log_string);
-    
     // Free views
     view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewMainMenu);
     view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewTextBox);
     view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewTextInput);
     view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewPopup);
     view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewWidget);
+    view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewTerminal);
+    view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewSnifferStats);
+    view_dispatcher_remove_view(app->view_dispatcher, EvilBw16ViewScannerLive);
     
     submenu_free(app->submenu);
     text_box_free(app->text_box);
     text_input_free(app->text_input);
     popup_free(app->popup);
     widget_free(app->widget);
+    evil_bw16_terminal_view_free(app->terminal_view);
+    evil_bw16_sniffer_view_free(app->sniffer_view);
+    evil_bw16_scanner_view_free(app->scanner_view);
+    evil_bw16_log_store_free(app->log_store);
+    evil_bw16_network_table_free(app->networks);
     
     // Free scene manager and view dispatcher
     scene_manager_free(app->scene_manager);
@@ -196,23 +271,25 @@ void evil_bw16_show_popup(EvilBw16App* app, const char* header, const char* text
 }
 
 void evil_bw16_append_log(EvilBw16App* app, const char* text) {
+    if(!text) return;
+    evil_bw16_append_log_line(app, evil_bw16_line_view(text, strlen(text)));
+}
+
+void evil_bw16_append_log_line(EvilBw16App* app, EvilBw16LineView line) {
     // Skip empty or very short lines to reduce spam from WebUI
-    if(!text || strlen(text) < 3) return;
-    
-    furi_string_cat_printf(app->log_string, "%s\n", text);
+    if(line.len < 3) return;
     
-    // More aggressive log size management for high-volume WebUI data
-    size_t current_size = furi_string_size(app->log_string);
-    if(current_size > EVIL_BW16_TEXT_BOX_STORE_SIZE - 512) {
-        // Remove first half of the log to prevent memory issues
-        size_t remove_size = current_size / 2;
-        furi_string_right(app->log_string, current_size - remove_size);
-        FURI_LOG_D("EvilBw16", "Log trimmed due to size, removed %zu bytes", remove_size);
-    }
+    // Oldest lines are evicted as needed, nothing is moved
+    evil_bw16_log_store_append(app->log_store, NULL, line);
 }
 
 void evil_bw16_clear_log(EvilBw16App* app) {
-    furi_string_reset(app->log_string);
+    evil_bw16_log_store_clear(app->log_store);
+}
+
+void evil_bw16_set_log_level(EvilBw16App* app, uint8_t level) {
+    app->config.log_level = MIN(level, (uint8_t)EVIL_BW16_LOG_LEVEL_DEBUG);
+    evil_bw16_log_level = app->config.log_level;
 }
 
 void evil_bw16_notification_message(EvilBw16App* app, const NotificationSequence* sequence) {
@@ -244,17 +321,10 @@ void evil_bw16_send_command(EvilBw16App* app, const char* command) {
     if(!app || !app->uart_worker || !command) return;
     
     // Log the command being sent
-    FURI_LOG_I("EvilBw16", "Sending command: %s", command);
+    EVIL_BW16_LOG_I("Sending command: %s", command);
     
     // Add to UART log
-    furi_string_cat_printf(app->uart_log_string, "TX: %s\n", command);
-    
-    // Limit UART log size
-    if(furi_string_size(app->uart_log_string) > EVIL_BW16_TEXT_BOX_STORE_SIZE - 256) {
-        // Remove first 1/4 of the log
-        size_t remove_size = furi_string_size(app->uart_log_string) / 4;
-        furi_string_right(app->uart_log_string, furi_string_size(app->uart_log_string) - remove_size);
-    }
+    evil_bw16_log_store_append(app->log_store, "TX: ", evil_bw16_line_view(command, strlen(command)));
     
     // Use the new UART send command function
     evil_bw16_uart_send_command(app->uart_worker, command);
@@ -331,96 +401,5 @@ void evil_bw16_send_config_to_device(EvilBw16App* app) {
     snprintf(cmd, sizeof(cmd), "set debug %s", app->config.debug_mode ? "on" : "off");
     evil_bw16_send_command(app, cmd);
     
-    FURI_LOG_I("EvilBw16", "Configuration sent to BW16 device");
+    EVIL_BW16_LOG_I("Configuration sent to BW16 device");
 }
-
-// Response parsing functions
-EvilBw16ResponseType evil_bw16_parse_response_type(const char* response) {
-    if(!response) return EvilBw16ResponseUnknown;
-    
-    if(strncmp(response, "[INFO]", 6) == 0) return EvilBw16ResponseInfo;
-    if(strncmp(response, "[ERROR]", 7) == 0) return EvilBw16ResponseError;
-    if(strncmp(response, "[DEBUG]", 7) == 0) return EvilBw16ResponseDebug;
-    if(strncmp(response, "[CMD]", 5) == 0) return EvilBw16ResponseCommand;
-    if(strncmp(response, "[HOP]", 5) == 0) return EvilBw16ResponseChannelHop;
-    if(strstr(response, "deauth") || strstr(response, "attack")) return EvilBw16ResponseAttackStatus;
-    
-    return EvilBw16ResponseUnknown;
-}
-
-bool evil_bw16_parse_scan_result(const char* response, EvilBw16Network* network) {
-    if(!response || !network) return false;
-    
-    // Parse the format: [INFO] Index\tSSID\t\tBSSID\t\tChannel\tRSSI (dBm)\tFrequency
-    // Example: [INFO] 0\ttest_network\t\t11:22:33:44:55:66\t\t6\t-45\t2.4GHz
-    
-    // Skip "[INFO] " prefix
-    const char* data = response;
-    if(strncmp(data, "[INFO] ", 7) == 0) {
-        data += 7;
-    }
-    
-    memset(network, 0, sizeof(EvilBw16Network));
-    
-    // Manual tab-separated parsing
-    const char* start = data;
-    const char* end;
-    int field = 0;
-    
-    while(*start && field < 6) {
-        // Find next tab or end of string
-        end = strchr(start, '\t');
-        if(!end) end = start + strlen(start);
-        
-        // Skip empty fields (double tabs)
-        if(end == start) {
-            start++;
-            continue;
-        }
-        
-        // Extract field value
-        size_t len = end - start;
-        char field_value[128];
-        if(len >= sizeof(field_value)) len = sizeof(field_value) - 1;
-        strncpy(field_value, start, len);
-        field_value[len] = '\0';
-        
-        // Process field based on index
-        switch(field) {
-            case 0: // Index
-                network->index = atoi(field_value);
-                break;
-            case 1: // SSID
-                strncpy(network->ssid, field_value, sizeof(network->ssid) - 1);
-                network->ssid[sizeof(network->ssid) - 1] = '\0';
-                break;
-            case 2: // BSSID
-                strncpy(network->bssid, field_value, sizeof(network->bssid) - 1);
-                network->bssid[sizeof(network->bssid) - 1] = '\0';
-                break;
-            case 3: // Channel
-                network->channel = atoi(field_value);
-                break;
-            case 4: // RSSI
-                network->rssi = atoi(field_value);
-                break;
-            case 5: // Frequency
-                if(strstr(field_value, "5GHz")) {
-                    network->band = EvilBw16Band5GHz;
-                } else {
-                    network->band = EvilBw16Band24GHz;
-                }
-                break;
-        }
-        
-        field++;
-        start = (*end == '\0') ? end : end + 1;
-    }
-    
-    // Validation - need at least SSID and BSSID
-    if(strlen(network->ssid) > 0 && strlen(network->bssid) > 0) {
-        return true;
-    }
-    
-    return false;
-} 
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "evil_bw16.h"
+#include <storage/storage.h>
+
+#ifdef EVIL_BW16_DEVTOOLS
+
+// Raw RX capture files.
+//
+// Layout: an 8 byte magic, a version byte and the recording tick frequency (u32 LE),
+// followed by one record per received chunk:
+//
+//   varint tick delta since the previous chunk | varint length | length bytes
+//
+// Varints are LEB128, so a typical chunk costs two or three bytes of framing.
+
+#define CAPTURE_MAGIC "EBW16CAP"
+#define CAPTURE_MAGIC_LEN (8)
+#define CAPTURE_VERSION (1)
+#define CAPTURE_HEADER_LEN (CAPTURE_MAGIC_LEN + 1 + 4)
+#define CAPTURE_WRITE_BUFFER_SIZE (1024)
+#define CAPTURE_READ_BUFFER_SIZE (512)
+#define CAPTURE_VARINT_MAX (5)
+
+struct EvilBw16CaptureWriter {
+    EvilBw16StorageWriter* out;
+    uint8_t* buffer;
+    size_t buffer_len;
+    uint32_t last_tick;
+    uint32_t bytes;  // Payload bytes recorded
+};
+
+struct EvilBw16CaptureReader {
+    Storage* storage;
+    File* file;
+    uint8_t* buffer;
+    size_t buffer_pos;
+    size_t buffer_len;
+    uint8_t* chunk;
+    uint32_t tick_frequency;
+};
+
+static size_t capture_put_varint(uint8_t* out, uint32_t value) {
+    size_t len = 0;
+    while(value >= 0x80) {
+        out[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+// Hand the buffered records to the storage writer. The buffer only ever holds whole
+// records, so if the queue is full the file loses those chunks but stays readable.
+static void capture_writer_flush(EvilBw16CaptureWriter* writer) {
+    if(writer->buffer_len == 0) return;
+    evil_bw16_storage_writer_write(writer->out, writer->buffer, writer->buffer_len);
+    writer->buffer_len = 0;
+}
+
+EvilBw16CaptureWriter* evil_bw16_capture_writer_open(const char* path) {
+    EvilBw16StorageWriter* out = evil_bw16_storage_writer_alloc(path, false);
+    if(!out) return NULL;
+
+    EvilBw16CaptureWriter* writer = malloc(sizeof(EvilBw16CaptureWriter));
+    memset(writer, 0, sizeof(EvilBw16CaptureWriter));
+    writer->out = out;
+    writer->buffer = malloc(CAPTURE_WRITE_BUFFER_SIZE);
+    writer->last_tick = furi_get_tick();
+
+    uint8_t* header = writer->buffer;
+    const uint32_t frequency = furi_kernel_get_tick_frequency();
+    memcpy(header, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN);
+    header[CAPTURE_MAGIC_LEN] = CAPTURE_VERSION;
+    for(size_t i = 0; i < 4; i++) {
+        header[CAPTURE_MAGIC_LEN + 1 + i] = (uint8_t)(frequency >> (8 * i));
+    }
+    writer->buffer_len = CAPTURE_HEADER_LEN;
+
+    return writer;
+}
+
+// Record one received chunk. Runs on the UART worker and never touches the SD card
+// itself; full buffers are queued to the storage writer thread.
+void evil_bw16_capture_writer_append(EvilBw16CaptureWriter* writer, uint32_t tick, const uint8_t* data, size_t len) {
+    if(!writer) return;
+
+    while(len > 0) {
+        const size_t count = MIN(len, (size_t)EVIL_BW16_CAPTURE_MAX_CHUNK);
+
+        // A record is at most 2 varints + EVIL_BW16_CAPTURE_MAX_CHUNK, so it always fits after a flush
+        if(writer->buffer_len + 2 * CAPTURE_VARINT_MAX + count > CAPTURE_WRITE_BUFFER_SIZE) {
+            capture_writer_flush(writer);
+        }
+        writer->buffer_len += capture_put_varint(writer->buffer + writer->buffer_len, tick - writer->last_tick);
+        writer->buffer_len += capture_put_varint(writer->buffer + writer->buffer_len, count);
+        writer->last_tick = tick;
+        memcpy(writer->buffer + writer->buffer_len, data, count);
+        writer->buffer_len += count;
+
+        writer->bytes += count;
+        data += count;
+        len -= count;
+    }
+}
+
+uint32_t evil_bw16_capture_writer_get_bytes(EvilBw16CaptureWriter* writer) {
+    return writer ? writer->bytes : 0;
+}
+
+void evil_bw16_capture_writer_close(EvilBw16CaptureWriter* writer) {
+    if(!writer) return;
+    capture_writer_flush(writer);
+    evil_bw16_storage_writer_free(writer->out);
+    free(writer->buffer);
+    free(writer);
+}
+
+static bool capture_reader_get_byte(EvilBw16CaptureReader* reader, uint8_t* byte) {
+    if(reader->buffer_pos == reader->buffer_len) {
+        reader->buffer_len = storage_file_read(reader->file, reader->buffer, CAPTURE_READ_BUFFER_SIZE);
+        reader->buffer_pos = 0;
+        if(reader->buffer_len == 0) return false;
+    }
+    *byte = reader->buffer[reader->buffer_pos++];
+    return true;
+}
+
+static bool capture_reader_get_varint(EvilBw16CaptureReader* reader, uint32_t* value) {
+    *value = 0;
+    for(size_t i = 0; i < CAPTURE_VARINT_MAX; i++) {
+        uint8_t byte;
+        if(!capture_reader_get_byte(reader, &byte)) return false;
+        *value |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if(!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+EvilBw16CaptureReader* evil_bw16_capture_reader_open(const char* path) {
+    EvilBw16CaptureReader* reader = malloc(sizeof(EvilBw16CaptureReader));
+    memset(reader, 0, sizeof(EvilBw16CaptureReader));
+    reader->storage = furi_record_open(RECORD_STORAGE);
+    reader->file = storage_file_alloc(reader->storage);
+    reader->buffer = malloc(CAPTURE_READ_BUFFER_SIZE);
+    reader->chunk = malloc(EVIL_BW16_CAPTURE_MAX_CHUNK);
+
+    uint8_t header[CAPTURE_HEADER_LEN];
+    bool ok = storage_file_open(reader->file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+              storage_file_read(reader->file, header, sizeof(header)) == sizeof(header) &&
+              memcmp(header, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) == 0 &&
+              header[CAPTURE_MAGIC_LEN] == CAPTURE_VERSION;
+
+    if(!ok) {
+        EVIL_BW16_LOG_W("Not a usable capture file: %s", path);
+        evil_bw16_capture_reader_close(reader);
+        return NULL;
+    }
+
+    for(size_t i = 0; i < 4; i++) {
+        reader->tick_frequency |= (uint32_t)header[CAPTURE_MAGIC_LEN + 1 + i] << (8 * i);
+    }
+    if(reader->tick_frequency == 0) reader->tick_frequency = furi_kernel_get_tick_frequency();
+
+    return reader;
+}
+
+// Fetch the next recorded chunk. The tick delta is converted to local kernel ticks and
+// the data stays valid until the next call. Returns false at the end of the file.
+bool evil_bw16_capture_reader_next(EvilBw16CaptureReader* reader, uint32_t* tick_delta, const uint8_t** data, size_t* len) {
+    if(!reader) return false;
+
+    uint32_t delta;
+    uint32_t count;
+    if(!capture_reader_get_varint(reader, &delta) || !capture_reader_get_varint(reader, &count)) return false;
+    if(count > EVIL_BW16_CAPTURE_MAX_CHUNK) {
+        EVIL_BW16_LOG_W("Corrupt capture chunk (%lu bytes)", count);
+        return false;
+    }
+
+    size_t copied = 0;
+    while(copied < count) {
+        if(reader->buffer_pos == reader->buffer_len) {
+            uint8_t byte;
+            if(!capture_reader_get_byte(reader, &byte)) return false;
+            reader->chunk[copied++] = byte;
+            continue;
+        }
+        const size_t n = MIN(count - copied, reader->buffer_len - reader->buffer_pos);
+        memcpy(reader->chunk + copied, reader->buffer + reader->buffer_pos, n);
+        reader->buffer_pos += n;
+        copied += n;
+    }
+
+    const uint32_t local_frequency = furi_kernel_get_tick_frequency();
+    *tick_delta = (reader->tick_frequency == local_frequency) ?
+                      delta :
+                      (uint32_t)((uint64_t)delta * local_frequency / reader->tick_frequency);
+    *data = reader->chunk;
+    *len = count;
+    return true;
+}
+
+void evil_bw16_capture_reader_close(EvilBw16CaptureReader* reader) {
+    if(!reader) return;
+    storage_file_close(reader->file);
+    storage_file_free(reader->file);
+    furi_record_close(RECORD_STORAGE);
+    free(reader->buffer);
+    free(reader->chunk);
+    free(reader);
+}
+
+#endif // EVIL_BW16_DEVTOOLS
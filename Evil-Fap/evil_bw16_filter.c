@@ -0,0 +1,177 @@
+#include "evil_bw16.h"
+
+// Multi-pattern line filter.
+//
+// The rule patterns are compiled into an Aho-Corasick automaton when the filter is
+// allocated. Bytes are first mapped to a small alphabet (one class per distinct byte
+// used by the patterns, plus class 0 for everything else) so the fully resolved
+// transition table stays at states x classes bytes. Matching is then one table
+// lookup per input byte, no matter how many rules there are.
+
+#define FILTER_NO_STATE (0xFF)
+#define FILTER_MAX_STATES (FILTER_NO_STATE)
+#define FILTER_MAX_RULES (32)
+
+struct EvilBw16LineFilter {
+    const EvilBw16FilterRule* rules;
+    size_t rule_count;
+    uint8_t class_map[256];
+    uint8_t class_count;
+    uint8_t state_count;
+    uint8_t* next;         // state_count x class_count transitions
+    uint32_t* output;      // Rule bitmask matched on entering each state
+    uint32_t anchored_mask;
+    uint32_t* drop_lines;  // Per-rule counters
+    uint32_t* drop_bytes;
+};
+
+EvilBw16LineFilter* evil_bw16_filter_alloc(const EvilBw16FilterRule* rules, size_t rule_count) {
+    if(!rules || rule_count == 0 || rule_count > FILTER_MAX_RULES) return NULL;
+
+    EvilBw16LineFilter* filter = malloc(sizeof(EvilBw16LineFilter));
+    memset(filter, 0, sizeof(EvilBw16LineFilter));
+    filter->rules = rules;
+    filter->rule_count = rule_count;
+
+    // Build the byte class map and size the trie
+    size_t max_states = 1;
+    filter->class_count = 1;
+    for(size_t r = 0; r < rule_count; r++) {
+        const char* pattern = rules[r].pattern;
+        for(size_t i = 0; pattern[i]; i++) {
+            uint8_t byte = (uint8_t)pattern[i];
+            if(filter->class_map[byte] == 0) {
+                filter->class_map[byte] = filter->class_count++;
+            }
+            max_states++;
+        }
+        if(rules[r].first_char) {
+            filter->anchored_mask |= (1UL << r);
+        }
+    }
+    furi_check(max_states <= FILTER_MAX_STATES);
+
+    const size_t classes = filter->class_count;
+    filter->next = malloc(max_states * classes);
+    filter->output = malloc(max_states * sizeof(uint32_t));
+    memset(filter->next, 0, max_states * classes);
+    memset(filter->output, 0, max_states * sizeof(uint32_t));
+
+    // Insert patterns into the trie. State 0 is the root, and since no edge ever
+    // points back at the root, 0 doubles as "no edge" while building.
+    filter->state_count = 1;
+    for(size_t r = 0; r < rule_count; r++) {
+        uint8_t state = 0;
+        for(const char* p = rules[r].pattern; *p; p++) {
+            uint8_t* edge = &filter->next[state * classes + filter->class_map[(uint8_t)*p]];
+            if(*edge == 0) {
+                *edge = filter->state_count++;
+            }
+            state = *edge;
+        }
+        filter->output[state] |= (1UL << r);
+    }
+
+    // Breadth-first pass: compute failure links and resolve every missing edge
+    // into the transition the failure link would take
+    uint8_t* fail = malloc(filter->state_count);
+    uint8_t* queue = malloc(filter->state_count);
+    size_t queue_head = 0;
+    size_t queue_tail = 0;
+    fail[0] = 0;
+    for(size_t c = 0; c < classes; c++) {
+        uint8_t child = filter->next[c];
+        if(child) {
+            fail[child] = 0;
+            queue[queue_tail++] = child;
+        }
+    }
+    while(queue_head < queue_tail) {
+        uint8_t state = queue[queue_head++];
+        filter->output[state] |= filter->output[fail[state]];
+        for(size_t c = 0; c < classes; c++) {
+            uint8_t* edge = &filter->next[state * classes + c];
+            uint8_t fallback = filter->next[fail[state] * classes + c];
+            if(*edge) {
+                fail[*edge] = fallback;
+                queue[queue_tail++] = *edge;
+            } else {
+                *edge = fallback;
+            }
+        }
+    }
+    free(queue);
+    free(fail);
+
+    filter->drop_lines = malloc(rule_count * sizeof(uint32_t));
+    filter->drop_bytes = malloc(rule_count * sizeof(uint32_t));
+    evil_bw16_filter_reset_stats(filter);
+
+    return filter;
+}
+
+void evil_bw16_filter_free(EvilBw16LineFilter* filter) {
+    if(!filter) return;
+    free(filter->next);
+    free(filter->output);
+    free(filter->drop_lines);
+    free(filter->drop_bytes);
+    free(filter);
+}
+
+// Returns the index of the first rule that matches the line, or -1.
+// Matching lines are counted against that rule.
+int evil_bw16_filter_match(EvilBw16LineFilter* filter, EvilBw16LineView line) {
+    if(!filter || line.len == 0) return -1;
+
+    // Rules anchored to a first character only count if this line starts with it
+    uint32_t allowed = ~filter->anchored_mask;
+    if(filter->anchored_mask) {
+        for(size_t r = 0; r < filter->rule_count; r++) {
+            if(filter->rules[r].first_char == line.data[0]) allowed |= (1UL << r);
+        }
+    }
+
+    const uint8_t* next = filter->next;
+    const uint8_t* class_map = filter->class_map;
+    const size_t classes = filter->class_count;
+    uint8_t state = 0;
+
+    for(size_t i = 0; i < line.len; i++) {
+        state = next[state * classes + class_map[(uint8_t)line.data[i]]];
+        uint32_t matched = filter->output[state] & allowed;
+        if(matched) {
+            int rule = __builtin_ctz(matched);
+            filter->drop_lines[rule]++;
+            filter->drop_bytes[rule] += line.len;
+            return rule;
+        }
+    }
+
+    return -1;
+}
+
+size_t evil_bw16_filter_get_rule_count(EvilBw16LineFilter* filter) {
+    return filter ? filter->rule_count : 0;
+}
+
+const char* evil_bw16_filter_get_rule_pattern(EvilBw16LineFilter* filter, size_t rule) {
+    if(!filter || rule >= filter->rule_count) return NULL;
+    return filter->rules[rule].pattern;
+}
+
+void evil_bw16_filter_get_stats(EvilBw16LineFilter* filter, size_t rule, uint32_t* lines, uint32_t* bytes) {
+    if(!filter || rule >= filter->rule_count) {
+        *lines = 0;
+        *bytes = 0;
+        return;
+    }
+    *lines = filter->drop_lines[rule];
+    *bytes = filter->drop_bytes[rule];
+}
+
+void evil_bw16_filter_reset_stats(EvilBw16LineFilter* filter) {
+    if(!filter) return;
+    memset(filter->drop_lines, 0, filter->rule_count * sizeof(uint32_t));
+    memset(filter->drop_bytes, 0, filter->rule_count * sizeof(uint32_t));
+}
@@ -0,0 +1,150 @@
+#include "evil_bw16.h"
+
+// Fixed-capacity line log.
+//
+// Line text lives in a byte arena that is filled front to back and wraps around; a
+// line never straddles the end of the arena, so each one can be handed out as a
+// single view. A separate ring of {offset, length} entries indexes the live lines,
+// oldest first. Appending evicts whole lines from the old end until the new one fits,
+// so both operations are O(1) per line and nothing is allocated after setup.
+
+typedef struct {
+    uint16_t offset;
+    uint16_t len;
+} EvilBw16LogEntry;
+
+struct EvilBw16LogStore {
+    char* arena;
+    size_t arena_size;
+    size_t write_pos;  // Where the next line would start
+    EvilBw16LogEntry* lines;
+    uint32_t line_mask;
+    uint32_t head;     // Free running, head - tail is the line count
+    uint32_t tail;
+    uint32_t seq;      // Lines appended since alloc, for cheap change detection
+    FuriMutex* mutex;
+};
+
+// line_capacity must be a power of two, arena_size at most 64 KB
+EvilBw16LogStore* evil_bw16_log_store_alloc(size_t arena_size, size_t line_capacity) {
+    furi_check(arena_size > 0 && arena_size <= UINT16_MAX + 1);
+    furi_check(line_capacity > 0 && (line_capacity & (line_capacity - 1)) == 0);
+
+    EvilBw16LogStore* store = malloc(sizeof(EvilBw16LogStore));
+    memset(store, 0, sizeof(EvilBw16LogStore));
+    store->arena = malloc(arena_size);
+    store->arena_size = arena_size;
+    store->lines = malloc(line_capacity * sizeof(EvilBw16LogEntry));
+    store->line_mask = line_capacity - 1;
+    store->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return store;
+}
+
+void evil_bw16_log_store_free(EvilBw16LogStore* store) {
+    if(!store) return;
+    furi_mutex_free(store->mutex);
+    free(store->lines);
+    free(store->arena);
+    free(store);
+}
+
+static void log_store_evict_oldest(EvilBw16LogStore* store) {
+    store->tail++;
+    if(store->head == store->tail) store->write_pos = 0;
+}
+
+// Find room for len bytes without touching live lines
+static bool log_store_find_space(EvilBw16LogStore* store, size_t len, size_t* pos) {
+    if(store->head == store->tail) {
+        *pos = 0;
+        return true;
+    }
+    if(store->head - store->tail > store->line_mask) return false;  // Index full
+
+    const size_t oldest = store->lines[store->tail & store->line_mask].offset;
+    if(store->write_pos > oldest) {
+        // Live data is [oldest, write_pos): free space at the end, then before oldest
+        if(store->arena_size - store->write_pos >= len) {
+            *pos = store->write_pos;
+            return true;
+        }
+        if(oldest >= len) {
+            *pos = 0;
+            return true;
+        }
+        return false;
+    }
+    // Wrapped: free space is [write_pos, oldest)
+    if(oldest - store->write_pos >= len) {
+        *pos = store->write_pos;
+        return true;
+    }
+    return false;
+}
+
+// Append prefix (may be NULL) followed by line as one entry, evicting old lines as needed
+void evil_bw16_log_store_append(EvilBw16LogStore* store, const char* prefix, EvilBw16LineView line) {
+    if(!store) return;
+
+    const size_t prefix_len = prefix ? strlen(prefix) : 0;
+    size_t len = MIN(prefix_len + line.len, store->arena_size);
+
+    furi_mutex_acquire(store->mutex, FuriWaitForever);
+
+    size_t pos;
+    while(!log_store_find_space(store, len, &pos)) {
+        log_store_evict_oldest(store);
+    }
+
+    const size_t head_len = MIN(prefix_len, len);
+    // memcpy from NULL is undefined even for zero bytes
+    if(head_len) memcpy(store->arena + pos, prefix, head_len);
+    if(len > head_len) memcpy(store->arena + pos + head_len, line.data, len - head_len);
+
+    EvilBw16LogEntry* entry = &store->lines[store->head & store->line_mask];
+    entry->offset = pos;
+    entry->len = len;
+    store->head++;
+    store->seq++;
+    store->write_pos = pos + len;
+    if(store->write_pos == store->arena_size) store->write_pos = 0;
+
+    furi_mutex_release(store->mutex);
+}
+
+void evil_bw16_log_store_clear(EvilBw16LogStore* store) {
+    if(!store) return;
+    furi_mutex_acquire(store->mutex, FuriWaitForever);
+    store->tail = store->head;
+    store->write_pos = 0;
+    store->seq++;
+    furi_mutex_release(store->mutex);
+}
+
+// Readers hold the lock while they walk lines; views stay valid until unlock
+void evil_bw16_log_store_lock(EvilBw16LogStore* store) {
+    furi_mutex_acquire(store->mutex, FuriWaitForever);
+}
+
+void evil_bw16_log_store_unlock(EvilBw16LogStore* store) {
+    furi_mutex_release(store->mutex);
+}
+
+size_t evil_bw16_log_store_count(EvilBw16LogStore* store) {
+    return store ? store->head - store->tail : 0;
+}
+
+// Line by age, 0 being the oldest line still stored
+EvilBw16LineView evil_bw16_log_store_get(EvilBw16LogStore* store, size_t index) {
+    const EvilBw16LogEntry* entry = &store->lines[(store->tail + index) & store->line_mask];
+    return evil_bw16_line_view(store->arena + entry->offset, entry->len);
+}
+
+// Stable id of line 0; line i has id first_id + i for as long as it is stored
+uint32_t evil_bw16_log_store_get_first_id(EvilBw16LogStore* store) {
+    return store ? store->tail : 0;
+}
+
+uint32_t evil_bw16_log_store_get_seq(EvilBw16LogStore* store) {
+    return store ? store->seq : 0;
+}
@@ -0,0 +1,706 @@
+#include "evil_bw16.h"
+#include <ctype.h>
+
+// Scan list storage.
+//
+// Networks live in fixed-size blocks that are taken from the heap as the list grows, up
+// to a RAM budget. A handle is a slot number in that pool, so it keeps naming the same
+// network until the network is removed or the table cleared; removed slots go on a free
+// list and are handed out again before a fresh block is touched. An open-addressing hash
+// over the 6-byte BSSID finds a network already in the table in O(1), so a BSSID that is
+// reported twice updates its entry instead of taking a second one. The order array lists
+// handles in the order networks were first seen, which is the order scenes show them in.
+//
+// The table outlives a scan. Each scan's results are merged into it: a network heard
+// again has its last-seen tick, seen count and smoothed RSSI updated in place, and the
+// heard array lists the handles reported since the scan began, for the live view.
+// Networks not heard for a while are aged out when the next scan starts, and when a new
+// network finds the table full the one heard longest ago makes room for it, as long as
+// it was not heard in the current scan.
+//
+// For each sort key other than arrival the table keeps a permutation: the handles in
+// that order. A new network is placed with a binary search and a move, and one whose key
+// changed (RSSI on nearly every report) is taken out and placed again, so switching
+// between sort orders costs nothing and nothing is ever re-sorted. Filters are applied
+// by the reader while walking a permutation.
+//
+// SSIDs are interned in an arena of 256-byte chunks, also taken as needed. Entries hold
+// a 16-bit offset into it, and networks broadcasting the same SSID (mesh nodes, one
+// SSID per band) share one copy, found through a second hash. Nothing in the arena is
+// freed on its own; ageing repacks it around the networks that remain.
+//
+// Only the UART worker and the GUI thread use the table, and everything either reads
+// beyond the counts happens under the table mutex. Changes take it themselves; a reader
+// walking positions, or using an entry or SSID it got from the table, holds it with
+// evil_bw16_network_table_lock() for as long as it does. An entry is 24 bytes and the
+// arrays are shifted with memmove, neither of which a reader could see change safely.
+// The counts are also published atomically, so polling them needs no lock. Blocks are
+// only returned by _set_budget() and _free(), which run on the GUI thread.
+
+#define NETWORK_BLOCK_SIZE (16)  // Networks per pool block
+#define SSID_CHUNK_SIZE (256)    // Arena bytes per chunk; an SSID never spans two
+#define SSID_AVG_LEN (16)        // Arena budgeted per network, terminator included
+#define SSID_NONE (0xFFFF)       // Offset of the hidden (empty) SSID
+#define RSSI_AVG_SCALE (16)      // Fixed point of rssi_avg
+#define RSSI_AVG_WEIGHT (4)      // A new report moves the average a quarter of the way
+
+struct EvilBw16NetworkTable {
+    FuriMutex* mutex;
+    size_t budget;            // Bytes for the pool, order array and hash
+    uint16_t max_networks;    // What the budget holds, a whole number of blocks
+    EvilBw16Network** blocks; // max_networks / NETWORK_BLOCK_SIZE, allocated on first use
+    uint16_t block_count;     // Blocks allocated
+    uint16_t used;            // Slots handed out from the blocks so far
+    uint16_t free_head;       // Pool free list, linked through the freed entries
+    uint16_t* order;          // Handles, first seen first
+    uint16_t count;           // Entries in order, accessed atomically
+    uint16_t* sorted[EvilBw16NetworkSortNum]; // Permutations of order; arrival uses order itself
+    uint16_t* heard;          // Handles reported since the scan began, first heard first
+    uint16_t heard_count;     // Accessed atomically
+    uint32_t scan_start;      // Tick the current (or last) scan began
+    uint16_t* hash;           // Handles by BSSID, linear probing
+    uint16_t hash_mask;
+    uint8_t hash_shift;
+    char** ssid_chunks;       // ssid_chunk_max, allocated on first use
+    uint16_t ssid_chunk_max;
+    uint16_t ssid_chunk_count;
+    uint16_t ssid_used;       // Arena offset of the next SSID
+    uint16_t ssid_count;      // SSIDs interned, at most max_networks to bound the hash load
+    uint16_t* ssid_hash;      // Arena offsets by SSID, linear probing, same size as hash
+    uint32_t generation;      // Bumped whenever the table is emptied
+    uint32_t duplicates;      // Reports of a BSSID already heard in the same scan
+    uint32_t merged;          // Networks heard again in a later scan
+    uint32_t rejected;        // New networks turned away by the budget
+    uint32_t evicted;         // Networks dropped to make room for a new one
+    bool ssid_stale;          // The arena holds SSIDs of dropped networks
+    uint32_t ssids_shared;    // New networks that reused an interned SSID
+};
+
+static inline EvilBw16Network* pool_slot(const EvilBw16NetworkTable* table, uint16_t handle) {
+    return &table->blocks[handle / NETWORK_BLOCK_SIZE][handle % NETWORK_BLOCK_SIZE];
+}
+
+static uint16_t pool_alloc(EvilBw16NetworkTable* table) {
+    if(table->free_head != EVIL_BW16_NETWORK_NONE) {
+        const uint16_t handle = table->free_head;
+        memcpy(&table->free_head, pool_slot(table, handle), sizeof(uint16_t));
+        return handle;
+    }
+    if(table->used == table->max_networks) return EVIL_BW16_NETWORK_NONE;
+
+    const uint16_t block = table->used / NETWORK_BLOCK_SIZE;
+    if(block == table->block_count) {
+        table->blocks[block] = malloc(NETWORK_BLOCK_SIZE * sizeof(EvilBw16Network));
+        table->block_count++;
+    }
+    return table->used++;
+}
+
+// Freed slots keep the next free handle in their first bytes. A seen count of zero marks
+// them, so a handle kept past its network's removal finds nothing.
+static void pool_release(EvilBw16NetworkTable* table, uint16_t handle) {
+    pool_slot(table, handle)->seen_count = 0;
+    memcpy(pool_slot(table, handle), &table->free_head, sizeof(uint16_t));
+    table->free_head = handle;
+}
+
+// Fibonacci hashing over the whole address; the vendor half alone clusters badly
+static inline uint32_t hash_home(const EvilBw16NetworkTable* table, const uint8_t* bssid) {
+    const uint32_t low = (uint32_t)bssid[2] << 24 | (uint32_t)bssid[3] << 16 | (uint32_t)bssid[4] << 8 | bssid[5];
+    const uint32_t key = low ^ ((uint32_t)bssid[0] << 8 | bssid[1]) * 0x85EBCA6BU;
+    return (uint32_t)(key * 0x9E3779B1U) >> table->hash_shift;
+}
+
+// Hash slot holding bssid, or the empty slot where it would go
+static uint32_t hash_probe(const EvilBw16NetworkTable* table, const uint8_t* bssid) {
+    uint32_t slot = hash_home(table, bssid);
+    while(table->hash[slot] != EVIL_BW16_NETWORK_NONE &&
+          memcmp(pool_slot(table, table->hash[slot])->bssid, bssid, sizeof(((EvilBw16Network*)0)->bssid)) != 0) {
+        slot = (slot + 1) & table->hash_mask;
+    }
+    return slot;
+}
+
+// Empty a slot and pull later entries of the same probe run back over it
+static void hash_delete(EvilBw16NetworkTable* table, uint32_t slot) {
+    uint32_t next = slot;
+    table->hash[slot] = EVIL_BW16_NETWORK_NONE;
+    while(true) {
+        next = (next + 1) & table->hash_mask;
+        const uint16_t handle = table->hash[next];
+        if(handle == EVIL_BW16_NETWORK_NONE) return;
+
+        // Move it if its home is not cyclically within (slot, next]
+        const uint32_t home = hash_home(table, pool_slot(table, handle)->bssid);
+        const bool stays = slot <= next ? (home > slot && home <= next) : (home > slot || home <= next);
+        if(!stays) {
+            table->hash[slot] = handle;
+            table->hash[next] = EVIL_BW16_NETWORK_NONE;
+            slot = next;
+        }
+    }
+}
+
+static inline const char* ssid_at(const EvilBw16NetworkTable* table, uint16_t offset) {
+    return &table->ssid_chunks[offset / SSID_CHUNK_SIZE][offset % SSID_CHUNK_SIZE];
+}
+
+// FNV-1a
+static inline uint32_t ssid_hash_home(const EvilBw16NetworkTable* table, EvilBw16LineView ssid) {
+    uint32_t key = 2166136261U;
+    for(size_t i = 0; i < ssid.len; i++) {
+        key = (key ^ (uint8_t)ssid.data[i]) * 16777619U;
+    }
+    return (uint32_t)(key * 0x9E3779B1U) >> table->hash_shift;
+}
+
+// Arena offset of ssid, adding it when new. SSID_NONE for a hidden SSID, and when the
+// arena is full (*full is set then).
+static uint16_t ssid_intern(EvilBw16NetworkTable* table, EvilBw16LineView ssid, bool* shared, bool* full) {
+    *shared = false;
+    *full = false;
+    ssid.len = MIN(ssid.len, (size_t)EVIL_BW16_SSID_MAX_LEN);
+    if(ssid.len == 0) return SSID_NONE;
+
+    uint32_t slot = ssid_hash_home(table, ssid);
+    while(table->ssid_hash[slot] != SSID_NONE) {
+        const char* interned = ssid_at(table, table->ssid_hash[slot]);
+        if(strncmp(interned, ssid.data, ssid.len) == 0 && interned[ssid.len] == '\0') {
+            *shared = true;
+            return table->ssid_hash[slot];
+        }
+        slot = (slot + 1) & table->hash_mask;
+    }
+
+    uint16_t offset = table->ssid_used;
+    if(offset % SSID_CHUNK_SIZE + ssid.len + 1 > SSID_CHUNK_SIZE) {
+        offset = (offset / SSID_CHUNK_SIZE + 1) * SSID_CHUNK_SIZE;  // Next chunk
+    }
+    const uint16_t chunk = offset / SSID_CHUNK_SIZE;
+    if(chunk >= table->ssid_chunk_max || table->ssid_count == table->max_networks) {
+        *full = true;
+        return SSID_NONE;
+    }
+    if(chunk == table->ssid_chunk_count) {
+        table->ssid_chunks[chunk] = malloc(SSID_CHUNK_SIZE);
+        table->ssid_chunk_count++;
+    }
+
+    char* copy = (char*)ssid_at(table, offset);
+    memcpy(copy, ssid.data, ssid.len);
+    copy[ssid.len] = '\0';
+    table->ssid_used = offset + ssid.len + 1;
+    table->ssid_count++;
+    table->ssid_hash[slot] = offset;
+    return offset;
+}
+
+static void table_release_storage(EvilBw16NetworkTable* table) {
+    for(uint16_t i = 0; i < table->block_count; i++) {
+        free(table->blocks[i]);
+    }
+    for(uint16_t i = 0; i < table->ssid_chunk_count; i++) {
+        free(table->ssid_chunks[i]);
+    }
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        free(table->sorted[sort]);
+        table->sorted[sort] = NULL;
+    }
+    free(table->blocks);
+    free(table->order);
+    free(table->heard);
+    free(table->hash);
+    free(table->ssid_chunks);
+    free(table->ssid_hash);
+    table->blocks = NULL;
+    table->order = NULL;
+    table->heard = NULL;
+    table->hash = NULL;
+    table->ssid_chunks = NULL;
+    table->ssid_hash = NULL;
+    table->block_count = 0;
+    table->ssid_chunk_count = 0;
+}
+
+static void table_reset(EvilBw16NetworkTable* table) {
+    __atomic_store_n(&table->count, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&table->heard_count, 0, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&table->generation, 1, __ATOMIC_RELEASE);
+    table->used = 0;
+    table->free_head = EVIL_BW16_NETWORK_NONE;
+    table->ssid_used = 0;
+    table->ssid_count = 0;
+    table->ssid_stale = false;
+    memset(table->hash, 0xFF, (table->hash_mask + 1) * sizeof(uint16_t));
+    memset(table->ssid_hash, 0xFF, (table->hash_mask + 1) * sizeof(uint16_t));
+}
+
+// Handle arrays with one slot per network: order, heard and a permutation per sort key
+// other than arrival
+#define TABLE_POSITION_ARRAYS (2 + EvilBw16NetworkSortNum - 1)
+
+// Bits of a hash over max entries, at a load of at most three quarters
+static uint8_t table_hash_bits(size_t max) {
+    uint8_t bits = 1;
+    while((3U << bits) / 4 < max) bits++;
+    return bits;
+}
+
+// Size the pool, order array, hashes and arena for budget bytes. Each network costs its
+// entry, one slot in each position array and SSID_AVG_LEN of arena; the two hashes come
+// in powers of two on top, so whole blocks come off until they fit too.
+static void table_setup(EvilBw16NetworkTable* table, size_t budget) {
+    const size_t per_network = sizeof(EvilBw16Network) + TABLE_POSITION_ARRAYS * sizeof(uint16_t) + SSID_AVG_LEN;
+    size_t max = budget / per_network;
+    max = MIN(max, (size_t)EVIL_BW16_NETWORK_TABLE_MAX) / NETWORK_BLOCK_SIZE * NETWORK_BLOCK_SIZE;
+    while(max > NETWORK_BLOCK_SIZE && max * per_network + (2U << table_hash_bits(max)) * sizeof(uint16_t) > budget) {
+        max -= NETWORK_BLOCK_SIZE;
+    }
+    max = MAX(max, (size_t)NETWORK_BLOCK_SIZE);
+
+    const uint8_t bits = table_hash_bits(max);
+
+    table->budget = budget;
+    table->max_networks = max;
+    table->blocks = malloc(max / NETWORK_BLOCK_SIZE * sizeof(EvilBw16Network*));
+    table->order = malloc(max * sizeof(uint16_t));
+    table->heard = malloc(max * sizeof(uint16_t));
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        table->sorted[sort] = malloc(max * sizeof(uint16_t));
+    }
+    table->hash = malloc((1U << bits) * sizeof(uint16_t));
+    table->hash_mask = (1U << bits) - 1;
+    table->hash_shift = 32 - bits;
+    table->ssid_chunk_max = (max * SSID_AVG_LEN + SSID_CHUNK_SIZE - 1) / SSID_CHUNK_SIZE;
+    table->ssid_chunks = malloc(table->ssid_chunk_max * sizeof(char*));
+    table->ssid_hash = malloc((1U << bits) * sizeof(uint16_t));
+    table_reset(table);
+}
+
+EvilBw16NetworkTable* evil_bw16_network_table_alloc(size_t budget) {
+    EvilBw16NetworkTable* table = malloc(sizeof(EvilBw16NetworkTable));
+    memset(table, 0, sizeof(EvilBw16NetworkTable));
+    table->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    table_setup(table, budget);
+    return table;
+}
+
+void evil_bw16_network_table_free(EvilBw16NetworkTable* table) {
+    if(!table) return;
+    table_release_storage(table);
+    furi_mutex_free(table->mutex);
+    free(table);
+}
+
+// Resize to a new budget. Empties the table and returns its blocks; GUI thread only.
+void evil_bw16_network_table_set_budget(EvilBw16NetworkTable* table, size_t budget) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    table_release_storage(table);
+    table_setup(table, budget);
+    furi_mutex_release(table->mutex);
+}
+
+// Forget every network and SSID. The blocks and chunks stay allocated for the next scan.
+void evil_bw16_network_table_clear(EvilBw16NetworkTable* table) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    table_reset(table);
+    furi_mutex_release(table->mutex);
+}
+
+// Hidden SSIDs sort last, the rest without regard to case
+static int ssid_compare(const EvilBw16NetworkTable* table, uint16_t a, uint16_t b) {
+    if(a == SSID_NONE || b == SSID_NONE) return (a == SSID_NONE) - (b == SSID_NONE);
+    const char* x = ssid_at(table, a);
+    const char* y = ssid_at(table, b);
+    while(*x && tolower((unsigned char)*x) == tolower((unsigned char)*y)) {
+        x++;
+        y++;
+    }
+    return tolower((unsigned char)*x) - tolower((unsigned char)*y);
+}
+
+// Negative when a goes before b in the sort
+static int sort_compare(const EvilBw16NetworkTable* table, EvilBw16NetworkSort sort, const EvilBw16Network* a, const EvilBw16Network* b) {
+    switch(sort) {
+        case EvilBw16NetworkSortRssi:
+            return b->rssi_avg - a->rssi_avg;  // Strongest first
+        case EvilBw16NetworkSortChannel:
+            return a->channel - b->channel;
+        case EvilBw16NetworkSortBand:
+            return a->band - b->band;
+        case EvilBw16NetworkSortSsid:
+            return ssid_compare(table, a->ssid, b->ssid);
+        default:
+            return 0;
+    }
+}
+
+// Place handle after every entry that sorts before it or equal, so ties keep arrival order
+static void sorted_insert(EvilBw16NetworkTable* table, EvilBw16NetworkSort sort, uint16_t handle, uint16_t count) {
+    uint16_t* sorted = table->sorted[sort];
+    const EvilBw16Network* entry = pool_slot(table, handle);
+    uint16_t low = 0;
+    uint16_t high = count;
+    while(low < high) {
+        const uint16_t mid = (low + high) / 2;
+        if(sort_compare(table, sort, entry, pool_slot(table, sorted[mid])) < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    memmove(&sorted[low + 1], &sorted[low], (count - low) * sizeof(uint16_t));
+    sorted[low] = handle;
+}
+
+// Take handle out, finding it from the start of its run of equal keys. Its entry must
+// still hold the key it was placed with.
+static void sorted_remove(EvilBw16NetworkTable* table, EvilBw16NetworkSort sort, uint16_t handle, uint16_t count) {
+    uint16_t* sorted = table->sorted[sort];
+    const EvilBw16Network* entry = pool_slot(table, handle);
+    uint16_t low = 0;
+    uint16_t high = count;
+    while(low < high) {
+        const uint16_t mid = (low + high) / 2;
+        if(sort_compare(table, sort, pool_slot(table, sorted[mid]), entry) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    while(low < count && sorted[low] != handle) low++;
+    if(low == count) return;
+    memmove(&sorted[low], &sorted[low + 1], (count - low - 1) * sizeof(uint16_t));
+}
+
+static inline bool heard_since(uint32_t tick, uint32_t since) {
+    return (int32_t)(tick - since) >= 0;
+}
+
+static void heard_append(EvilBw16NetworkTable* table, uint16_t handle) {
+    const uint16_t heard_count = table->heard_count;
+    table->heard[heard_count] = handle;
+    __atomic_store_n(&table->heard_count, heard_count + 1, __ATOMIC_RELEASE);
+}
+
+// Copy every SSID still referenced into fresh chunks, then drop the old ones
+static void ssid_repack(EvilBw16NetworkTable* table) {
+    char** old_chunks = table->ssid_chunks;
+    const uint16_t old_chunk_count = table->ssid_chunk_count;
+
+    table->ssid_chunks = malloc(table->ssid_chunk_max * sizeof(char*));
+    table->ssid_chunk_count = 0;
+    table->ssid_used = 0;
+    table->ssid_count = 0;
+    table->ssid_stale = false;
+    memset(table->ssid_hash, 0xFF, (table->hash_mask + 1) * sizeof(uint16_t));
+
+    for(uint16_t i = 0; i < table->count; i++) {
+        EvilBw16Network* entry = pool_slot(table, table->order[i]);
+        if(entry->ssid == SSID_NONE) continue;
+        const char* ssid = &old_chunks[entry->ssid / SSID_CHUNK_SIZE][entry->ssid % SSID_CHUNK_SIZE];
+        bool shared, full;
+        entry->ssid = ssid_intern(table, evil_bw16_line_view(ssid, strlen(ssid)), &shared, &full);
+    }
+
+    for(uint16_t i = 0; i < old_chunk_count; i++) {
+        free(old_chunks[i]);
+    }
+    free(old_chunks);
+}
+
+// Drop one network; the positions after it move up by one. Its SSID stays in the arena
+// until the next repack.
+static void table_remove(EvilBw16NetworkTable* table, uint16_t handle) {
+    const uint32_t slot = hash_probe(table, pool_slot(table, handle)->bssid);
+    if(table->hash[slot] != handle) return;
+    hash_delete(table, slot);
+
+    const uint16_t count = table->count;
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        sorted_remove(table, sort, handle, count);
+    }
+    uint16_t position = 0;
+    while(table->order[position] != handle) position++;
+    memmove(&table->order[position], &table->order[position + 1], (count - position - 1) * sizeof(uint16_t));
+    __atomic_store_n(&table->count, count - 1, __ATOMIC_RELEASE);
+
+    const uint16_t heard_count = table->heard_count;
+    position = 0;
+    while(position < heard_count && table->heard[position] != handle) position++;
+    if(position < heard_count) {
+        memmove(&table->heard[position], &table->heard[position + 1], (heard_count - position - 1) * sizeof(uint16_t));
+        __atomic_store_n(&table->heard_count, heard_count - 1, __ATOMIC_RELEASE);
+    }
+
+    if(pool_slot(table, handle)->ssid != SSID_NONE) table->ssid_stale = true;
+    pool_release(table, handle);
+}
+
+// Drop the network heard longest ago to make room for a new one. Networks heard in the
+// current scan stay, since the BW16 knows them by their index. Returns false when there
+// is nothing to drop.
+static bool table_evict_stalest(EvilBw16NetworkTable* table) {
+    uint16_t stalest = EVIL_BW16_NETWORK_NONE;
+    uint32_t stalest_age = 0;
+    const uint32_t now = furi_get_tick();
+    for(uint16_t i = 0; i < table->count; i++) {
+        const EvilBw16Network* entry = pool_slot(table, table->order[i]);
+        if(heard_since(entry->last_seen, table->scan_start)) continue;
+        if(stalest == EVIL_BW16_NETWORK_NONE || now - entry->last_seen > stalest_age) {
+            stalest = table->order[i];
+            stalest_age = now - entry->last_seen;
+        }
+    }
+    if(stalest == EVIL_BW16_NETWORK_NONE) return false;
+
+    table_remove(table, stalest);
+    table->evicted++;
+    return true;
+}
+
+// Intern the SSID of a new network, making room in the arena when it is full: first by
+// dropping the SSIDs of networks already gone, then by evicting more networks. An SSID
+// never spans two chunks, so one eviction does not always free enough.
+static uint16_t ssid_intern_new(EvilBw16NetworkTable* table, EvilBw16LineView ssid, bool* shared, bool* full) {
+    uint16_t offset = ssid_intern(table, ssid, shared, full);
+    if(*full && table->ssid_stale) {
+        ssid_repack(table);
+        offset = ssid_intern(table, ssid, shared, full);
+    }
+    while(*full && table_evict_stalest(table)) {
+        ssid_repack(table);
+        offset = ssid_intern(table, ssid, shared, full);
+    }
+    return offset;
+}
+
+// Hold off changes while reading positions, entries or SSIDs. Not reentrant, and the
+// table's own functions that take the mutex must not be called while it is held.
+void evil_bw16_network_table_lock(EvilBw16NetworkTable* table) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+}
+
+void evil_bw16_network_table_unlock(EvilBw16NetworkTable* table) {
+    furi_mutex_release(table->mutex);
+}
+
+// Start merging a new scan: the heard list empties and readers see a new generation
+void evil_bw16_network_table_begin_scan(EvilBw16NetworkTable* table) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    table->scan_start = furi_get_tick();
+    __atomic_store_n(&table->heard_count, 0, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&table->generation, 1, __ATOMIC_RELEASE);
+    furi_mutex_release(table->mutex);
+}
+
+// Merge one report of network named ssid. A BSSID already in the table keeps its entry,
+// selection and first-seen tick, and keeps its SSID when the arena has no room for a new
+// one. Returns the handle, or EVIL_BW16_NETWORK_NONE when a new network does not fit the
+// budget.
+EvilBw16NetworkHandle evil_bw16_network_table_upsert(EvilBw16NetworkTable* table, const EvilBw16Network* network, EvilBw16LineView ssid, bool* created) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+
+    const uint32_t slot = hash_probe(table, network->bssid);
+    uint16_t handle = table->hash[slot];
+    if(created) *created = handle == EVIL_BW16_NETWORK_NONE;
+
+    EvilBw16Network record = *network;
+    record.last_seen = furi_get_tick();
+    bool shared = false, full = false;
+    if(handle != EVIL_BW16_NETWORK_NONE) {
+        EvilBw16Network* entry = pool_slot(table, handle);
+        const uint16_t offset = ssid_intern(table, ssid, &shared, &full);
+        const bool heard = heard_since(entry->last_seen, table->scan_start);
+        record.ssid = full ? entry->ssid : offset;
+        // A renamed network leaves its old SSID behind for the next repack
+        if(record.ssid != entry->ssid && entry->ssid != SSID_NONE) table->ssid_stale = true;
+        record.selected = entry->selected;
+        record.first_seen = entry->first_seen;
+        record.seen_count = entry->seen_count + (heard ? 0 : 1);
+        record.rssi_avg = entry->rssi_avg + (record.rssi * RSSI_AVG_SCALE - entry->rssi_avg) / RSSI_AVG_WEIGHT;
+
+        // Reposition in the orders whose key changed
+        uint8_t moved = 0;
+        for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+            if(sort_compare(table, sort, entry, &record) != 0) {
+                sorted_remove(table, sort, handle, table->count);
+                moved |= 1 << sort;
+            }
+        }
+        *entry = record;
+        for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+            if(moved & (1 << sort)) sorted_insert(table, sort, handle, table->count - 1);
+        }
+        if(heard) {
+            table->duplicates++;
+        } else {
+            table->merged++;
+            heard_append(table, handle);
+        }
+    } else {
+        handle = pool_alloc(table);
+        if(handle == EVIL_BW16_NETWORK_NONE && table_evict_stalest(table)) handle = pool_alloc(table);
+        if(handle != EVIL_BW16_NETWORK_NONE) {
+            record.ssid = ssid_intern_new(table, ssid, &shared, &full);
+            if(full) {
+                pool_release(table, handle);
+                handle = EVIL_BW16_NETWORK_NONE;
+            }
+        }
+        if(handle == EVIL_BW16_NETWORK_NONE) {
+            table->rejected++;
+        } else {
+            record.first_seen = record.last_seen;
+            record.seen_count = 1;
+            record.rssi_avg = record.rssi * RSSI_AVG_SCALE;
+            *pool_slot(table, handle) = record;
+            if(shared) table->ssids_shared++;
+            // Eviction may have moved things in the hash since the probe
+            table->hash[hash_probe(table, record.bssid)] = handle;
+            const uint16_t count = table->count;
+            table->order[count] = handle;
+            for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+                sorted_insert(table, sort, handle, count);
+            }
+            __atomic_store_n(&table->count, count + 1, __ATOMIC_RELEASE);
+            heard_append(table, handle);
+        }
+    }
+
+    furi_mutex_release(table->mutex);
+    return handle;
+}
+
+// Drop one network; the positions after it move up by one
+void evil_bw16_network_table_remove(EvilBw16NetworkTable* table, EvilBw16NetworkHandle handle) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    table_remove(table, handle);
+    furi_mutex_release(table->mutex);
+}
+
+// Compact handles to those heard within max_age of now, keeping their order
+static uint16_t keep_recent(EvilBw16NetworkTable* table, uint16_t* handles, uint16_t count, uint32_t now, uint32_t max_age) {
+    uint16_t kept = 0;
+    for(uint16_t i = 0; i < count; i++) {
+        if(now - pool_slot(table, handles[i])->last_seen <= max_age) handles[kept++] = handles[i];
+    }
+    return kept;
+}
+
+// Drop networks not heard for max_age ticks and repack the SSID arena around the rest.
+// Returns how many went. The worker calls it as each scan begins.
+size_t evil_bw16_network_table_age(EvilBw16NetworkTable* table, uint32_t max_age) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+
+    const uint32_t now = furi_get_tick();
+    const uint16_t count = table->count;
+    uint16_t kept = 0;
+    for(uint16_t i = 0; i < count; i++) {
+        const uint16_t handle = table->order[i];
+        EvilBw16Network* entry = pool_slot(table, handle);
+        if(now - entry->last_seen <= max_age) {
+            table->order[kept++] = handle;
+        } else {
+            hash_delete(table, hash_probe(table, entry->bssid));
+            pool_release(table, handle);
+        }
+    }
+    __atomic_store_n(&table->count, kept, __ATOMIC_RELEASE);
+
+    // Released entries keep their last-seen tick, so the same test thins the other arrays
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        keep_recent(table, table->sorted[sort], count, now, max_age);
+    }
+    __atomic_store_n(&table->heard_count, keep_recent(table, table->heard, table->heard_count, now, max_age), __ATOMIC_RELEASE);
+
+    if(kept < count || table->ssid_stale) ssid_repack(table);
+
+    furi_mutex_release(table->mutex);
+    return count - kept;
+}
+
+EvilBw16NetworkHandle evil_bw16_network_table_find(EvilBw16NetworkTable* table, const uint8_t* bssid) {
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    const uint16_t handle = table->hash[hash_probe(table, bssid)];
+    furi_mutex_release(table->mutex);
+    return handle;
+}
+
+// Changes whenever the table is emptied, so a reader can tell a new list from a grown one
+uint32_t evil_bw16_network_table_get_generation(EvilBw16NetworkTable* table) {
+    return table ? __atomic_load_n(&table->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+size_t evil_bw16_network_table_count(EvilBw16NetworkTable* table) {
+    return table ? __atomic_load_n(&table->count, __ATOMIC_ACQUIRE) : 0;
+}
+
+size_t evil_bw16_network_table_heard_count(EvilBw16NetworkTable* table) {
+    return table ? __atomic_load_n(&table->heard_count, __ATOMIC_ACQUIRE) : 0;
+}
+
+// Handle of the network heard at a position in the current scan, first heard first.
+// This and the other position and entry lookups below need the table locked.
+EvilBw16NetworkHandle evil_bw16_network_table_heard_at(EvilBw16NetworkTable* table, size_t position) {
+    if(position >= evil_bw16_network_table_heard_count(table)) return EVIL_BW16_NETWORK_NONE;
+    return table->heard[position];
+}
+
+// Whether network was reported in the current (or last) scan, so its device index is
+// the one the BW16 uses now
+bool evil_bw16_network_table_in_scan(EvilBw16NetworkTable* table, const EvilBw16Network* network) {
+    return table && network && heard_since(network->last_seen, table->scan_start);
+}
+
+// Handle of the network at a position in one sort order
+EvilBw16NetworkHandle evil_bw16_network_table_sorted_at(EvilBw16NetworkTable* table, EvilBw16NetworkSort sort, size_t position) {
+    if(sort == EvilBw16NetworkSortArrival || sort >= EvilBw16NetworkSortNum) return evil_bw16_network_table_at(table, position);
+    if(position >= evil_bw16_network_table_count(table)) return EVIL_BW16_NETWORK_NONE;
+    return table->sorted[sort][position];
+}
+
+// Handle of the network at a list position, first seen first
+EvilBw16NetworkHandle evil_bw16_network_table_at(EvilBw16NetworkTable* table, size_t position) {
+    if(position >= evil_bw16_network_table_count(table)) return EVIL_BW16_NETWORK_NONE;
+    return table->order[position];
+}
+
+// NULL when handle names no network (any more)
+EvilBw16Network* evil_bw16_network_table_get(EvilBw16NetworkTable* table, EvilBw16NetworkHandle handle) {
+    if(!table || handle == EVIL_BW16_NETWORK_NONE || handle >= table->used) return NULL;
+    EvilBw16Network* entry = pool_slot(table, handle);
+    return entry->seen_count ? entry : NULL;
+}
+
+// SSID of a network from this table; "" when hidden
+const char* evil_bw16_network_table_get_ssid(EvilBw16NetworkTable* table, const EvilBw16Network* network) {
+    if(!table || !network || network->ssid == SSID_NONE) return "";
+    return ssid_at(table, network->ssid);
+}
+
+void evil_bw16_network_table_get_stats(EvilBw16NetworkTable* table, EvilBw16NetworkTableStats* stats) {
+    memset(stats, 0, sizeof(EvilBw16NetworkTableStats));
+    if(!table) return;
+
+    furi_mutex_acquire(table->mutex, FuriWaitForever);
+    stats->count = table->count;
+    stats->capacity = table->max_networks;
+    stats->budget = table->budget;
+    stats->bytes = table->block_count * NETWORK_BLOCK_SIZE * sizeof(EvilBw16Network) +
+                   table->ssid_chunk_count * SSID_CHUNK_SIZE + TABLE_POSITION_ARRAYS * table->max_networks * sizeof(uint16_t) +
+                   2 * (table->hash_mask + 1) * sizeof(uint16_t);
+    stats->ssid_bytes = table->ssid_used;
+    stats->duplicates = table->duplicates;
+    stats->merged = table->merged;
+    stats->rejected = table->rejected;
+    stats->evicted = table->evicted;
+    stats->ssids_shared = table->ssids_shared;
+    furi_mutex_release(table->mutex);
+}
+
+// "AA:BB:CC:DD:EE:FF"; out needs EVIL_BW16_BSSID_STR_LEN bytes
+void evil_bw16_format_bssid(const uint8_t* bssid, char* out) {
+    snprintf(out, EVIL_BW16_BSSID_STR_LEN, "%02X:%02X:%02X:%02X:%02X:%02X",
+             bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+}
@@ -0,0 +1,72 @@
+#include "evil_bw16.h"
+
+// Coalesced worker -> GUI notifications.
+//
+// The UART worker raises dirty bits per event class instead of posting one custom event
+// per line or frame. The first raise arms a one-shot timer; when it fires a single
+// EvilBw16EventNotify is posted and the GUI thread takes all bits raised in the meantime.
+// So the GUI queue sees at most one wakeup per EVIL_BW16_NOTIFY_INTERVAL_MS however busy
+// the link is. Raises folded into an earlier wakeup are counted as suppressed.
+
+struct EvilBw16Notifier {
+    ViewDispatcher* view_dispatcher;
+    FuriTimer* timer;
+    uint32_t pending;  // EvilBw16NotifyFlags, accessed atomically
+    bool armed;        // Timer running, accessed atomically
+    uint32_t raised;   // Raises since alloc
+    uint32_t wakeups;  // Events posted to the GUI thread
+};
+
+static void notifier_timer_callback(void* context) {
+    EvilBw16Notifier* notifier = context;
+
+    // Disarm before posting so a raise from here on schedules the next wakeup
+    __atomic_store_n(&notifier->armed, false, __ATOMIC_RELEASE);
+    if(__atomic_load_n(&notifier->pending, __ATOMIC_ACQUIRE)) {
+        notifier->wakeups++;
+        view_dispatcher_send_custom_event(notifier->view_dispatcher, EvilBw16EventNotify);
+    }
+}
+
+EvilBw16Notifier* evil_bw16_notifier_alloc(ViewDispatcher* view_dispatcher) {
+    EvilBw16Notifier* notifier = malloc(sizeof(EvilBw16Notifier));
+    memset(notifier, 0, sizeof(EvilBw16Notifier));
+    notifier->view_dispatcher = view_dispatcher;
+    notifier->timer = furi_timer_alloc(notifier_timer_callback, FuriTimerTypeOnce, notifier);
+    return notifier;
+}
+
+void evil_bw16_notifier_free(EvilBw16Notifier* notifier) {
+    if(!notifier) return;
+    furi_timer_stop(notifier->timer);
+    furi_timer_free(notifier->timer);
+    free(notifier);
+}
+
+// Mark event classes dirty; callable from any thread, never blocks on the GUI
+void evil_bw16_notify(EvilBw16Notifier* notifier, uint32_t flags) {
+    if(!notifier) return;
+
+    __atomic_fetch_or(&notifier->pending, flags, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&notifier->raised, 1, __ATOMIC_RELAXED);
+
+    if(!__atomic_exchange_n(&notifier->armed, true, __ATOMIC_ACQ_REL)) {
+        furi_timer_start(notifier->timer, furi_ms_to_ticks(EVIL_BW16_NOTIFY_INTERVAL_MS));
+    }
+}
+
+// Collect and clear the dirty bits; called by the GUI thread on EvilBw16EventNotify
+uint32_t evil_bw16_notifier_take(EvilBw16Notifier* notifier) {
+    return notifier ? __atomic_exchange_n(&notifier->pending, 0, __ATOMIC_ACQ_REL) : 0;
+}
+
+// Raises that did not get a wakeup of their own
+uint32_t evil_bw16_notifier_get_suppressed(EvilBw16Notifier* notifier) {
+    if(!notifier) return 0;
+    const uint32_t raised = __atomic_load_n(&notifier->raised, __ATOMIC_RELAXED);
+    return raised - notifier->wakeups;
+}
+
+uint32_t evil_bw16_notifier_get_wakeups(EvilBw16Notifier* notifier) {
+    return notifier ? notifier->wakeups : 0;
+}
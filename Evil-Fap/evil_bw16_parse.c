@@ -0,0 +1,201 @@
+#include "evil_bw16.h"
+#include <limits.h>
+
+// Parsing of BW16 output: line classification, scan result lines and the line view
+// helpers. Plain C on top of the line views, so it also builds on a desktop (see host/).
+
+// Classify a line by its bracketed tag. The tag's first letter and length select
+// at most one candidate, so this costs one memcmp regardless of how many tags exist.
+EvilBw16ResponseType evil_bw16_classify_line(EvilBw16LineView line) {
+    if(line.len == 0) return EvilBw16ResponseUnknown;
+    
+    if(line.data[0] == '[') {
+        // Longest known tag is "[ERROR]", so only look a few bytes ahead for the ']'
+        const char* close = memchr(line.data + 1, ']', MIN(line.len - 1, (size_t)7));
+        if(!close) return EvilBw16ResponseUnknown;
+        
+        const char* tag = line.data + 1;
+        const size_t tag_len = close - tag;
+        switch(tag[0]) {
+            case 'I':
+                if(tag_len == 4 && memcmp(tag, "INFO", 4) == 0) return EvilBw16ResponseInfo;
+                break;
+            case 'E':
+                if(tag_len == 5 && memcmp(tag, "ERROR", 5) == 0) return EvilBw16ResponseError;
+                break;
+            case 'D':
+                if(tag_len == 5 && memcmp(tag, "DEBUG", 5) == 0) return EvilBw16ResponseDebug;
+                if(tag_len == 4 && memcmp(tag, "DATA", 4) == 0) return EvilBw16ResponseData;
+                break;
+            case 'C':
+                if(tag_len == 3 && memcmp(tag, "CMD", 3) == 0) return EvilBw16ResponseCommand;
+                break;
+            case 'M':
+                if(tag_len == 4 && memcmp(tag, "MGMT", 4) == 0) return EvilBw16ResponseMgmt;
+                break;
+            case 'H':
+                if(tag_len == 3 && memcmp(tag, "HOP", 3) == 0) return EvilBw16ResponseChannelHop;
+                break;
+        }
+        return EvilBw16ResponseUnknown;
+    }
+    
+    // Untagged debug output from the Arduino sketch
+    switch(line.data[0]) {
+        case 'R':
+            if(evil_bw16_line_starts_with(line, "RAW UART RX:") ||
+               evil_bw16_line_starts_with(line, "Received Command:")) {
+                return EvilBw16ResponseDebug;
+            }
+            break;
+        case 'S':
+            if(evil_bw16_line_starts_with(line, "SCAN COMMAND")) return EvilBw16ResponseDebug;
+            break;
+    }
+    
+    return EvilBw16ResponseUnknown;
+}
+
+// Split the last tab-separated field off rest, skipping empty fields and padding
+static bool scan_take_last_field(EvilBw16LineView* rest, EvilBw16LineView* field) {
+    size_t end = rest->len;
+    while(end > 0 && (rest->data[end - 1] == '\t' || rest->data[end - 1] == ' ')) end--;
+    if(end == 0) return false;
+    
+    size_t start = end;
+    while(start > 0 && rest->data[start - 1] != '\t') start--;
+    *field = evil_bw16_line_view(rest->data + start, end - start);
+    rest->len = start;
+    return true;
+}
+
+static int scan_hex_digit(char c) {
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// "AA:BB:CC:DD:EE:FF" to its six bytes
+static bool scan_parse_bssid(EvilBw16LineView field, uint8_t* bssid) {
+    if(field.len != EVIL_BW16_BSSID_STR_LEN - 1) return false;
+    for(size_t i = 0; i < 6; i++) {
+        const int high = scan_hex_digit(field.data[i * 3]);
+        const int low = scan_hex_digit(field.data[i * 3 + 1]);
+        if(high < 0 || low < 0 || (i < 5 && field.data[i * 3 + 2] != ':')) return false;
+        bssid[i] = (uint8_t)(high << 4 | low);
+    }
+    return true;
+}
+
+// Parse one scan result line straight into network, e.g.
+//   [INFO] 0\tfirst home\t\t11:22:33:44:55:66\t\t6\t-45\t2.4GHz
+// The index comes off the front and the fixed-format fields (band, RSSI, channel, BSSID)
+// off the back, so whatever lies between is the SSID: it may be empty or contain spaces
+// and tabs, and the firmware's double tabs are just padding. The frequency field is
+// optional; without it the band follows from the channel. Sets everything but the SSID
+// offset and selected, points ssid at the SSID inside line, and returns false if the line
+// is not a scan result.
+bool evil_bw16_parse_scan_result(EvilBw16LineView line, EvilBw16Network* network, EvilBw16LineView* ssid) {
+    if(!line.data || !network || !ssid) return false;
+    
+    if(evil_bw16_line_starts_with(line, "[INFO] ")) {
+        line = evil_bw16_line_skip(line, 7);
+    }
+    while(line.len > 0 && (line.data[line.len - 1] == '\r' || line.data[line.len - 1] == '\n')) line.len--;
+    
+    const char* tab = memchr(line.data, '\t', line.len);
+    if(!tab) return false;
+    
+    int device_index;
+    if(!evil_bw16_line_parse_int(evil_bw16_line_view(line.data, tab - line.data), &device_index)) return false;
+    
+    EvilBw16LineView rest = evil_bw16_line_skip(line, tab - line.data + 1);
+    EvilBw16LineView band = {0}, rssi, channel, bssid;
+    uint8_t bssid_bytes[6];
+    if(!scan_take_last_field(&rest, &rssi)) return false;
+    if(evil_bw16_line_contains(rssi, "GHz")) {
+        band = rssi;
+        if(!scan_take_last_field(&rest, &rssi)) return false;
+    }
+    if(!scan_take_last_field(&rest, &channel) || !scan_take_last_field(&rest, &bssid) || !scan_parse_bssid(bssid, bssid_bytes)) {
+        return false;
+    }
+    
+    int channel_value, rssi_value;
+    if(!evil_bw16_line_parse_int(channel, &channel_value) || !evil_bw16_line_parse_int(rssi, &rssi_value)) return false;
+    
+    // What is left is the SSID between its separating tabs
+    while(rest.len > 0 && rest.data[rest.len - 1] == '\t') rest.len--;
+    while(rest.len > 0 && rest.data[0] == '\t') rest = evil_bw16_line_skip(rest, 1);
+    
+    *ssid = rest;
+    network->device_index = device_index;
+    memcpy(network->bssid, bssid_bytes, sizeof(network->bssid));
+    network->channel = (uint8_t)CLAMP(channel_value, UINT8_MAX, 0);
+    network->rssi = (int8_t)CLAMP(rssi_value, INT8_MAX, INT8_MIN);
+    if(band.len > 0) {
+        network->band = evil_bw16_line_contains(band, "5GHz") ? EvilBw16Band5GHz : EvilBw16Band24GHz;
+    } else {
+        network->band = channel_value >= 36 ? EvilBw16Band5GHz : EvilBw16Band24GHz;
+    }
+    return true;
+}
+
+// Line view helpers
+const char* evil_bw16_line_find(EvilBw16LineView line, const char* needle, size_t needle_len) {
+    if(needle_len == 0) return line.data;
+    if(needle_len > line.len) return NULL;
+    
+    // memchr for the first byte, then confirm the rest
+    const char* p = line.data;
+    const char* last = line.data + line.len - needle_len;
+    while(p <= last) {
+        p = memchr(p, needle[0], last - p + 1);
+        if(!p) return NULL;
+        if(memcmp(p + 1, needle + 1, needle_len - 1) == 0) return p;
+        p++;
+    }
+    return NULL;
+}
+
+bool evil_bw16_line_next_field(EvilBw16LineView* rest, char separator, EvilBw16LineView* field) {
+    if(!rest->data || rest->len == 0) return false;
+    
+    const char* sep = memchr(rest->data, separator, rest->len);
+    if(sep) {
+        *field = evil_bw16_line_view(rest->data, sep - rest->data);
+        *rest = evil_bw16_line_skip(*rest, field->len + 1);
+    } else {
+        *field = *rest;
+        *rest = evil_bw16_line_view(rest->data + rest->len, 0);
+    }
+    return true;
+}
+
+// False when there are no digits or the number does not fit an int
+bool evil_bw16_line_parse_int(EvilBw16LineView field, int* value) {
+    size_t i = 0;
+    while(i < field.len && field.data[i] == ' ') i++;
+    
+    bool negative = false;
+    if(i < field.len && (field.data[i] == '-' || field.data[i] == '+')) {
+        negative = (field.data[i] == '-');
+        i++;
+    }
+    
+    // Accumulated negative, which also has room for INT_MIN
+    int result = 0;
+    size_t digits = 0;
+    while(i < field.len && field.data[i] >= '0' && field.data[i] <= '9') {
+        const int digit = field.data[i] - '0';
+        if(result < (INT_MIN + digit) / 10) return false;
+        result = result * 10 - digit;
+        i++;
+        digits++;
+    }
+    if(!negative && result == INT_MIN) return false;
+    
+    *value = negative ? result : -result;
+    return digits > 0;
+}
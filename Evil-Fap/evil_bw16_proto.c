@@ -0,0 +1,248 @@
+#include "evil_bw16_proto.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// See evil_bw16_proto.h for the frame layout
+
+#define SCAN_RESULT_FIXED_LEN (10)  // index, channel, rssi, band, bssid
+#define FRAME_INFO_LEN (4)          // flags, subtype, channel, rssi
+#define FRAME_FLAG_DATA (1 << 0)
+#define FRAME_FLAG_EAPOL (1 << 1)
+
+typedef enum {
+    DecoderStateSync1,
+    DecoderStateSync2,
+    DecoderStateLen,
+    DecoderStateType,
+    DecoderStatePayload,
+    DecoderStateCrc1,
+    DecoderStateCrc2,
+} DecoderState;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), four bits at a time
+static const uint16_t crc16_nibble_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t evil_bw16_proto_crc16(uint16_t crc, const uint8_t* data, size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        crc = (uint16_t)(crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ crc16_nibble_table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+static inline uint16_t crc16_byte(uint16_t crc, uint8_t byte) {
+    return evil_bw16_proto_crc16(crc, &byte, 1);
+}
+
+size_t evil_bw16_proto_encode(uint8_t type, const uint8_t* payload, size_t len, uint8_t* out, size_t out_size) {
+    if(len > EVIL_BW16_PROTO_MAX_PAYLOAD || out_size < len + EVIL_BW16_PROTO_OVERHEAD) return 0;
+
+    out[0] = EVIL_BW16_PROTO_SYNC1;
+    out[1] = EVIL_BW16_PROTO_SYNC2;
+    out[2] = (uint8_t)len;
+    out[3] = type;
+    if(len) memcpy(out + 4, payload, len);
+
+    const uint16_t crc = evil_bw16_proto_crc16(0xFFFF, out + 2, len + 2);
+    out[4 + len] = (uint8_t)crc;
+    out[5 + len] = (uint8_t)(crc >> 8);
+    return len + EVIL_BW16_PROTO_OVERHEAD;
+}
+
+size_t evil_bw16_proto_encode_scan_result(const EvilBw16ProtoScanResult* result, uint8_t* out, size_t out_size) {
+    uint8_t payload[SCAN_RESULT_FIXED_LEN + EVIL_BW16_PROTO_SSID_MAX];
+    const size_t ssid_len = result->ssid_len > EVIL_BW16_PROTO_SSID_MAX ? EVIL_BW16_PROTO_SSID_MAX : result->ssid_len;
+
+    payload[0] = result->index;
+    payload[1] = result->channel;
+    payload[2] = (uint8_t)result->rssi;
+    payload[3] = result->band_5ghz ? 1 : 0;
+    memcpy(payload + 4, result->bssid, 6);
+    memcpy(payload + SCAN_RESULT_FIXED_LEN, result->ssid, ssid_len);
+
+    return evil_bw16_proto_encode(EvilBw16ProtoTypeScanResult, payload, SCAN_RESULT_FIXED_LEN + ssid_len, out, out_size);
+}
+
+size_t evil_bw16_proto_encode_frame_info(const EvilBw16ProtoFrameInfo* info, uint8_t* out, size_t out_size) {
+    const uint8_t payload[FRAME_INFO_LEN] = {
+        (info->data ? FRAME_FLAG_DATA : 0) | (info->eapol ? FRAME_FLAG_EAPOL : 0),
+        info->subtype,
+        info->channel,
+        (uint8_t)info->rssi,
+    };
+    return evil_bw16_proto_encode(EvilBw16ProtoTypeFrame, payload, sizeof(payload), out, out_size);
+}
+
+bool evil_bw16_proto_parse_scan_result(const uint8_t* payload, size_t len, EvilBw16ProtoScanResult* result) {
+    if(len < SCAN_RESULT_FIXED_LEN || len > SCAN_RESULT_FIXED_LEN + EVIL_BW16_PROTO_SSID_MAX) return false;
+
+    result->index = payload[0];
+    result->channel = payload[1];
+    result->rssi = (int8_t)payload[2];
+    result->band_5ghz = payload[3] != 0;
+    memcpy(result->bssid, payload + 4, 6);
+    result->ssid_len = (uint8_t)(len - SCAN_RESULT_FIXED_LEN);
+    memcpy(result->ssid, payload + SCAN_RESULT_FIXED_LEN, result->ssid_len);
+    result->ssid[result->ssid_len] = '\0';
+    return true;
+}
+
+bool evil_bw16_proto_parse_frame_info(const uint8_t* payload, size_t len, EvilBw16ProtoFrameInfo* info) {
+    if(len != FRAME_INFO_LEN) return false;
+
+    info->data = payload[0] & FRAME_FLAG_DATA;
+    info->eapol = payload[0] & FRAME_FLAG_EAPOL;
+    info->subtype = payload[1];
+    info->channel = payload[2];
+    info->rssi = (int8_t)payload[3];
+    return true;
+}
+
+void evil_bw16_proto_decoder_init(EvilBw16ProtoDecoder* decoder) {
+    memset(decoder, 0, sizeof(EvilBw16ProtoDecoder));
+    decoder->state = DecoderStateSync1;
+}
+
+// Drop a partial frame and hunt for the next sync, keeping the counters
+void evil_bw16_proto_decoder_reset(EvilBw16ProtoDecoder* decoder) {
+    decoder->state = DecoderStateSync1;
+    decoder->pos = 0;
+}
+
+size_t evil_bw16_proto_decoder_feed(EvilBw16ProtoDecoder* decoder, const uint8_t* data, size_t len, bool* frame) {
+    size_t i = 0;
+    *frame = false;
+
+    while(i < len) {
+        const uint8_t byte = data[i];
+
+        switch(decoder->state) {
+            case DecoderStateSync1:
+                if(byte == EVIL_BW16_PROTO_SYNC1) {
+                    decoder->state = DecoderStateSync2;
+                } else {
+                    decoder->skipped++;
+                }
+                i++;
+                break;
+
+            case DecoderStateSync2:
+                if(byte == EVIL_BW16_PROTO_SYNC2) {
+                    decoder->state = DecoderStateLen;
+                    i++;
+                } else {
+                    // Not a frame start; this byte may begin the next sync
+                    decoder->skipped++;
+                    decoder->state = DecoderStateSync1;
+                }
+                break;
+
+            case DecoderStateLen:
+                decoder->len = byte;
+                decoder->crc = crc16_byte(0xFFFF, byte);
+                decoder->state = DecoderStateType;
+                i++;
+                break;
+
+            case DecoderStateType:
+                decoder->type = byte;
+                decoder->crc = crc16_byte(decoder->crc, byte);
+                decoder->pos = 0;
+                decoder->state = decoder->len ? DecoderStatePayload : DecoderStateCrc1;
+                i++;
+                break;
+
+            case DecoderStatePayload: {
+                // Copy as much of the payload as this block holds in one go
+                size_t count = decoder->len - decoder->pos;
+                if(count > len - i) count = len - i;
+                memcpy(decoder->payload + decoder->pos, data + i, count);
+                decoder->crc = evil_bw16_proto_crc16(decoder->crc, data + i, count);
+                decoder->pos += count;
+                i += count;
+                if(decoder->pos == decoder->len) decoder->state = DecoderStateCrc1;
+                break;
+            }
+
+            case DecoderStateCrc1:
+                decoder->crc_rx = byte;
+                decoder->state = DecoderStateCrc2;
+                i++;
+                break;
+
+            case DecoderStateCrc2:
+                decoder->crc_rx |= (uint16_t)byte << 8;
+                decoder->state = DecoderStateSync1;
+                i++;
+                if(decoder->crc_rx == decoder->crc) {
+                    __atomic_store_n(&decoder->frames, decoder->frames + 1, __ATOMIC_RELAXED);
+                    *frame = true;
+                    return i;
+                }
+                __atomic_store_n(&decoder->crc_errors, decoder->crc_errors + 1, __ATOMIC_RELAXED);
+                break;
+        }
+    }
+
+    return i;
+}
+
+// Small xorshift so the stand-in produces the same networks for the same seed
+static uint32_t standin_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void evil_bw16_proto_standin_network(uint32_t seed, uint8_t index, EvilBw16ProtoScanResult* result) {
+    static const char* const names[] = {
+        "HomeNetwork", "FRITZ!Box 7590", "Vodafone-5G", "eduroam", "Starbucks WiFi",
+        "NETGEAR42", "TP-Link_Guest", "DIRECT-printer", "linksys", "Office",
+    };
+    static const uint8_t channels_5ghz[] = {36, 40, 44, 48, 52, 100, 116, 149, 157, 161};
+
+    uint32_t state = (seed ^ 0x9E3779B9UL) + index * 0x85EBCA6BUL;
+    if(state == 0) state = 1;
+
+    memset(result, 0, sizeof(EvilBw16ProtoScanResult));
+    result->index = index;
+    result->band_5ghz = standin_next(&state) % 3 == 0;
+    result->channel = result->band_5ghz ? channels_5ghz[standin_next(&state) % sizeof(channels_5ghz)] :
+                                          (uint8_t)(1 + standin_next(&state) % 13);
+    result->rssi = (int8_t)(-30 - (int)(standin_next(&state) % 60));
+    for(size_t i = 0; i < 6; i++) {
+        result->bssid[i] = (uint8_t)standin_next(&state);
+    }
+    result->bssid[0] &= 0xFE;  // Unicast
+
+    const char* name = names[standin_next(&state) % (sizeof(names) / sizeof(names[0]))];
+    const int len = snprintf(result->ssid, sizeof(result->ssid), "%s-%02X", name, result->bssid[5]);
+    result->ssid_len = (uint8_t)(len < (int)sizeof(result->ssid) ? len : (int)sizeof(result->ssid) - 1);
+}
+
+// The scan line the text firmware prints for this network, including its line end
+size_t evil_bw16_proto_format_scan_text(const EvilBw16ProtoScanResult* result, char* out, size_t out_size) {
+    const int len = snprintf(
+        out,
+        out_size,
+        "[INFO] %u\t%s\t%02X:%02X:%02X:%02X:%02X:%02X\t%u\t%d\t%s\n",
+        result->index,
+        result->ssid,
+        result->bssid[0],
+        result->bssid[1],
+        result->bssid[2],
+        result->bssid[3],
+        result->bssid[4],
+        result->bssid[5],
+        result->channel,
+        result->rssi,
+        result->band_5ghz ? "5GHz" : "2.4GHz");
+    return (len < 0 || (size_t)len >= out_size) ? 0 : (size_t)len;
+}
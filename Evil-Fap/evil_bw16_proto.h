@@ -0,0 +1,84 @@
+#pragma once
+
+// Binary framing for BW16 -> Flipper output.
+//
+// Kept free of furi so the same encoder/decoder builds on the BW16 side and on a
+// desktop. Every frame is:
+//
+//   0xA5 0x5A | len (payload bytes) | type | payload | CRC-16/CCITT-FALSE LE
+//
+// with the CRC over len, type and payload. Commands to the BW16 stay plain text; the
+// BW16 only frames its output after acknowledging "set proto binary".
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EVIL_BW16_PROTO_SYNC1 (0xA5)
+#define EVIL_BW16_PROTO_SYNC2 (0x5A)
+#define EVIL_BW16_PROTO_MAX_PAYLOAD (255)
+#define EVIL_BW16_PROTO_OVERHEAD (6)  // Sync, len, type, CRC
+#define EVIL_BW16_PROTO_MAX_FRAME (EVIL_BW16_PROTO_MAX_PAYLOAD + EVIL_BW16_PROTO_OVERHEAD)
+#define EVIL_BW16_PROTO_SSID_MAX (32)
+
+typedef enum {
+    EvilBw16ProtoTypeText = 0x01,        // One line of regular text output, no line end
+    EvilBw16ProtoTypeScanResult = 0x02,  // EvilBw16ProtoScanResult
+    EvilBw16ProtoTypeScanDone = 0x03,    // u8 network count
+    EvilBw16ProtoTypeFrame = 0x04,       // EvilBw16ProtoFrameInfo
+} EvilBw16ProtoType;
+
+typedef struct {
+    uint8_t index;  // BW16 device index
+    uint8_t channel;
+    int8_t rssi;
+    bool band_5ghz;
+    uint8_t bssid[6];
+    uint8_t ssid_len;
+    char ssid[EVIL_BW16_PROTO_SSID_MAX + 1];
+} EvilBw16ProtoScanResult;
+
+// A sniffed 802.11 frame; subtype is the frame control subtype field
+typedef struct {
+    bool data;   // Data frame rather than management
+    bool eapol;  // Data frame carrying EAPOL
+    uint8_t subtype;
+    uint8_t channel;
+    int8_t rssi;
+} EvilBw16ProtoFrameInfo;
+
+typedef struct {
+    uint8_t state;
+    uint8_t type;
+    uint8_t len;
+    uint8_t pos;
+    uint16_t crc;
+    uint16_t crc_rx;
+    uint8_t payload[EVIL_BW16_PROTO_MAX_PAYLOAD];
+    // Stored atomically, so other threads may read them with __atomic_load_n()
+    uint32_t frames;      // Good frames decoded
+    uint32_t crc_errors;  // Frames dropped for a bad CRC
+    uint32_t skipped;     // Bytes discarded while looking for a sync
+} EvilBw16ProtoDecoder;
+
+uint16_t evil_bw16_proto_crc16(uint16_t crc, const uint8_t* data, size_t len);
+
+// Encoding, returns the frame size or 0 if it does not fit out_size
+size_t evil_bw16_proto_encode(uint8_t type, const uint8_t* payload, size_t len, uint8_t* out, size_t out_size);
+size_t evil_bw16_proto_encode_scan_result(const EvilBw16ProtoScanResult* result, uint8_t* out, size_t out_size);
+size_t evil_bw16_proto_encode_frame_info(const EvilBw16ProtoFrameInfo* info, uint8_t* out, size_t out_size);
+
+// Payload decoding, false if the payload is malformed
+bool evil_bw16_proto_parse_scan_result(const uint8_t* payload, size_t len, EvilBw16ProtoScanResult* result);
+bool evil_bw16_proto_parse_frame_info(const uint8_t* payload, size_t len, EvilBw16ProtoFrameInfo* info);
+
+// Stream decoding. Consumes bytes up to and including the end of the next good frame
+// and returns how many; *frame tells whether one completed. The frame's type, len and
+// payload stay valid until the next call.
+void evil_bw16_proto_decoder_init(EvilBw16ProtoDecoder* decoder);
+void evil_bw16_proto_decoder_reset(EvilBw16ProtoDecoder* decoder);
+size_t evil_bw16_proto_decoder_feed(EvilBw16ProtoDecoder* decoder, const uint8_t* data, size_t len, bool* frame);
+
+// Device stand-in: deterministic synthetic networks and the firmware's text rendering
+void evil_bw16_proto_standin_network(uint32_t seed, uint8_t index, EvilBw16ProtoScanResult* result);
+size_t evil_bw16_proto_format_scan_text(const EvilBw16ProtoScanResult* result, char* out, size_t out_size);
@@ -0,0 +1,788 @@
+#include "evil_bw16.h"
+#include <storage/storage.h>
+
+#ifdef EVIL_BW16_DEVTOOLS
+
+// Replay benchmark.
+//
+// Streams a recorded BW16 session from the SD card through the real RX path: bytes go
+// into the worker's ring with async RX paused, and are framed, filtered, classified and
+// handled exactly like live traffic. With a baud rate set the bytes are paced the way the
+// wire would deliver them (10 bits per byte at 8N1) and overruns are dropped like in the
+// ISR; at baud 0 the feeder only waits for ring space, which measures the parser ceiling.
+//
+// The source is either a plain text UART log or a binary RX capture (see
+// evil_bw16_capture.c). Captures can also be replayed with their recorded chunk timing.
+//
+// The protocol bench needs no file: it plays the same synthetic scan, from the device
+// stand-in in evil_bw16_proto.c, once as text lines and once as binary frames, and
+// compares bytes on the wire and worker CPU per scan result.
+//
+// The simulator benches drive the simulated BW16 (evil_bw16_sim.c) through the regular
+// command path: one times "scan" until the worker reports the scan complete, the other
+// sniffs at the simulator's frame rate and compares frames offered, sent and counted.
+//
+// The parser bench checks evil_bw16_parse_scan_result() against a corpus of scan lines
+// in the shapes the firmware prints, then times it on its own, outside the RX path.
+
+#define REPLAY_FILE_PATH EXT_PATH("apps_data/evil_bw16_replay.txt")
+#define REPLAY_CHUNK_SIZE (256)
+#define REPLAY_DRAIN_TIMEOUT_MS (2000)
+#define PROTO_BENCH_ROUNDS (4)  // Scans per protocol, each of EVIL_BW16_MAX_NETWORKS results
+#define PROTO_BENCH_SEED (0x5EED)
+#define PROTO_BENCH_HEADER "[INFO] Index\tSSID\tBSSID\tChannel\tRSSI\tFrequency"
+#define PROTO_BENCH_DONE "[INFO] Scan completed"
+#define SIM_BENCH_SCANS (5)
+#define SIM_BENCH_SCAN_TIMEOUT_MS (10000)
+#define SIM_BENCH_SNIFF_MS (5000)
+#define SIM_BENCH_START_TIMEOUT_MS (1000)
+#define PARSER_BENCH_ROUNDS (100)
+#define PARSER_BENCH_MAX_FAILURES (8)  // Corpus lines listed in the report
+
+typedef enum {
+    ReplayKindTextLog,
+    ReplayKindCapture,
+    ReplayKindProtoBench,
+    ReplayKindSimScan,
+    ReplayKindSimSniff,
+    ReplayKindParserBench,
+} ReplayKind;
+
+typedef struct {
+    const char* line;
+    bool valid;
+    uint8_t device_index;
+    const char* ssid;
+    const char* bssid;
+    int channel;
+    int rssi;
+    EvilBw16Band band;
+} ScanCorpusEntry;
+
+// Scan output as the firmware prints it, plus the variations seen on the wire
+static const ScanCorpusEntry scan_corpus[] = {
+    {.line = "[INFO] Index\tSSID\t\tBSSID\t\tChannel\tRSSI (dBm)\tFrequency", .valid = false},
+    {"[INFO] 0\tHomeNetwork\t\t11:22:33:44:55:66\t\t6\t-45\t2.4GHz", true, 0, "HomeNetwork", "11:22:33:44:55:66", 6, -45, EvilBw16Band24GHz},
+    {"[INFO] 1\tfirst home\t\tA4:2B:B0:C1:7E:02\t\t11\t-67\t2.4GHz", true, 1, "first home", "A4:2B:B0:C1:7E:02", 11, -67, EvilBw16Band24GHz},
+    {"[INFO] 2\tFRITZ!Box 7590 XY\t\t3C:A6:2F:11:22:33\t\t36\t-71\t5GHz", true, 2, "FRITZ!Box 7590 XY", "3C:A6:2F:11:22:33", 36, -71, EvilBw16Band5GHz},
+    {"[INFO] 3\t\t\t9E:A6:2F:11:22:34\t\t1\t-80\t2.4GHz", true, 3, "", "9E:A6:2F:11:22:34", 1, -80, EvilBw16Band24GHz},
+    {"[INFO] 4\tOffice\t5C:49:79:00:AB:CD\t149\t-58\t5GHz\r", true, 4, "Office", "5C:49:79:00:AB:CD", 149, -58, EvilBw16Band5GHz},
+    {"[INFO] 5\tCafe\t\t00:11:22:33:44:55\t\t44\t-62", true, 5, "Cafe", "00:11:22:33:44:55", 44, -62, EvilBw16Band5GHz},
+    {"[INFO] 6\tTab\tInside\t\t00:11:22:33:44:56\t\t3\t-50\t2.4GHz", true, 6, "Tab\tInside", "00:11:22:33:44:56", 3, -50, EvilBw16Band24GHz},
+    {"[INFO] 7\t  spaced  \t\t00:11:22:33:44:57\t\t13\t-90\t2.4GHz", true, 7, "  spaced  ", "00:11:22:33:44:57", 13, -90, EvilBw16Band24GHz},
+    {"[INFO] 8\t11:22:33:44:55:66\t\t66:55:44:33:22:11\t\t6\t-40\t2.4GHz", true, 8, "11:22:33:44:55:66", "66:55:44:33:22:11", 6, -40, EvilBw16Band24GHz},
+    {"[INFO] 9\tlowercase\t\taa:bb:cc:dd:ee:ff\t\t165\t-88\t5GHz", true, 9, "lowercase", "AA:BB:CC:DD:EE:FF", 165, -88, EvilBw16Band5GHz},
+    {"[INFO] 10\tABCDEFGHIJKLMNOPQRSTUVWXYZ012345\t\tDE:AD:BE:EF:00:01\t\t9\t-33\t2.4GHz", true, 10, "ABCDEFGHIJKLMNOPQRSTUVWXYZ012345", "DE:AD:BE:EF:00:01", 9, -33, EvilBw16Band24GHz},
+    {"[INFO] 11\tTrailing tabs\t\tDE:AD:BE:EF:00:02\t\t2\t-70\t2.4GHz\t\t", true, 11, "Trailing tabs", "DE:AD:BE:EF:00:02", 2, -70, EvilBw16Band24GHz},
+    {.line = "[INFO] 12\tTruncated\t\t00:11:22:33", .valid = false},
+    {.line = "[INFO] 13\tNoMac\t\tnot-a-bssid-value\t\t6\t-40\t2.4GHz", .valid = false},
+    {.line = "[INFO] 14\tNoRssi\t\t00:11:22:33:44:58\t\t6\t\t2.4GHz", .valid = false},
+    {.line = "[INFO] Scan results printed", .valid = false},
+    {.line = "[INFO] Scan completed", .valid = false},
+};
+
+typedef struct {
+    uint32_t lines;
+    uint32_t passed;
+    uint32_t failures;
+    uint8_t failed[PARSER_BENCH_MAX_FAILURES];  // Corpus indices
+    uint32_t parsed;    // Timed lines, over all rounds
+    uint64_t cycles;
+    uint32_t max_cycles;
+    EvilBw16NetworkTableStats storage;  // Stand-in networks stored at the default budget
+} EvilBw16ParserBench;
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t results;
+    uint32_t elapsed_ms;
+    EvilBw16UartProfile profile;
+} EvilBw16ProtoBenchRun;
+
+typedef struct {
+    uint32_t scans;     // Completed
+    uint32_t timeouts;
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t total_ms;
+    uint32_t bytes;     // Simulated line bytes over all scans
+    uint8_t networks;
+    uint32_t scan_ms;   // Simulated radio time, part of every latency
+} EvilBw16SimScanBench;
+
+typedef struct {
+    uint32_t offered_rate;
+    uint32_t elapsed_ms;
+    uint32_t sent;      // Frames the simulator put on the line
+    uint32_t counted;   // Frames that reached the sniffer counters
+    uint32_t dropped_bytes;
+    EvilBw16UartProfile profile;
+} EvilBw16SimSniffBench;
+
+struct EvilBw16Replay {
+    EvilBw16App* app;
+    FuriThread* thread;
+    ReplayKind kind;
+    bool original_timing;  // Capture only: reproduce the recorded chunk timing
+    uint32_t baud_rate;    // 0 = as fast as the worker keeps up
+    volatile bool stop;
+
+    // Results of the last run
+    bool file_ok;
+    uint32_t bytes;
+    uint32_t dropped_bytes;
+    uint32_t elapsed_ms;
+    EvilBw16UartProfile profile;
+    uint32_t link_baud;             // Benches: rate the wire time is worked out for
+    bool link_binary;               // Simulator benches: framing in use
+    EvilBw16ProtoBenchRun proto[2]; // Protocol bench: text, binary
+    EvilBw16SimScanBench sim_scan;
+    EvilBw16SimSniffBench sim_sniff;
+    EvilBw16ParserBench parser;
+};
+
+// Push one chunk, paced to the configured line rate
+static void replay_feed(EvilBw16Replay* replay, const uint8_t* data, size_t len, uint32_t start_tick) {
+    EvilBw16UartWorker* worker = replay->app->uart_worker;
+    size_t pos = 0;
+
+    while(pos < len && !replay->stop) {
+        size_t count = len - pos;
+        if(replay->baud_rate) {
+            // Bytes the line would have delivered by now
+            const uint32_t due = (uint32_t)((uint64_t)(furi_get_tick() - start_tick) * replay->baud_rate / 10000);
+            if(replay->bytes >= due) {
+                furi_delay_tick(1);
+                continue;
+            }
+            count = MIN(count, (size_t)(due - replay->bytes));
+            evil_bw16_uart_inject_rx(worker, data + pos, count, true);
+        } else {
+            count = evil_bw16_uart_inject_rx(worker, data + pos, count, false);
+            if(count == 0) {
+                furi_delay_tick(1);
+                continue;
+            }
+        }
+        pos += count;
+        replay->bytes += count;
+    }
+}
+
+// Play a capture back chunk by chunk at the moments it was originally received
+static void replay_capture_timed(EvilBw16Replay* replay, EvilBw16CaptureReader* reader, uint32_t start_tick) {
+    EvilBw16UartWorker* worker = replay->app->uart_worker;
+    uint32_t due = start_tick;
+    uint32_t delta;
+    const uint8_t* data;
+    size_t len;
+
+    while(!replay->stop && evil_bw16_capture_reader_next(reader, &delta, &data, &len)) {
+        due += delta;
+        // Sleep in short steps so a stop request is seen quickly
+        while(!replay->stop && (int32_t)(due - furi_get_tick()) > 0) {
+            furi_delay_tick(MIN((uint32_t)(due - furi_get_tick()), 50UL));
+        }
+        evil_bw16_uart_inject_rx(worker, data, len, true);
+        replay->bytes += len;
+    }
+}
+
+// Wait for the worker to handle everything injected so far
+static void replay_wait_drained(EvilBw16UartWorker* worker) {
+    const uint32_t drain_start = furi_get_tick();
+    while(evil_bw16_uart_rx_available(worker) > 0 &&
+          furi_get_tick() - drain_start < REPLAY_DRAIN_TIMEOUT_MS) {
+        furi_delay_tick(1);
+    }
+}
+
+static int32_t replay_thread(void* context) {
+    EvilBw16Replay* replay = context;
+    EvilBw16App* app = replay->app;
+    EvilBw16UartWorker* worker = app->uart_worker;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    EvilBw16CaptureReader* reader = NULL;
+    if(replay->kind == ReplayKindCapture) {
+        reader = evil_bw16_capture_reader_open(EVIL_BW16_CAPTURE_PATH);
+        replay->file_ok = reader != NULL;
+    } else {
+        replay->file_ok = storage_file_open(file, REPLAY_FILE_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    }
+
+    if(replay->file_ok && worker) {
+        uint8_t* chunk = malloc(REPLAY_CHUNK_SIZE);
+
+        evil_bw16_uart_pause_rx(worker, true);
+        const uint32_t dropped_before = evil_bw16_uart_get_dropped_bytes(worker);
+        evil_bw16_uart_profile_start(worker);
+        const uint32_t start = furi_get_tick();
+
+        EVIL_BW16_LOG_I("Replay started (%s)", replay->kind == ReplayKindCapture ? "capture" : "text log");
+
+        if(reader && replay->original_timing) {
+            replay_capture_timed(replay, reader, start);
+        } else if(reader) {
+            uint32_t delta;
+            const uint8_t* data;
+            size_t len;
+            while(!replay->stop && evil_bw16_capture_reader_next(reader, &delta, &data, &len)) {
+                replay_feed(replay, data, len, start);
+            }
+        } else {
+            while(!replay->stop) {
+                const size_t len = storage_file_read(file, chunk, REPLAY_CHUNK_SIZE);
+                if(len == 0) break;
+                replay_feed(replay, chunk, len, start);
+            }
+        }
+
+        // Terminate a trailing partial line, then let the worker drain the ring
+        evil_bw16_uart_inject_rx(worker, (const uint8_t*)"\n", 1, false);
+        replay_wait_drained(worker);
+
+        replay->elapsed_ms = furi_get_tick() - start;
+        evil_bw16_uart_profile_stop(worker, &replay->profile);
+        replay->dropped_bytes = evil_bw16_uart_get_dropped_bytes(worker) - dropped_before;
+        evil_bw16_uart_pause_rx(worker, false);
+
+        EVIL_BW16_LOG_I("Replay done: %lu bytes, %lu lines in %lu ms",
+                        replay->bytes, replay->profile.lines, replay->elapsed_ms);
+
+        free(chunk);
+    } else {
+        EVIL_BW16_LOG_W("Replay source not available");
+    }
+
+    evil_bw16_capture_reader_close(reader);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!replay->stop) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, EvilBw16EventReplayDone);
+    }
+    return 0;
+}
+
+// Play PROTO_BENCH_ROUNDS synthetic scans in one framing and profile the worker
+static void proto_bench_run(EvilBw16Replay* replay, bool binary, EvilBw16ProtoBenchRun* run) {
+    EvilBw16UartWorker* worker = replay->app->uart_worker;
+    uint8_t frame[EVIL_BW16_PROTO_MAX_FRAME];
+    EvilBw16ProtoScanResult network;
+    size_t len;
+
+    evil_bw16_uart_force_protocol(worker, binary);
+    replay->bytes = 0;
+    evil_bw16_uart_profile_start(worker);
+    const uint32_t start = furi_get_tick();
+
+    for(uint32_t round = 0; round < PROTO_BENCH_ROUNDS && !replay->stop; round++) {
+        // The header clears the previous results in both framings
+        if(binary) {
+            len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)PROTO_BENCH_HEADER,
+                                         strlen(PROTO_BENCH_HEADER), frame, sizeof(frame));
+        } else {
+            len = snprintf((char*)frame, sizeof(frame), "%s\n", PROTO_BENCH_HEADER);
+        }
+        replay_feed(replay, frame, len, start);
+
+        for(uint8_t i = 0; i < EVIL_BW16_MAX_NETWORKS && !replay->stop; i++) {
+            evil_bw16_proto_standin_network(PROTO_BENCH_SEED, i, &network);
+            if(binary) {
+                len = evil_bw16_proto_encode_scan_result(&network, frame, sizeof(frame));
+            } else {
+                len = evil_bw16_proto_format_scan_text(&network, (char*)frame, sizeof(frame));
+            }
+            replay_feed(replay, frame, len, start);
+            run->results++;
+        }
+
+        if(binary) {
+            const uint8_t count = EVIL_BW16_MAX_NETWORKS;
+            len = evil_bw16_proto_encode(EvilBw16ProtoTypeScanDone, &count, 1, frame, sizeof(frame));
+        } else {
+            len = snprintf((char*)frame, sizeof(frame), "%s\n", PROTO_BENCH_DONE);
+        }
+        replay_feed(replay, frame, len, start);
+    }
+
+    replay_wait_drained(worker);
+    run->elapsed_ms = furi_get_tick() - start;
+    evil_bw16_uart_profile_stop(worker, &run->profile);
+    run->bytes = replay->bytes;
+}
+
+static int32_t proto_bench_thread(void* context) {
+    EvilBw16Replay* replay = context;
+    EvilBw16App* app = replay->app;
+    EvilBw16UartWorker* worker = app->uart_worker;
+    const bool was_binary = evil_bw16_uart_is_binary(worker);
+
+    replay->link_baud = evil_bw16_uart_get_baud_rate(worker);
+    evil_bw16_uart_pause_rx(worker, true);
+    // Whatever arrived before the pause is handled in the framing it was sent in
+    replay_wait_drained(worker);
+
+    EVIL_BW16_LOG_I("Protocol bench started");
+    proto_bench_run(replay, false, &replay->proto[0]);
+    if(!replay->stop) proto_bench_run(replay, true, &replay->proto[1]);
+    replay->file_ok = !replay->stop;
+
+    evil_bw16_uart_force_protocol(worker, was_binary);
+    evil_bw16_uart_pause_rx(worker, false);
+    EVIL_BW16_LOG_I("Protocol bench done: text %lu B, binary %lu B",
+                    replay->proto[0].bytes, replay->proto[1].bytes);
+
+    if(!replay->stop) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, EvilBw16EventReplayDone);
+    }
+    return 0;
+}
+
+// Time "scan" to the worker's scan completion, SIM_BENCH_SCANS times
+static void sim_bench_scan(EvilBw16Replay* replay) {
+    EvilBw16App* app = replay->app;
+    EvilBw16SimScanBench* bench = &replay->sim_scan;
+    EvilBw16SimStats before, after;
+
+    bench->networks = evil_bw16_sim_get_network_count(app->simulator);
+    bench->scan_ms = evil_bw16_sim_get_scan_ms(app->simulator);
+    bench->min_ms = UINT32_MAX;
+    evil_bw16_sim_get_stats(app->simulator, &before);
+
+    for(uint32_t i = 0; i < SIM_BENCH_SCANS && !replay->stop; i++) {
+        // The worker clears the flag when the scan completes
+        app->scan_in_progress = true;
+        const uint32_t start = furi_get_tick();
+        evil_bw16_send_command(app, "scan");
+        while(app->scan_in_progress && !replay->stop && furi_get_tick() - start < SIM_BENCH_SCAN_TIMEOUT_MS) {
+            furi_delay_tick(1);
+        }
+        if(replay->stop) break;
+        if(app->scan_in_progress) {
+            bench->timeouts++;
+            continue;
+        }
+
+        const uint32_t latency = furi_get_tick() - start;
+        bench->scans++;
+        bench->total_ms += latency;
+        bench->min_ms = MIN(bench->min_ms, latency);
+        bench->max_ms = MAX(bench->max_ms, latency);
+    }
+
+    evil_bw16_sim_get_stats(app->simulator, &after);
+    bench->bytes = after.bytes - before.bytes;
+}
+
+// Sniff at the simulator's frame rate for SIM_BENCH_SNIFF_MS
+static void sim_bench_sniff(EvilBw16Replay* replay) {
+    EvilBw16App* app = replay->app;
+    EvilBw16UartWorker* worker = app->uart_worker;
+    EvilBw16SimSniffBench* bench = &replay->sim_sniff;
+    EvilBw16SimStats sim_before, sim_after;
+
+    bench->offered_rate = evil_bw16_sim_get_frame_rate(app->simulator);
+    const uint32_t dropped_before = evil_bw16_uart_get_dropped_bytes(worker);
+
+    // Counters restart when the BW16 confirms the mode
+    app->sniffer_state.is_running = false;
+    evil_bw16_send_command(app, "sniff all");
+    const uint32_t wait_start = furi_get_tick();
+    while(!app->sniffer_state.is_running && !replay->stop &&
+          furi_get_tick() - wait_start < SIM_BENCH_START_TIMEOUT_MS) {
+        furi_delay_tick(1);
+    }
+
+    evil_bw16_uart_profile_start(worker);
+    evil_bw16_sim_get_stats(app->simulator, &sim_before);
+    const uint32_t counted_before = app->sniffer_counters.total;
+    const uint32_t start = furi_get_tick();
+
+    while(!replay->stop && furi_get_tick() - start < SIM_BENCH_SNIFF_MS) {
+        furi_delay_tick(50);
+    }
+
+    bench->elapsed_ms = furi_get_tick() - start;
+    bench->counted = app->sniffer_counters.total - counted_before;
+    evil_bw16_sim_get_stats(app->simulator, &sim_after);
+    bench->sent = sim_after.frames - sim_before.frames;
+    evil_bw16_uart_profile_stop(worker, &bench->profile);
+
+    evil_bw16_send_command(app, "sniff stop");
+    bench->dropped_bytes = evil_bw16_uart_get_dropped_bytes(worker) - dropped_before;
+}
+
+static int32_t sim_bench_thread(void* context) {
+    EvilBw16Replay* replay = context;
+    EvilBw16App* app = replay->app;
+
+    // Borrow the simulator if it is not already standing in for the BW16
+    const bool started_here = !evil_bw16_sim_is_running(app->simulator);
+    if(started_here) evil_bw16_sim_start(app->simulator);
+
+    replay->link_baud = evil_bw16_uart_get_baud_rate(app->uart_worker);
+    replay->link_binary = evil_bw16_uart_is_binary(app->uart_worker);
+    EVIL_BW16_LOG_I("Simulator bench started");
+
+    if(replay->kind == ReplayKindSimScan) {
+        sim_bench_scan(replay);
+    } else {
+        sim_bench_sniff(replay);
+    }
+    replay->file_ok = !replay->stop;
+
+    if(started_here) evil_bw16_sim_stop(app->simulator);
+    EVIL_BW16_LOG_I("Simulator bench done");
+
+    if(!replay->stop) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, EvilBw16EventReplayDone);
+    }
+    return 0;
+}
+
+static bool parser_bench_check(const ScanCorpusEntry* entry) {
+    EvilBw16Network network;
+    EvilBw16LineView ssid;
+    memset(&network, 0, sizeof(network));
+    const bool valid = evil_bw16_parse_scan_result(evil_bw16_line_view(entry->line, strlen(entry->line)), &network, &ssid);
+    if(valid != entry->valid) return false;
+    if(!valid) return true;
+    
+    char bssid[EVIL_BW16_BSSID_STR_LEN];
+    evil_bw16_format_bssid(network.bssid, bssid);
+    return network.device_index == entry->device_index && ssid.len == strlen(entry->ssid) &&
+           memcmp(ssid.data, entry->ssid, ssid.len) == 0 &&
+           strcmp(bssid, entry->bssid) == 0 && network.channel == entry->channel &&
+           network.rssi == entry->rssi && network.band == entry->band;
+}
+
+static inline void parser_bench_time(EvilBw16ParserBench* bench, const char* line, size_t len) {
+    EvilBw16Network network;
+    EvilBw16LineView ssid;
+    // DWT cycle counter, as in the worker's profiler
+    const uint32_t start = furi_hal_cortex_timer_get(0).start;
+    evil_bw16_parse_scan_result(evil_bw16_line_view(line, len), &network, &ssid);
+    const uint32_t cycles = furi_hal_cortex_timer_get(0).start - start;
+    
+    bench->parsed++;
+    bench->cycles += cycles;
+    bench->max_cycles = MAX(bench->max_cycles, cycles);
+}
+
+// Check the corpus, then time the corpus and a stand-in scan PARSER_BENCH_ROUNDS times
+static int32_t parser_bench_thread(void* context) {
+    EvilBw16Replay* replay = context;
+    EvilBw16ParserBench* bench = &replay->parser;
+    char text[96];
+    EvilBw16ProtoScanResult result;
+
+    for(uint8_t i = 0; i < COUNT_OF(scan_corpus); i++) {
+        bench->lines++;
+        if(parser_bench_check(&scan_corpus[i])) {
+            bench->passed++;
+        } else {
+            if(bench->failures < PARSER_BENCH_MAX_FAILURES) bench->failed[bench->failures] = i;
+            bench->failures++;
+            EVIL_BW16_LOG_W("Scan corpus line %u failed", i);
+        }
+    }
+
+    const uint32_t start = furi_get_tick();
+    for(uint32_t round = 0; round < PARSER_BENCH_ROUNDS && !replay->stop; round++) {
+        for(size_t i = 0; i < COUNT_OF(scan_corpus); i++) {
+            parser_bench_time(bench, scan_corpus[i].line, strlen(scan_corpus[i].line));
+        }
+        for(uint8_t i = 0; i < EVIL_BW16_MAX_NETWORKS; i++) {
+            evil_bw16_proto_standin_network(PROTO_BENCH_SEED, i, &result);
+            const size_t len = evil_bw16_proto_format_scan_text(&result, text, sizeof(text));
+            parser_bench_time(bench, text, len);
+        }
+    }
+    replay->elapsed_ms = furi_get_tick() - start;
+
+    // Fill a scratch scan list at the default budget to see what a network costs
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    for(uint16_t i = 0; i < EVIL_BW16_NETWORK_TABLE_MAX && !replay->stop; i++) {
+        evil_bw16_proto_standin_network(PROTO_BENCH_SEED, i, &result);
+        EvilBw16Network network = {
+            .device_index = (uint8_t)i,
+            .channel = result.channel,
+            .rssi = result.rssi,
+            .band = result.band_5ghz ? EvilBw16Band5GHz : EvilBw16Band24GHz,
+        };
+        memcpy(network.bssid, result.bssid, sizeof(network.bssid));
+        if(evil_bw16_network_table_upsert(table, &network, evil_bw16_line_view(result.ssid, result.ssid_len), NULL) ==
+           EVIL_BW16_NETWORK_NONE) {
+            break;
+        }
+    }
+    evil_bw16_network_table_get_stats(table, &bench->storage);
+    evil_bw16_network_table_free(table);
+    replay->file_ok = !replay->stop;
+
+    if(!replay->stop) {
+        view_dispatcher_send_custom_event(replay->app->view_dispatcher, EvilBw16EventReplayDone);
+    }
+    return 0;
+}
+
+EvilBw16Replay* evil_bw16_replay_alloc(EvilBw16App* app) {
+    EvilBw16Replay* replay = malloc(sizeof(EvilBw16Replay));
+    memset(replay, 0, sizeof(EvilBw16Replay));
+    replay->app = app;
+    return replay;
+}
+
+void evil_bw16_replay_free(EvilBw16Replay* replay) {
+    if(!replay) return;
+    evil_bw16_replay_stop(replay);
+    free(replay);
+}
+
+static bool replay_start(EvilBw16Replay* replay, FuriThreadCallback callback) {
+    // Only the parser bench leaves the UART alone
+    if(replay->kind != ReplayKindParserBench) {
+        if(!replay->app->uart_worker) return false;
+        // Replays and the simulator would both feed the ring
+        if(replay->kind != ReplayKindSimScan && replay->kind != ReplayKindSimSniff &&
+           evil_bw16_sim_is_running(replay->app->simulator)) {
+            return false;
+        }
+    }
+
+    // Close a recording in progress so the capture file is complete before it is read
+    evil_bw16_uart_capture_stop(replay->app->uart_worker);
+
+    replay->stop = false;
+    replay->file_ok = false;
+    replay->bytes = 0;
+    replay->dropped_bytes = 0;
+    replay->elapsed_ms = 0;
+    memset(&replay->profile, 0, sizeof(replay->profile));
+    memset(replay->proto, 0, sizeof(replay->proto));
+    memset(&replay->sim_scan, 0, sizeof(replay->sim_scan));
+    memset(&replay->sim_sniff, 0, sizeof(replay->sim_sniff));
+    memset(&replay->parser, 0, sizeof(replay->parser));
+
+    replay->thread = furi_thread_alloc_ex("EvilBw16Replay", 2048, callback, replay);
+    furi_thread_start(replay->thread);
+    return true;
+}
+
+// Replay the text log, paced at baud_rate (0 = max speed)
+bool evil_bw16_replay_start(EvilBw16Replay* replay, uint32_t baud_rate) {
+    if(!replay || replay->thread) return false;
+    replay->kind = ReplayKindTextLog;
+    replay->original_timing = false;
+    replay->baud_rate = baud_rate;
+    return replay_start(replay, replay_thread);
+}
+
+// Replay the RX capture, either with its recorded timing or as fast as possible
+bool evil_bw16_replay_start_capture(EvilBw16Replay* replay, bool original_timing) {
+    if(!replay || replay->thread) return false;
+    replay->kind = ReplayKindCapture;
+    replay->original_timing = original_timing;
+    replay->baud_rate = 0;
+    return replay_start(replay, replay_thread);
+}
+
+// Compare the text and binary protocol on a synthetic scan. This replaces the scan list.
+bool evil_bw16_replay_start_proto_bench(EvilBw16Replay* replay) {
+    if(!replay || replay->thread) return false;
+    replay->kind = ReplayKindProtoBench;
+    replay->original_timing = false;
+    replay->baud_rate = 0;
+    return replay_start(replay, proto_bench_thread);
+}
+
+// Measure scan latency (sniff false) or sniffer throughput against the simulated BW16
+bool evil_bw16_replay_start_sim_bench(EvilBw16Replay* replay, bool sniff) {
+    if(!replay || replay->thread || !replay->app->simulator) return false;
+    replay->kind = sniff ? ReplayKindSimSniff : ReplayKindSimScan;
+    replay->original_timing = false;
+    replay->baud_rate = 0;
+    return replay_start(replay, sim_bench_thread);
+}
+
+// Check and time the scan line parser; touches neither the UART nor the scan list
+bool evil_bw16_replay_start_parser_bench(EvilBw16Replay* replay) {
+    if(!replay || replay->thread) return false;
+    replay->kind = ReplayKindParserBench;
+    replay->original_timing = false;
+    replay->baud_rate = 0;
+    return replay_start(replay, parser_bench_thread);
+}
+
+// Abort a run in progress (if any) and wait for the feeder to hand RX back
+void evil_bw16_replay_stop(EvilBw16Replay* replay) {
+    if(!replay || !replay->thread) return;
+    replay->stop = true;
+    furi_thread_join(replay->thread);
+    furi_thread_free(replay->thread);
+    replay->thread = NULL;
+}
+
+static void proto_bench_format_run(const char* name, const EvilBw16ProtoBenchRun* run, uint32_t baud, FuriString* out) {
+    const uint32_t results = MAX(run->results, 1UL);
+    const uint32_t cpi = furi_hal_cortex_instructions_per_microsecond();
+
+    furi_string_cat_printf(out, "=== %s ===\n", name);
+    furi_string_cat_printf(out, "Bytes: %lu\n", run->bytes);
+    furi_string_cat_printf(out, "Bytes/result: %lu\n", run->bytes / results);
+    if(baud) {
+        // 10 bits per byte at 8N1
+        furi_string_cat_printf(out, "Wire/result: %lu us\n", (uint32_t)((uint64_t)run->bytes * 10000000 / baud / results));
+    }
+    furi_string_cat_printf(out, "CPU/result: %lu us\n", (uint32_t)(run->profile.cycles / results / cpi));
+    furi_string_cat_printf(out, "p99: %lu us\n", evil_bw16_profile_percentile_us(&run->profile, 99));
+    furi_string_cat_printf(out, "Time: %lu ms\n\n", run->elapsed_ms);
+}
+
+static void proto_bench_format_report(EvilBw16Replay* replay, FuriString* out) {
+    const EvilBw16ProtoBenchRun* text = &replay->proto[0];
+    const EvilBw16ProtoBenchRun* binary = &replay->proto[1];
+
+    furi_string_cat_printf(out, "=== PROTOCOL BENCH ===\n");
+    furi_string_cat_printf(out, "%lu scans x %d networks\n", (uint32_t)PROTO_BENCH_ROUNDS, EVIL_BW16_MAX_NETWORKS);
+    furi_string_cat_printf(out, "Link: %lu baud\n", replay->link_baud);
+    furi_string_cat_printf(out, "CPU is per result incl.\nheader and done lines.\n\n");
+
+    proto_bench_format_run("TEXT", text, replay->link_baud, out);
+    proto_bench_format_run("BINARY", binary, replay->link_baud, out);
+
+    if(text->bytes) {
+        furi_string_cat_printf(out, "Binary bytes: %lu%% of text\n", (uint32_t)((uint64_t)binary->bytes * 100 / text->bytes));
+    }
+    if(text->profile.cycles) {
+        furi_string_cat_printf(out, "Binary CPU: %lu%% of text\n", (uint32_t)(binary->profile.cycles * 100 / text->profile.cycles));
+    }
+    furi_string_cat_printf(out, "\nThe scan list now holds the\nsynthetic networks.\n");
+}
+
+static void sim_bench_format_report(EvilBw16Replay* replay, FuriString* out) {
+    const uint32_t cpi = furi_hal_cortex_instructions_per_microsecond();
+
+    if(replay->kind == ReplayKindSimScan) {
+        const EvilBw16SimScanBench* bench = &replay->sim_scan;
+        const uint32_t scans = MAX(bench->scans, 1UL);
+        furi_string_cat_printf(out, "=== SIM: SCAN LATENCY ===\n");
+        furi_string_cat_printf(out, "Link: %lu baud, %s\n", replay->link_baud, replay->link_binary ? "binary" : "text");
+        furi_string_cat_printf(out, "Networks: %u\n", bench->networks);
+        furi_string_cat_printf(out, "Sim scan time: %lu ms\n", bench->scan_ms);
+        furi_string_cat_printf(out, "Scans: %lu (%lu timed out)\n\n", bench->scans, bench->timeouts);
+        if(bench->scans == 0) return;
+
+        const uint32_t avg = bench->total_ms / scans;
+        furi_string_cat_printf(out, "Latency min: %lu ms\n", bench->min_ms);
+        furi_string_cat_printf(out, "Latency avg: %lu ms\n", avg);
+        furi_string_cat_printf(out, "Latency max: %lu ms\n", bench->max_ms);
+        furi_string_cat_printf(out, "Minus scan time: %lu ms\n", avg > bench->scan_ms ? avg - bench->scan_ms : 0);
+        furi_string_cat_printf(out, "Bytes/scan: %lu\n", bench->bytes / scans);
+        if(replay->link_baud) {
+            furi_string_cat_printf(out, "Wire/scan: %lu ms\n", (uint32_t)((uint64_t)bench->bytes * 10000 / replay->link_baud / scans));
+        }
+    } else {
+        const EvilBw16SimSniffBench* bench = &replay->sim_sniff;
+        const uint32_t elapsed_ms = MAX(bench->elapsed_ms, 1UL);
+        furi_string_cat_printf(out, "=== SIM: SNIFF THROUGHPUT ===\n");
+        furi_string_cat_printf(out, "Link: %lu baud, %s\n", replay->link_baud, replay->link_binary ? "binary" : "text");
+        furi_string_cat_printf(out, "Offered: %lu frames/s\n", bench->offered_rate);
+        furi_string_cat_printf(out, "Time: %lu ms\n\n", bench->elapsed_ms);
+        furi_string_cat_printf(out, "Sent by BW16: %lu/s\n", (uint32_t)((uint64_t)bench->sent * 1000 / elapsed_ms));
+        furi_string_cat_printf(out, "Counted: %lu/s\n", (uint32_t)((uint64_t)bench->counted * 1000 / elapsed_ms));
+        furi_string_cat_printf(out, "Dropped bytes: %lu\n\n", bench->dropped_bytes);
+        furi_string_cat_printf(out, "=== PER LINE ===\n");
+        if(bench->profile.lines) {
+            furi_string_cat_printf(out, "CPU avg: %lu us\n", (uint32_t)(bench->profile.cycles / bench->profile.lines / cpi));
+        }
+        furi_string_cat_printf(out, "p99: %lu us\n", evil_bw16_profile_percentile_us(&bench->profile, 99));
+    }
+}
+
+static void parser_bench_format_report(EvilBw16Replay* replay, FuriString* out) {
+    const EvilBw16ParserBench* bench = &replay->parser;
+    const uint32_t cpi = furi_hal_cortex_instructions_per_microsecond();
+    const uint32_t parsed = MAX(bench->parsed, 1UL);
+    const uint32_t avg_cycles = (uint32_t)(bench->cycles / parsed);
+
+    furi_string_cat_printf(out, "=== SCAN PARSER ===\n");
+    furi_string_cat_printf(out, "Corpus: %lu/%lu passed\n", bench->passed, bench->lines);
+    for(uint32_t i = 0; i < MIN(bench->failures, (uint32_t)PARSER_BENCH_MAX_FAILURES); i++) {
+        furi_string_cat_printf(out, "FAIL #%u: %.24s\n", bench->failed[i], scan_corpus[bench->failed[i]].line + 7);
+    }
+    furi_string_cat_printf(out, "\n=== TIMING ===\n");
+    furi_string_cat_printf(out, "Lines: %lu\n", bench->parsed);
+    furi_string_cat_printf(out, "Avg: %lu cycles\n", avg_cycles);
+    furi_string_cat_printf(out, "Max: %lu cycles\n", bench->max_cycles);
+    furi_string_cat_printf(out, "Per %d-network scan: %lu us\n", EVIL_BW16_MAX_NETWORKS, avg_cycles * EVIL_BW16_MAX_NETWORKS / cpi);
+    furi_string_cat_printf(out, "Time: %lu ms\n", replay->elapsed_ms);
+
+    const EvilBw16NetworkTableStats* storage = &bench->storage;
+    furi_string_cat_printf(out, "\n=== STORAGE ===\n");
+    furi_string_cat_printf(out, "Record: %u B + SSID\n", sizeof(EvilBw16Network));
+    furi_string_cat_printf(out, "Fits: %u networks in %u B\n", storage->count, storage->budget);
+    furi_string_cat_printf(out, "Per network: %u B\n", storage->bytes / MAX(storage->count, (size_t)1));
+    furi_string_cat_printf(out, "SSIDs: %u B, %lu shared\n", storage->ssid_bytes, storage->ssids_shared);
+}
+
+void evil_bw16_replay_format_report(EvilBw16Replay* replay, FuriString* out) {
+    furi_string_reset(out);
+    if(!replay) return;
+
+    if(replay->kind == ReplayKindProtoBench) {
+        proto_bench_format_report(replay, out);
+        return;
+    } else if(replay->kind == ReplayKindSimScan || replay->kind == ReplayKindSimSniff) {
+        sim_bench_format_report(replay, out);
+        return;
+    } else if(replay->kind == ReplayKindParserBench) {
+        parser_bench_format_report(replay, out);
+        return;
+    }
+
+    if(!replay->file_ok && replay->kind == ReplayKindCapture) {
+        furi_string_cat_printf(out, "No RX capture found.\n\n");
+        furi_string_cat_printf(out, "Record one with Start RX Capture\nfirst.\n");
+        return;
+    } else if(!replay->file_ok) {
+        furi_string_cat_printf(out, "No replay source found.\n\n");
+        furi_string_cat_printf(out, "Copy a raw BW16 UART log to\n%s\n", REPLAY_FILE_PATH);
+        return;
+    }
+
+    const EvilBw16UartProfile* profile = &replay->profile;
+    const uint32_t elapsed_ms = MAX(replay->elapsed_ms, 1UL);
+    const uint32_t cpi = furi_hal_cortex_instructions_per_microsecond();
+
+    furi_string_cat_printf(out, "=== REPLAY BENCHMARK ===\n");
+    furi_string_cat_printf(out, "Source: %s\n", replay->kind == ReplayKindCapture ? "RX capture" : "text log");
+    if(replay->original_timing) {
+        furi_string_cat_printf(out, "Rate: recorded timing\n");
+    } else if(replay->baud_rate) {
+        furi_string_cat_printf(out, "Rate: %lu baud\n", replay->baud_rate);
+    } else {
+        furi_string_cat_printf(out, "Rate: max speed\n");
+    }
+    furi_string_cat_printf(out, "Bytes: %lu\n", replay->bytes);
+    furi_string_cat_printf(out, "Lines: %lu\n", profile->lines);
+    furi_string_cat_printf(out, "Time: %lu ms\n", replay->elapsed_ms);
+    furi_string_cat_printf(out, "Lines/sec: %lu\n", (uint32_t)((uint64_t)profile->lines * 1000 / elapsed_ms));
+    furi_string_cat_printf(out, "Bytes/sec: %lu\n", (uint32_t)((uint64_t)replay->bytes * 1000 / elapsed_ms));
+    furi_string_cat_printf(out, "Dropped bytes: %lu\n\n", replay->dropped_bytes);
+
+    furi_string_cat_printf(out, "=== PER LINE ===\n");
+    if(profile->lines) {
+        furi_string_cat_printf(out, "CPU avg: %lu us\n", (uint32_t)(profile->cycles / profile->lines / cpi));
+    }
+    furi_string_cat_printf(out, "p50: %lu us\n", evil_bw16_profile_percentile_us(profile, 50));
+    furi_string_cat_printf(out, "p90: %lu us\n", evil_bw16_profile_percentile_us(profile, 90));
+    furi_string_cat_printf(out, "p99: %lu us\n", evil_bw16_profile_percentile_us(profile, 99));
+    furi_string_cat_printf(out, "Max: %lu us\n", profile->max_cycles / cpi);
+}
+
+#endif // EVIL_BW16_DEVTOOLS
@@ -0,0 +1,212 @@
+#include "evil_bw16.h"
+#include <gui/elements.h>
+
+// Live scan view.
+//
+// Networks appear while the BW16 is still printing results: the scene hands over each
+// network the worker has parsed since the last update and it goes straight into its
+// place in the list, strongest first. Nothing is re-sorted, so an update costs one
+// binary search and a short move per new network. The view keeps the strongest
+// EVIL_BW16_MAX_NETWORKS; the full list opens when the scan completes.
+
+#define SCANNER_VIEW_HEADER_HEIGHT (11)
+#define SCANNER_VIEW_ROW_HEIGHT (9)
+#define SCANNER_VIEW_VISIBLE_ROWS ((64 - SCANNER_VIEW_HEADER_HEIGHT) / SCANNER_VIEW_ROW_HEIGHT)
+#define SCANNER_VIEW_SSID_LEN (20)
+
+typedef struct {
+    int8_t rssi;
+    uint8_t channel;
+    char ssid[SCANNER_VIEW_SSID_LEN + 1];
+} EvilBw16ScannerRow;
+
+struct EvilBw16ScannerView {
+    View* view;
+    EvilBw16ScannerViewCallback ok_callback;
+    void* ok_context;
+};
+
+typedef struct {
+    EvilBw16ScannerRow rows[EVIL_BW16_MAX_NETWORKS];  // Strongest first
+    uint8_t count;
+    uint16_t seen;  // Heard list positions taken in so far
+    uint32_t generation;  // Of the scan they came from
+    uint8_t scroll;
+    uint32_t start_tick;
+    uint32_t first_result_ms;  // 0 until the first network arrives
+} EvilBw16ScannerViewModel;
+
+// Slot for a new row: after every row at least as strong, so equal RSSIs keep arrival order
+static size_t scanner_view_insert_pos(const EvilBw16ScannerViewModel* model, int8_t rssi) {
+    size_t low = 0;
+    size_t high = model->count;
+    while(low < high) {
+        const size_t mid = (low + high) / 2;
+        if(model->rows[mid].rssi >= rssi) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void scanner_view_draw_callback(Canvas* canvas, void* _model) {
+    EvilBw16ScannerViewModel* model = _model;
+    char text[32];
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(text, sizeof(text), "Scanning %lus", (furi_get_tick() - model->start_tick) / furi_kernel_get_tick_frequency());
+    canvas_draw_str(canvas, 0, 8, text);
+    if(model->count > 0) {
+        snprintf(text, sizeof(text), "%u APs, 1st %lums", model->seen, model->first_result_ms);
+        canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, text);
+    }
+    canvas_draw_line(canvas, 0, SCANNER_VIEW_HEADER_HEIGHT - 2, 127, SCANNER_VIEW_HEADER_HEIGHT - 2);
+
+    if(model->count == 0) {
+        canvas_draw_str(canvas, 0, SCANNER_VIEW_HEADER_HEIGHT + SCANNER_VIEW_ROW_HEIGHT - 1, "Waiting for results...");
+        canvas_draw_str(canvas, 0, SCANNER_VIEW_HEADER_HEIGHT + 2 * SCANNER_VIEW_ROW_HEIGHT - 1, "OK: show results now");
+        return;
+    }
+
+    const uint8_t max_scroll = model->count > SCANNER_VIEW_VISIBLE_ROWS ? model->count - SCANNER_VIEW_VISIBLE_ROWS : 0;
+    if(model->scroll > max_scroll) model->scroll = max_scroll;
+
+    int32_t y = SCANNER_VIEW_HEADER_HEIGHT + SCANNER_VIEW_ROW_HEIGHT - 1;
+    for(size_t i = model->scroll; i < model->count && i < (size_t)model->scroll + SCANNER_VIEW_VISIBLE_ROWS; i++) {
+        const EvilBw16ScannerRow* row = &model->rows[i];
+        snprintf(text, sizeof(text), "%d", row->rssi);
+        canvas_draw_str_aligned(canvas, 16, y, AlignRight, AlignBottom, text);
+        snprintf(text, sizeof(text), "%u", row->channel);
+        canvas_draw_str_aligned(canvas, 32, y, AlignRight, AlignBottom, text);
+        canvas_draw_str(canvas, 36, y, row->ssid[0] ? row->ssid : "<hidden>");
+        y += SCANNER_VIEW_ROW_HEIGHT;
+    }
+
+    if(model->count > SCANNER_VIEW_VISIBLE_ROWS) {
+        elements_scrollbar_pos(canvas, 127, SCANNER_VIEW_HEADER_HEIGHT, 64 - SCANNER_VIEW_HEADER_HEIGHT, model->scroll, max_scroll + 1);
+    }
+}
+
+static bool scanner_view_input_callback(InputEvent* event, void* context) {
+    EvilBw16ScannerView* scanner = context;
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+
+    if(event->key == InputKeyOk) {
+        if(scanner->ok_callback) scanner->ok_callback(scanner->ok_context);
+        return true;
+    }
+    if(event->key != InputKeyUp && event->key != InputKeyDown) return false;
+
+    with_view_model(
+        scanner->view,
+        EvilBw16ScannerViewModel * model,
+        {
+            if(event->key == InputKeyUp && model->scroll > 0) {
+                model->scroll--;
+            } else if(event->key == InputKeyDown && model->scroll < EVIL_BW16_MAX_NETWORKS) {
+                model->scroll++;  // Clamped when drawn
+            }
+        },
+        true);
+
+    return true;
+}
+
+EvilBw16ScannerView* evil_bw16_scanner_view_alloc(void) {
+    EvilBw16ScannerView* scanner = malloc(sizeof(EvilBw16ScannerView));
+    memset(scanner, 0, sizeof(EvilBw16ScannerView));
+    scanner->view = view_alloc();
+    view_set_context(scanner->view, scanner);
+    view_allocate_model(scanner->view, ViewModelTypeLocking, sizeof(EvilBw16ScannerViewModel));
+    view_set_draw_callback(scanner->view, scanner_view_draw_callback);
+    view_set_input_callback(scanner->view, scanner_view_input_callback);
+    return scanner;
+}
+
+void evil_bw16_scanner_view_free(EvilBw16ScannerView* scanner) {
+    if(!scanner) return;
+    view_free(scanner->view);
+    free(scanner);
+}
+
+View* evil_bw16_scanner_view_get_view(EvilBw16ScannerView* scanner) {
+    return scanner->view;
+}
+
+// OK asks to leave for the full results, whether or not the scan has finished
+void evil_bw16_scanner_view_set_ok_callback(EvilBw16ScannerView* scanner, EvilBw16ScannerViewCallback callback, void* context) {
+    scanner->ok_callback = callback;
+    scanner->ok_context = context;
+}
+
+// Empty the list and restart the clock for a new scan
+void evil_bw16_scanner_view_reset(EvilBw16ScannerView* scanner) {
+    with_view_model(
+        scanner->view,
+        EvilBw16ScannerViewModel * model,
+        {
+            model->count = 0;
+            model->seen = 0;
+            model->scroll = 0;
+            model->start_tick = furi_get_tick();
+            model->first_result_ms = 0;
+        },
+        true);
+}
+
+// Take in the networks heard since the last sync, whether new to the scan list or
+// merged into it from an earlier scan. When a new scan began in between, the BW16
+// started over and the view does too. Once the view is full a new network only gets in
+// by pushing out the weakest. Returns true when this brought the first result of the
+// scan.
+bool evil_bw16_scanner_view_sync(EvilBw16ScannerView* scanner, EvilBw16NetworkTable* networks) {
+    const uint32_t generation = evil_bw16_network_table_get_generation(networks);
+    const size_t count = evil_bw16_network_table_heard_count(networks);
+    bool first = false;
+    with_view_model(
+        scanner->view,
+        EvilBw16ScannerViewModel * model,
+        {
+            if(generation != model->generation) {
+                model->generation = generation;
+                model->seen = 0;
+                model->count = 0;
+            }
+            if(model->first_result_ms == 0 && count > 0) {
+                model->first_result_ms = MAX(furi_get_tick() - model->start_tick, 1UL) * 1000 / furi_kernel_get_tick_frequency();
+                first = true;
+            }
+
+            evil_bw16_network_table_lock(networks);
+            for(; model->seen < count; model->seen++) {
+                const EvilBw16Network* network = evil_bw16_network_table_get(
+                    networks, evil_bw16_network_table_heard_at(networks, model->seen));
+                if(!network) continue;
+
+                const int8_t rssi = network->rssi;
+                const size_t pos = scanner_view_insert_pos(model, rssi);
+                if(pos >= EVIL_BW16_MAX_NETWORKS) continue;
+                if(model->count == EVIL_BW16_MAX_NETWORKS) model->count--;
+                memmove(&model->rows[pos + 1], &model->rows[pos], (model->count - pos) * sizeof(EvilBw16ScannerRow));
+
+                EvilBw16ScannerRow* row = &model->rows[pos];
+                row->rssi = rssi;
+                row->channel = network->channel;
+                strncpy(row->ssid, evil_bw16_network_table_get_ssid(networks, network), SCANNER_VIEW_SSID_LEN);
+                row->ssid[SCANNER_VIEW_SSID_LEN] = '\0';
+                model->count++;
+            }
+            evil_bw16_network_table_unlock(networks);
+        },
+        true);
+    return first;
+}
+
+// Redraw for the elapsed time
+void evil_bw16_scanner_view_update(EvilBw16ScannerView* scanner) {
+    with_view_model(scanner->view, EvilBw16ScannerViewModel * model, { UNUSED(model); }, true);
+}
@@ -16,50 +16,37 @@
 #include "evil_bw16.h"
 
 // Configuration menu items
+// Numbered above the worker events, which reach this scene while it is open
 enum EvilBw16ConfigMenuIndex {
-    EvilBw16ConfigMenuIndexCycleDelay = 0,
+    EvilBw16ConfigMenuIndexCycleDelay = 100,
     EvilBw16ConfigMenuIndexScanTime,
     EvilBw16ConfigMenuIndexFramesPerAP,
     EvilBw16ConfigMenuIndexStartChannel,
     EvilBw16ConfigMenuIndexLedEnabled,
     EvilBw16ConfigMenuIndexDebugMode,
     EvilBw16ConfigMenuIndexGpioPins,
+    EvilBw16ConfigMenuIndexBaudRate,
+    EvilBw16ConfigMenuIndexRxBuffer,
+    EvilBw16ConfigMenuIndexLogLevel,
+    EvilBw16ConfigMenuIndexLinkProtocol,
+    EvilBw16ConfigMenuIndexNetworkRam,
     EvilBw16ConfigMenuIndexSendToDevice,
 };
 
 // Debug logging functions
-void debug_write_to_sd(const char* data) {
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    File* file = storage_file_alloc(storage);
-    
-    // Ensure debug directory exists
-    storage_simply_mkdir(storage, EXT_PATH("apps_data"));
-    
-    // Open debug log file in append mode
-    if(storage_file_open(file, EXT_PATH("apps_data/evil_bw16_debug.txt"), FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        // Write timestamp and data
-        char timestamp[32];
-        uint32_t tick = furi_get_tick();
-        snprintf(timestamp, sizeof(timestamp), "[%lu] ", tick);
-        
-        storage_file_write(file, timestamp, strlen(timestamp));
-        storage_file_write(file, data, strlen(data));
-        storage_file_write(file, "\n", 1);
-        storage_file_sync(file);
-        
-        storage_file_close(file);
-    }
-    
-    storage_file_free(file);
-    furi_record_close(RECORD_STORAGE);
+// Lines are queued to the debug log writer thread, so these never wait on the SD card
+void debug_write_to_sd(EvilBw16App* app, const char* data) {
+    debug_write_line_to_sd(app, evil_bw16_line_view(data, strlen(data)));
 }
 
+void debug_write_line_to_sd(EvilBw16App* app, EvilBw16LineView line) {
+    char timestamp[16];
+    snprintf(timestamp, sizeof(timestamp), "[%lu] ", furi_get_tick());
+    evil_bw16_storage_writer_write_line(app->debug_log, timestamp, line);
+}
 
-
-static void debug_clear_log() {
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    storage_simply_remove(storage, EXT_PATH("apps_data/evil_bw16_debug.txt"));
-    furi_record_close(RECORD_STORAGE);
+static void debug_clear_log(EvilBw16App* app) {
+    evil_bw16_storage_writer_truncate(app->debug_log);
 }
 
 // Submenu callback functions
@@ -158,13 +145,19 @@ void evil_bw16_scene_on_exit_start(void* context) {
 }
 
 // Scene: Main Menu
+// Numbered above the worker events, which reach this scene too (sniffer started/stopped)
 enum EvilBw16MainMenuIndex {
-    EvilBw16MainMenuIndexScanner,
+    EvilBw16MainMenuIndexScanner = 100,
     EvilBw16MainMenuIndexAttacks,
     EvilBw16MainMenuIndexSniffer,
     EvilBw16MainMenuIndexConfig,
     EvilBw16MainMenuIndexDeviceInfo,
     EvilBw16MainMenuIndexUartTerminal,
+#ifdef EVIL_BW16_DEVTOOLS
+    EvilBw16MainMenuIndexReplay,
+#endif
+    EvilBw16MainMenuIndexSnifferStats,
+    EvilBw16MainMenuIndexNum,
 };
 
 void evil_bw16_scene_on_enter_main_menu(void* context) {
@@ -179,6 +172,10 @@ void evil_bw16_scene_on_enter_main_menu(void* context) {
     submenu_add_item(app->submenu, "Configuration", EvilBw16MainMenuIndexConfig, evil_bw16_submenu_callback_main_menu, app);
     submenu_add_item(app->submenu, "Help", EvilBw16MainMenuIndexDeviceInfo, evil_bw16_submenu_callback_main_menu, app);
     submenu_add_item(app->submenu, "UART Terminal", EvilBw16MainMenuIndexUartTerminal, evil_bw16_submenu_callback_main_menu, app);
+#ifdef EVIL_BW16_DEVTOOLS
+    submenu_add_item(app->submenu, "Capture & Replay", EvilBw16MainMenuIndexReplay, evil_bw16_submenu_callback_main_menu, app);
+#endif
+    submenu_add_item(app->submenu, "Sniffer Stats", EvilBw16MainMenuIndexSnifferStats, evil_bw16_submenu_callback_main_menu, app);
     
     submenu_set_selected_item(app->submenu, app->selected_menu_index);
     view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
@@ -194,14 +191,15 @@ bool evil_bw16_scene_on_event_main_menu(void* context, SceneManagerEvent event)
         return true;
     }
     else if(event.type == SceneManagerEventTypeCustom) {
-        app->selected_menu_index = event.event;
+        // Remember only real selections, not worker events passing through
+        if(event.event >= EvilBw16MainMenuIndexScanner && event.event < EvilBw16MainMenuIndexNum) {
+            app->selected_menu_index = event.event;
+        }
         
         switch(event.event) {
             case EvilBw16MainMenuIndexScanner:
-                // Send scan command and open terminal to see results immediately
-                evil_bw16_send_command(app, "scan");
-                scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneUartTerminal, 1);
-                scene_manager_next_scene(app->scene_manager, EvilBw16SceneUartTerminal);
+                // The scanner scene sends the scan command and shows results as they arrive
+                scene_manager_next_scene(app->scene_manager, EvilBw16SceneScanner);
                 return true;
             case EvilBw16MainMenuIndexAttacks:
                 scene_manager_next_scene(app->scene_manager, EvilBw16SceneAttacks);
@@ -224,6 +222,15 @@ bool evil_bw16_scene_on_event_main_menu(void* context, SceneManagerEvent event)
                 scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneUartTerminal, 0);
                 scene_manager_next_scene(app->scene_manager, EvilBw16SceneUartTerminal);
                 return true;
+#ifdef EVIL_BW16_DEVTOOLS
+            case EvilBw16MainMenuIndexReplay:
+                scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneReplay, 0);
+                scene_manager_next_scene(app->scene_manager, EvilBw16SceneReplay);
+                return true;
+#endif
+            case EvilBw16MainMenuIndexSnifferStats:
+                scene_manager_next_scene(app->scene_manager, EvilBw16SceneSnifferResults);
+                return true;
         }
     }
     
@@ -236,33 +243,37 @@ void evil_bw16_scene_on_exit_main_menu(void* context) {
 }
 
 // Scene: Scanner
+// Results show up in the live view as the worker parses them; the scene moves on to the
+// full list when the scan completes, on OK, or after EVIL_BW16_SCAN_TIMEOUT_MS.
+#define EVIL_BW16_SCAN_TIMEOUT_MS (15000)
+
+static void evil_bw16_scanner_ok_callback(void* context) {
+    EvilBw16App* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, EvilBw16EventScanComplete);
+}
+
 void evil_bw16_scene_on_enter_scanner(void* context) {
     EvilBw16App* app = context;
     
-    // Show loading screen for a few seconds, then show fake results
-    evil_bw16_show_loading(app, "Scanning WiFi networks...");
+    // Scene state: tick the scan started at
+    scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneScanner, furi_get_tick());
+    evil_bw16_scanner_view_reset(app->scanner_view);
+    evil_bw16_scanner_view_set_ok_callback(app->scanner_view, evil_bw16_scanner_ok_callback, app);
+    view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewScannerLive);
     
-    // Clear previous scan results and selections completely
-    app->network_count = 0;
+    // Earlier results stay and are merged with this scan's; the worker ages out stale
+    // networks when the results header arrives
+    evil_bw16_network_table_begin_scan(app->networks);
     app->scan_in_progress = true;
+    app->scan_timed_out = false;
     
-    // Explicitly clear all networks and reset selection state
-    for(int i = 0; i < EVIL_BW16_MAX_NETWORKS; i++) {
-        memset(&app->networks[i], 0, sizeof(EvilBw16Network));
-        app->networks[i].selected = false;
-        app->networks[i].index = i;         // Internal array index
-        app->networks[i].device_index = i;  // Will be set properly by UART parser
-    }
-    
-    // Clear attack state targets since networks are changing
+    // Attack state targets are list positions, which ageing shifts
     app->attack_state.num_targets = 0;
     memset(app->attack_state.target_indices, 0, sizeof(app->attack_state.target_indices));
     
     // Clear debug log at start of new scan
-    debug_clear_log();
-    debug_write_to_sd("=== NEW SCAN STARTED ===");
-    
-    FURI_LOG_I("EvilBw16", "Scanner: Cleared %d networks and all selections", EVIL_BW16_MAX_NETWORKS);
+    debug_clear_log(app);
+    debug_write_to_sd(app, "=== NEW SCAN STARTED ===");
     
     // Send scan command - UART worker will handle all parsing
     evil_bw16_send_scan_command(app);
@@ -271,52 +282,31 @@ void evil_bw16_scene_on_enter_scanner(void* context) {
 bool evil_bw16_scene_on_event_scanner(void* context, SceneManagerEvent event) {
     EvilBw16App* app = context;
     
-    // Handle scan completion event from UART worker
     if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == EvilBw16EventScanComplete) {
-            FURI_LOG_I("EvilBw16", "Scan complete event received with %d networks", app->network_count);
+        if(event.event == EvilBw16EventScanResult) {
+            if(evil_bw16_scanner_view_sync(app->scanner_view, app->networks)) {
+                EVIL_BW16_LOG_I("First scan result after %lu ms", furi_get_tick() - scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneScanner));
+            }
+            return true;
+        } else if(event.event == EvilBw16EventScanComplete) {
+            // Handle scan completion event from UART worker (or OK in the live view)
+            EVIL_BW16_LOG_I("Scan complete event received with %u networks", evil_bw16_network_table_count(app->networks));
             app->scan_in_progress = false;
-            evil_bw16_hide_loading(app);
             scene_manager_next_scene(app->scene_manager, EvilBw16SceneScannerResults);
             return true;
         }
+    } else if(event.type == SceneManagerEventTypeTick) {
+        evil_bw16_scanner_view_update(app->scanner_view);
     }
     
-    // Timeout after 15 seconds in case scan gets stuck
-    static uint32_t scan_start_time = 0;
-    if(scan_start_time == 0) {
-        scan_start_time = furi_get_tick();
-    }
-    
-    if(furi_get_tick() - scan_start_time > 15000) {
-        FURI_LOG_I("EvilBw16", "Scan timeout reached with %d networks found", app->network_count);
-        
-        if(app->network_count == 0) {
-            // No networks found after timeout - add diagnostic info
-            strcpy(app->networks[0].ssid, "Scan Timeout");
-            strcpy(app->networks[0].bssid, "No UART Data");
-            app->networks[0].channel = 1;
-            app->networks[0].rssi = -99;
-            app->networks[0].band = EvilBw16Band24GHz;
-            app->networks[0].index = 0;
-            app->networks[0].selected = false;
-            
-            strcpy(app->networks[1].ssid, "BW16 Not Responding");
-            const char* pins = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "Pin 13/14" : "Pin 15/16";
-            strcpy(app->networks[1].bssid, pins);
-            app->networks[1].channel = 36;
-            app->networks[1].rssi = -99;
-            app->networks[1].band = EvilBw16Band5GHz;
-            app->networks[1].index = 1;
-            app->networks[1].selected = false;
-            
-            app->network_count = 2;
-        }
+    // Timeout in case scan gets stuck
+    const uint32_t scan_start_time = scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneScanner);
+    if(app->scan_in_progress && furi_get_tick() - scan_start_time > EVIL_BW16_SCAN_TIMEOUT_MS) {
+        EVIL_BW16_LOG_I("Scan timeout reached with %u networks found", evil_bw16_network_table_count(app->networks));
         
         app->scan_in_progress = false;
-        evil_bw16_hide_loading(app);
+        app->scan_timed_out = true;
         scene_manager_next_scene(app->scene_manager, EvilBw16SceneScannerResults);
-        scan_start_time = 0;
         return true;
     }
     
@@ -325,65 +315,176 @@ bool evil_bw16_scene_on_event_scanner(void* context, SceneManagerEvent event) {
 
 void evil_bw16_scene_on_exit_scanner(void* context) {
     EvilBw16App* app = context;
-    evil_bw16_hide_loading(app);
+    evil_bw16_scanner_view_set_ok_callback(app->scanner_view, NULL, NULL);
 }
 
 // Scene: Scanner Results
-void evil_bw16_scene_on_enter_scanner_results(void* context) {
-    EvilBw16App* app = context;
+// Controls sit above the worker events that reach this scene; networks are listed by
+// handle as in the target menu
+enum EvilBw16ResultsMenuIndex {
+    EvilBw16ResultsMenuIndexSort = 100,
+    EvilBw16ResultsMenuIndexBand,
+    EvilBw16ResultsMenuIndexMinRssi,
+    EvilBw16ResultsMenuIndexTargets,
+    EvilBw16ResultsMenuIndexNetwork = 0x2000,
+};
+
+static const char* const results_sort_names[EvilBw16NetworkSortNum] = {"First Seen", "RSSI", "Channel", "Band", "SSID"};
+static const int8_t results_min_rssi_steps[] = {INT8_MIN, -60, -70, -80};
+
+// List the scan list in the chosen order, skipping what the filter excludes. Walking a
+// permutation the table already keeps makes this linear, however the order changed.
+static void evil_bw16_results_menu_build(EvilBw16App* app) {
+    const EvilBw16NetworkFilter* filter = &app->results_filter;
+    char label[64];
     
-    furi_string_reset(app->text_box_string);
+    submenu_reset(app->submenu);
     
-    if(app->network_count == 0) {
-        furi_string_printf(app->text_box_string, "No networks found.\n\nPress BACK to return to menu.");
+    snprintf(label, sizeof(label), "Sort: %s", results_sort_names[app->results_sort]);
+    submenu_add_item(app->submenu, label, EvilBw16ResultsMenuIndexSort, evil_bw16_submenu_callback_sniffer, app);
+    snprintf(label, sizeof(label), "Band: %s",
+        filter->band == EvilBw16Band24GHz ? "2.4GHz only" : filter->band == EvilBw16Band5GHz ? "5GHz only" : "All");
+    submenu_add_item(app->submenu, label, EvilBw16ResultsMenuIndexBand, evil_bw16_submenu_callback_sniffer, app);
+    if(filter->min_rssi == INT8_MIN) {
+        snprintf(label, sizeof(label), "Min RSSI: Off");
     } else {
-        furi_string_printf(app->text_box_string, "Found %d networks:\n\n", app->network_count);
-        
-        for(uint8_t i = 0; i < app->network_count; i++) {
-            char freq_str[8];
-            if(app->networks[i].channel >= 36) {
-                strcpy(freq_str, "5GHz");
-            } else {
-                strcpy(freq_str, "2.4GHz");
-            }
-            
-            furi_string_cat_printf(app->text_box_string, 
-                "[%02d] %s\n"
-                "     %s\n"
-                "     Ch:%d  %ddBm  %s\n\n",
-                i + 1,  // Show 1-based indexing consistently
-                app->networks[i].ssid,
-                app->networks[i].bssid,
-                app->networks[i].channel,
-                app->networks[i].rssi,
-                freq_str
-            );
-        }
+        snprintf(label, sizeof(label), "Min RSSI: %d dBm", filter->min_rssi);
+    }
+    submenu_add_item(app->submenu, label, EvilBw16ResultsMenuIndexMinRssi, evil_bw16_submenu_callback_sniffer, app);
+    
+    if(app->scan_timed_out && evil_bw16_network_table_heard_count(app->networks) == 0) {
+        // Nothing came back before the timeout - most likely wiring
+        const char* pins = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "pins 13/14" : "pins 15/16";
+        snprintf(label, sizeof(label), "Timed out: check %s", pins);
+        submenu_add_item(app->submenu, label, 0, NULL, app);
+    }
+    
+    // Locked so the worker cannot move entries around the permutation mid-walk
+    evil_bw16_network_table_lock(app->networks);
+    const size_t network_count = evil_bw16_network_table_count(app->networks);
+    size_t shown = 0;
+    for(size_t i = 0; i < network_count; i++) {
+        const EvilBw16NetworkHandle handle = evil_bw16_network_table_sorted_at(app->networks, app->results_sort, i);
+        const EvilBw16Network* network = evil_bw16_network_table_get(app->networks, handle);
+        if(!network || !evil_bw16_network_filter_match(filter, network)) continue;
         
-        furi_string_cat_printf(app->text_box_string, "Press OK to select targets\nPress BACK to return to menu");
+        const char* ssid = evil_bw16_network_table_get_ssid(app->networks, network);
+        snprintf(label, sizeof(label), "%d %u %s", evil_bw16_network_rssi_avg(network), network->channel, ssid[0] ? ssid : "<hidden>");
+        submenu_add_item(app->submenu, label, EvilBw16ResultsMenuIndexNetwork + handle, evil_bw16_submenu_callback_sniffer, app);
+        shown++;
     }
+    evil_bw16_network_table_unlock(app->networks);
     
+    if(network_count > 0) {
+        submenu_add_item(app->submenu, "Select Targets", EvilBw16ResultsMenuIndexTargets, evil_bw16_submenu_callback_sniffer, app);
+    }
+    
+    snprintf(label, sizeof(label), "Networks: %u of %u", shown, network_count);
+    submenu_set_header(app->submenu, label);
+}
+
+// Everything known about one network
+static void evil_bw16_results_show_network(EvilBw16App* app, const EvilBw16Network* network) {
+    char bssid_str[EVIL_BW16_BSSID_STR_LEN];
+    evil_bw16_format_bssid(network->bssid, bssid_str);
+    const uint32_t tick_frequency = furi_kernel_get_tick_frequency();
+    const uint32_t now = furi_get_tick();
+    
+    furi_string_printf(app->text_box_string, 
+        "%s\n"
+        "%s\n"
+        "Ch:%d  %s\n"
+        "RSSI: %ddBm (avg %d)\n"
+        "Seen in %u scans\n"
+        "First: %lus ago\n"
+        "Last: %lus ago\n"
+        "%s",
+        evil_bw16_network_table_get_ssid(app->networks, network),
+        bssid_str,
+        network->channel,
+        (network->band == EvilBw16Band5GHz) ? "5GHz" : "2.4GHz",
+        network->rssi,
+        evil_bw16_network_rssi_avg(network),
+        network->seen_count,
+        (now - network->first_seen) / tick_frequency,
+        (now - network->last_seen) / tick_frequency,
+        evil_bw16_network_table_in_scan(app->networks, network) ? "In last scan" : "Not in last scan"
+    );
     text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_string));
-    text_box_set_focus(app->text_box, TextBoxFocusEnd);
     view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTextBox);
 }
 
+void evil_bw16_scene_on_enter_scanner_results(void* context) {
+    EvilBw16App* app = context;
+    
+    // Scene state: 0 = list, 1 = one network's details
+    scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneScannerResults, 0);
+    evil_bw16_results_menu_build(app);
+    view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
+}
+
 bool evil_bw16_scene_on_event_scanner_results(void* context, SceneManagerEvent event) {
     EvilBw16App* app = context;
     
-    if(event.type == SceneManagerEventTypeCustom) {
-        if(event.event == 0) { // OK pressed
-            // Go to attack configuration
-            scene_manager_next_scene(app->scene_manager, EvilBw16SceneAttackConfig);
+    if(event.type == SceneManagerEventTypeBack) {
+        // Back from the details returns to the list
+        if(scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneScannerResults) == 1) {
+            scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneScannerResults, 0);
+            view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
             return true;
         }
+        // Skip the scanner scene, which would start another scan on the way back
+        return scene_manager_search_and_switch_to_previous_scene(app->scene_manager, EvilBw16SceneMainMenu);
+    }
+    if(event.type != SceneManagerEventTypeCustom) return false;
+    
+    if(event.event >= EvilBw16ResultsMenuIndexNetwork) {
+        evil_bw16_network_table_lock(app->networks);
+        const EvilBw16Network* network = evil_bw16_network_table_get(app->networks, event.event - EvilBw16ResultsMenuIndexNetwork);
+        if(network) {
+            scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneScannerResults, 1);
+            evil_bw16_results_show_network(app, network);
+        }
+        evil_bw16_network_table_unlock(app->networks);
+        return true;
     }
     
-    return false;
+    switch(event.event) {
+        case EvilBw16ResultsMenuIndexSort:
+            app->results_sort = (app->results_sort + 1) % EvilBw16NetworkSortNum;
+            break;
+            
+        case EvilBw16ResultsMenuIndexBand:
+            // All -> 2.4GHz -> 5GHz
+            app->results_filter.band = app->results_filter.band == EvilBw16BandUnknown ? EvilBw16Band24GHz :
+                                       app->results_filter.band == EvilBw16Band24GHz  ? EvilBw16Band5GHz :
+                                                                                        EvilBw16BandUnknown;
+            break;
+            
+        case EvilBw16ResultsMenuIndexMinRssi: {
+            size_t step = 0;
+            while(step < COUNT_OF(results_min_rssi_steps) && results_min_rssi_steps[step] != app->results_filter.min_rssi) step++;
+            app->results_filter.min_rssi = results_min_rssi_steps[(step + 1) % COUNT_OF(results_min_rssi_steps)];
+            break;
+        }
+            
+        case EvilBw16ResultsMenuIndexTargets:
+            scene_manager_next_scene(app->scene_manager, EvilBw16SceneSniffer);
+            return true;
+            
+        default:
+            // Worker events while the list is up
+            return false;
+    }
+    
+    evil_bw16_results_menu_build(app);
+    submenu_set_selected_item(app->submenu, event.event);
+    return true;
 }
 
 void evil_bw16_scene_on_exit_scanner_results(void* context) {
     EvilBw16App* app = context;
+    submenu_reset(app->submenu);
     text_box_reset(app->text_box);
 }
 
@@ -464,12 +565,15 @@ void evil_bw16_scene_on_enter_attack_config(void* context) {
     // Show current targets
     if(app->attack_state.num_targets > 0) {
         furi_string_cat_printf(app->text_box_string, "Current targets:\n");
+        evil_bw16_network_table_lock(app->networks);
         for(uint8_t i = 0; i < app->attack_state.num_targets; i++) {
             uint8_t idx = app->attack_state.target_indices[i];
-            if(idx < app->network_count) {
-                furi_string_cat_printf(app->text_box_string, "[%02d] %s\n", idx + 1, app->networks[idx].ssid);
+            const EvilBw16Network* network = evil_bw16_network_table_get(app->networks, evil_bw16_network_table_at(app->networks, idx));
+            if(network) {
+                furi_string_cat_printf(app->text_box_string, "[%02d] %s\n", idx + 1, evil_bw16_network_table_get_ssid(app->networks, network));
             }
         }
+        evil_bw16_network_table_unlock(app->networks);
     } else {
         furi_string_cat_printf(app->text_box_string, "No targets selected.\n");
     }
@@ -492,66 +596,108 @@ void evil_bw16_scene_on_exit_attack_config(void* context) {
 }
 
 // Scene: Sniffer
+// Networks are listed by handle from EvilBw16TargetMenuIndexNetwork up, clear of the
+// worker events that reach this scene too
 enum EvilBw16TargetMenuIndex {
     EvilBw16TargetMenuIndexClearAll = 100,
     EvilBw16TargetMenuIndexSelectAll = 101,
     EvilBw16TargetMenuIndexConfirm = 102,
+    EvilBw16TargetMenuIndexNetwork = 0x2000,
 };
 
+// One network's row. Networks only known from earlier scans have no index the BW16
+// would accept, so they are listed but not targetable until a scan hears them again.
+static void evil_bw16_target_menu_label(EvilBw16App* app, const EvilBw16Network* network, char* label, size_t size) {
+    const bool in_scan = evil_bw16_network_table_in_scan(app->networks, network);
+    const char* status = !in_scan ? "-" : network->selected ? "✓" : "○";
+    const char* band_str = (network->band == EvilBw16Band5GHz) ? "5G" : "2.4G";
+    
+    // Truncate long SSIDs for better display
+    const char* ssid = evil_bw16_network_table_get_ssid(app->networks, network);
+    char ssid_display[32];
+    if(strlen(ssid) > 28) {
+        strncpy(ssid_display, ssid, 25);
+        ssid_display[25] = '.';
+        ssid_display[26] = '.';
+        ssid_display[27] = '.';
+        ssid_display[28] = '\0';
+    } else {
+        strcpy(ssid_display, ssid);
+    }
+    
+    if(in_scan) {
+        snprintf(label, size, "%s [%02d] %s (%s)", 
+            status, 
+            network->device_index + 1,  // Show 1-based index to match what we send to device
+            ssid_display, 
+            band_str);
+    } else {
+        snprintf(label, size, "%s [--] %s (%s)", status, ssid_display, band_str);
+    }
+}
+
+// Scene state holds the number of targetable networks selected, kept up to date by
+// each toggle so the confirm label never needs a pass over the list
+static void evil_bw16_target_menu_update_confirm(EvilBw16App* app) {
+    char confirm_text[64];
+    snprintf(confirm_text, sizeof(confirm_text), "Confirm Targets (%lu selected)", 
+        scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneSniffer));
+    submenu_change_item_label(app->submenu, EvilBw16TargetMenuIndexConfirm, confirm_text);
+}
+
+// Select or clear one network, relabelling only its row. A network not in the last scan
+// can only be cleared; its row and the count are unaffected. Returns true if it changed.
+static bool evil_bw16_target_menu_set(EvilBw16App* app, EvilBw16NetworkHandle handle, EvilBw16Network* network, bool selected) {
+    if(network->selected == selected) return false;
+    const bool in_scan = evil_bw16_network_table_in_scan(app->networks, network);
+    if(selected && !in_scan) return false;
+    
+    network->selected = selected;
+    if(!in_scan) return true;
+    
+    uint32_t selected_targets = scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneSniffer);
+    scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneSniffer, selected ? selected_targets + 1 : selected_targets - 1);
+    
+    char menu_text[100];
+    evil_bw16_target_menu_label(app, network, menu_text, sizeof(menu_text));
+    submenu_change_item_label(app->submenu, EvilBw16TargetMenuIndexNetwork + handle, menu_text);
+    return true;
+}
+
 void evil_bw16_scene_on_enter_sniffer(void* context) {
     EvilBw16App* app = context;
     
     submenu_reset(app->submenu);
     submenu_set_header(app->submenu, "Set Attack Targets");
     
-    if(app->network_count == 0) {
+    const size_t network_count = evil_bw16_network_table_count(app->networks);
+    if(network_count == 0) {
         submenu_add_item(app->submenu, "No Networks Found", 0, NULL, app);
         submenu_add_item(app->submenu, "Run WiFi Scan First", 0, NULL, app);
     } else {
-        // Show all available networks with improved formatting
-        for(uint8_t i = 0; i < app->network_count; i++) {
-            char menu_text[100];
-            const char* status = app->networks[i].selected ? "✓" : "○";
-            char band_str[8];
-            strcpy(band_str, (app->networks[i].band == EvilBw16Band5GHz) ? "5G" : "2.4G");
+        uint32_t selected_targets = 0;
+        evil_bw16_network_table_lock(app->networks);
+        for(size_t i = 0; i < network_count; i++) {
+            const EvilBw16NetworkHandle handle = evil_bw16_network_table_at(app->networks, i);
+            const EvilBw16Network* network = evil_bw16_network_table_get(app->networks, handle);
+            if(!network) continue;
             
-            // Truncate long SSIDs for better display
-            char ssid_display[32];
-            if(strlen(app->networks[i].ssid) > 28) {
-                strncpy(ssid_display, app->networks[i].ssid, 25);
-                ssid_display[25] = '.';
-                ssid_display[26] = '.';
-                ssid_display[27] = '.';
-                ssid_display[28] = '\0';
-            } else {
-                strcpy(ssid_display, app->networks[i].ssid);
-            }
-            
-            snprintf(menu_text, sizeof(menu_text), "%s [%02d] %s (%s)", 
-                status, 
-                i + 1,  // Show 1-based index to match what we send to device
-                ssid_display, 
-                band_str);
+            char menu_text[100];
+            evil_bw16_target_menu_label(app, network, menu_text, sizeof(menu_text));
+            if(network->selected && evil_bw16_network_table_in_scan(app->networks, network)) selected_targets++;
             
-            submenu_add_item(app->submenu, menu_text, i, evil_bw16_submenu_callback_sniffer, app);
+            submenu_add_item(app->submenu, menu_text, EvilBw16TargetMenuIndexNetwork + handle, evil_bw16_submenu_callback_sniffer, app);
             
-            FURI_LOG_D("EvilBw16", "Menu[%d]: '%s' -> device_idx=%d", 
-                i, ssid_display, app->networks[i].device_index);
-        }
-        
-        // Count selected targets for status display
-        int selected_targets = 0;
-        for(uint8_t i = 0; i < app->network_count; i++) {
-            if(app->networks[i].selected) selected_targets++;
+            EVIL_BW16_LOG_D("Menu[%u]: handle=%u device_idx=%d", i, handle, network->device_index);
         }
+        evil_bw16_network_table_unlock(app->networks);
+        scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneSniffer, selected_targets);
         
         // Add control options with status
         submenu_add_item(app->submenu, "Clear All Targets", EvilBw16TargetMenuIndexClearAll, evil_bw16_submenu_callback_sniffer, app);
         submenu_add_item(app->submenu, "Select All Targets", EvilBw16TargetMenuIndexSelectAll, evil_bw16_submenu_callback_sniffer, app);
-        
-        char confirm_text[64];
-        snprintf(confirm_text, sizeof(confirm_text), "Confirm Targets (%d selected)", selected_targets);
-        submenu_add_item(app->submenu, confirm_text, EvilBw16TargetMenuIndexConfirm, evil_bw16_submenu_callback_sniffer, app);
+        submenu_add_item(app->submenu, "", EvilBw16TargetMenuIndexConfirm, evil_bw16_submenu_callback_sniffer, app);
+        evil_bw16_target_menu_update_confirm(app);
     }
     
     view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
@@ -563,50 +709,43 @@ bool evil_bw16_scene_on_event_sniffer(void* context, SceneManagerEvent event) {
     if(event.type == SceneManagerEventTypeCustom) {
         uint32_t selection = event.event;
         
-        // Add debugging for selection issues
-        FURI_LOG_I("EvilBw16", "Target selection: event=%lu, network_count=%d", selection, app->network_count);
-        
-        if(selection < app->network_count) {
-            // Validate the network index before toggling
-            if(app->networks[selection].ssid[0] != '\0') {  // Ensure network exists
-                bool was_selected = app->networks[selection].selected;
-                app->networks[selection].selected = !was_selected;
-                
-                FURI_LOG_I("EvilBw16", "TOGGLE: User clicked menu[%lu] '%s' (device_idx=%d): %s -> %s", 
-                    selection, 
-                    app->networks[selection].ssid,
-                    app->networks[selection].device_index,
-                    was_selected ? "selected" : "unselected",
-                    app->networks[selection].selected ? "selected" : "unselected");
+        if(selection >= EvilBw16TargetMenuIndexNetwork) {
+            const EvilBw16NetworkHandle handle = selection - EvilBw16TargetMenuIndexNetwork;
+            evil_bw16_network_table_lock(app->networks);
+            EvilBw16Network* network = evil_bw16_network_table_get(app->networks, handle);
+            if(network && !evil_bw16_network_table_in_scan(app->networks, network)) {
+                // Listed as "[--]"; its device index is from an older scan
+                EVIL_BW16_LOG_W("Handle %u was not in the last scan, not toggled", handle);
+            } else if(network) {
+                evil_bw16_target_menu_set(app, handle, network, !network->selected);
+                evil_bw16_target_menu_update_confirm(app);
                 
-                // Refresh the scene by re-entering it (without adding to stack)
-                evil_bw16_scene_on_exit_sniffer(app);
-                evil_bw16_scene_on_enter_sniffer(app);
-                return true;
+                EVIL_BW16_LOG_I("TOGGLE: handle %u '%s' (device_idx=%d) -> %s", 
+                    handle, 
+                    evil_bw16_network_table_get_ssid(app->networks, network),
+                    network->device_index,
+                    network->selected ? "selected" : "unselected");
             } else {
-                FURI_LOG_W("EvilBw16", "Invalid network selection: index %lu has empty SSID", selection);
+                EVIL_BW16_LOG_W("Invalid network selection: handle %u is not in the scan list", handle);
             }
+            evil_bw16_network_table_unlock(app->networks);
+            return true;
         }
         
+        EVIL_BW16_LOG_I("Target selection: event=%lu, network_count=%u", selection, evil_bw16_network_table_count(app->networks));
+        
         switch(selection) {
             case EvilBw16TargetMenuIndexClearAll:
-                // Clear all selections
-                for(uint8_t i = 0; i < app->network_count; i++) {
-                    app->networks[i].selected = false;
-                }
-                // Refresh scene by re-entering it (without adding to stack)
-                evil_bw16_scene_on_exit_sniffer(app);
-                evil_bw16_scene_on_enter_sniffer(app);
-                return true;
-                
             case EvilBw16TargetMenuIndexSelectAll:
-                // Select all networks
-                for(uint8_t i = 0; i < app->network_count; i++) {
-                    app->networks[i].selected = true;
+                // Only rows whose selection changes are relabelled
+                evil_bw16_network_table_lock(app->networks);
+                for(size_t i = 0; i < evil_bw16_network_table_count(app->networks); i++) {
+                    const EvilBw16NetworkHandle handle = evil_bw16_network_table_at(app->networks, i);
+                    EvilBw16Network* network = evil_bw16_network_table_get(app->networks, handle);
+                    if(network) evil_bw16_target_menu_set(app, handle, network, selection == EvilBw16TargetMenuIndexSelectAll);
                 }
-                // Refresh scene by re-entering it (without adding to stack)
-                evil_bw16_scene_on_exit_sniffer(app);
-                evil_bw16_scene_on_enter_sniffer(app);
+                evil_bw16_network_table_unlock(app->networks);
+                evil_bw16_target_menu_update_confirm(app);
                 return true;
                 
             case EvilBw16TargetMenuIndexConfirm:
@@ -615,27 +754,31 @@ bool evil_bw16_scene_on_event_sniffer(void* context, SceneManagerEvent event) {
                 bool first = true;
                 int selected_count = 0;
                 
-                for(uint8_t i = 0; i < app->network_count; i++) {
-                    if(app->networks[i].selected) {
+                evil_bw16_network_table_lock(app->networks);
+                for(size_t i = 0; i < evil_bw16_network_table_count(app->networks); i++) {
+                    const EvilBw16Network* network = evil_bw16_network_table_get(app->networks, evil_bw16_network_table_at(app->networks, i));
+                    // A selection made before the network dropped out of the last scan waits
+                    if(network && network->selected && evil_bw16_network_table_in_scan(app->networks, network)) {
                         if(!first) {
                             furi_string_cat_str(target_string, ",");
                         }
-                        // FIX: BW16 device uses 1-based indexing, so add 1 to our 0-based menu index
-                        furi_string_cat_printf(target_string, "%d", i + 1);
+                        // BW16 device uses 1-based indexing on its 0-based scan index
+                        furi_string_cat_printf(target_string, "%d", network->device_index + 1);
                         first = false;
                         selected_count++;
                         
-                        FURI_LOG_I("EvilBw16", "CONFIRM: User selected menu[%d]: '%s' -> sending 1-based index=%d", 
-                            i, app->networks[i].ssid, i + 1);
+                        EVIL_BW16_LOG_I("CONFIRM: User selected '%s' -> sending 1-based index=%d", 
+                            evil_bw16_network_table_get_ssid(app->networks, network), network->device_index + 1);
                     }
                 }
+                evil_bw16_network_table_unlock(app->networks);
                 
                 if(furi_string_size(target_string) > 0) {
                     // Send target command to Arduino
                     FuriString* set_target_cmd = furi_string_alloc();
                     furi_string_printf(set_target_cmd, "set target %s", furi_string_get_cstr(target_string));
                     
-                    FURI_LOG_I("EvilBw16", "Sending target command: '%s' (%d targets)", 
+                    EVIL_BW16_LOG_I("Sending target command: '%s' (%d targets)", 
                         furi_string_get_cstr(set_target_cmd), selected_count);
                     
                     evil_bw16_send_command(app, furi_string_get_cstr(set_target_cmd));
@@ -663,67 +806,32 @@ void evil_bw16_scene_on_exit_sniffer(void* context) {
 }
 
 // Scene: Sniffer Results
+// Live counters for [MGMT]/[DATA] frames; totals follow each packet notification and
+// rates are resampled on every tick
 void evil_bw16_scene_on_enter_sniffer_results(void* context) {
     EvilBw16App* app = context;
-    
-    evil_bw16_clear_log(app);
-    furi_string_printf(app->log_string, "Packet Sniffer Active\nMode: ");
-    
-    switch(app->sniffer_state.mode) {
-        case EvilBw16SniffModeAll:
-            furi_string_cat_printf(app->log_string, "ALL");
-            break;
-        case EvilBw16SniffModeBeacon:
-            furi_string_cat_printf(app->log_string, "BEACON");
-            break;
-        case EvilBw16SniffModeProbe:
-            furi_string_cat_printf(app->log_string, "PROBE");
-            break;
-        case EvilBw16SniffModeDeauth:
-            furi_string_cat_printf(app->log_string, "DEAUTH");
-            break;
-        case EvilBw16SniffModeEapol:
-            furi_string_cat_printf(app->log_string, "EAPOL");
-            break;
-        case EvilBw16SniffModePwnagotchi:
-            furi_string_cat_printf(app->log_string, "PWNAGOTCHI");
-            break;
-    }
-    
-    furi_string_cat_printf(app->log_string, "\nChannel: %d\nHopping: %s\n\n", 
-        app->sniffer_state.channel,
-        app->sniffer_state.hopping ? "ON" : "OFF"
-    );
-    
-    text_box_set_text(app->text_box, furi_string_get_cstr(app->log_string));
-    text_box_set_focus(app->text_box, TextBoxFocusEnd);
-    view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTextBox);
+    evil_bw16_sniffer_view_reset(app->sniffer_view, &app->sniffer_counters);
+    view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewSnifferStats);
 }
 
 bool evil_bw16_scene_on_event_sniffer_results(void* context, SceneManagerEvent event) {
     EvilBw16App* app = context;
-    UNUSED(event);
     
-    // For now, just show static content without reading UART
-    static uint32_t last_update = 0;
-    if(furi_get_tick() - last_update > 2000) { // Update every 2 seconds
-        app->sniffer_state.packet_count++;
-        evil_bw16_append_log(app, "Packet capture simulation running...");
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->log_string));
-        text_box_set_focus(app->text_box, TextBoxFocusEnd);
-        last_update = furi_get_tick();
+    if(event.type == SceneManagerEventTypeTick) {
+        evil_bw16_sniffer_view_update(app->sniffer_view, &app->sniffer_counters, true);
+        return true;
+    } else if(event.type == SceneManagerEventTypeCustom && event.event == EvilBw16EventPacketReceived) {
+        evil_bw16_sniffer_view_update(app->sniffer_view, &app->sniffer_counters, false);
+        return true;
     }
     
     return false;
 }
 
 void evil_bw16_scene_on_exit_sniffer_results(void* context) {
-    EvilBw16App* app = context;
-    text_box_reset(app->text_box);
+    UNUSED(context);
 }
 
-
-
 // Scene: Config
 void evil_bw16_scene_on_enter_config(void* context) {
     EvilBw16App* app = context;
@@ -754,14 +862,59 @@ void evil_bw16_scene_on_enter_config(void* context) {
     snprintf(temp_str, sizeof(temp_str), "GPIO Pins: %s", app->config.gpio_pins == EvilBw16GpioPins13_14 ? "13/14" : "15/16");
     submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexGpioPins, evil_bw16_submenu_callback_attacks, app);
     
+    // Show the rate actually in use when negotiation fell back
+    const bool negotiating = evil_bw16_uart_is_negotiating(app->uart_worker);
+    uint32_t link_baud = evil_bw16_uart_get_baud_rate(app->uart_worker);
+    if(negotiating) {
+        snprintf(temp_str, sizeof(temp_str), "Baud: %lu (negotiating)", app->config.baud_rate);
+    } else if(link_baud && link_baud != app->config.baud_rate) {
+        snprintf(temp_str, sizeof(temp_str), "Baud: %lu (at %lu)", app->config.baud_rate, link_baud);
+    } else {
+        snprintf(temp_str, sizeof(temp_str), "Baud: %lu", app->config.baud_rate);
+    }
+    submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexBaudRate, evil_bw16_submenu_callback_attacks, app);
+    
+    snprintf(temp_str, sizeof(temp_str), "RX Buffer: %s", app->config.adaptive_rx_buffer ? "Adaptive" : "Fixed");
+    submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexRxBuffer, evil_bw16_submenu_callback_attacks, app);
+    
+    static const char* const log_level_names[] = {"Off", "Error", "Warn", "Info", "Debug"};
+    snprintf(temp_str, sizeof(temp_str), "Log Level: %s", log_level_names[app->config.log_level]);
+    submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexLogLevel, evil_bw16_submenu_callback_attacks, app);
+    
+    // Show when the BW16 did not take binary framing
+    if(negotiating) {
+        snprintf(temp_str, sizeof(temp_str), "Link Protocol: %s (negotiating)", app->config.binary_protocol ? "Binary" : "Text");
+    } else if(app->config.binary_protocol && !evil_bw16_uart_is_binary(app->uart_worker)) {
+        snprintf(temp_str, sizeof(temp_str), "Link Protocol: Binary (at Text)");
+    } else {
+        snprintf(temp_str, sizeof(temp_str), "Link Protocol: %s", app->config.binary_protocol ? "Binary" : "Text");
+    }
+    submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexLinkProtocol, evil_bw16_submenu_callback_attacks, app);
+    
+    snprintf(temp_str, sizeof(temp_str), "Scan List RAM: %u KB", app->config.network_ram_kb);
+    submenu_add_item(app->submenu, temp_str, EvilBw16ConfigMenuIndexNetworkRam, evil_bw16_submenu_callback_attacks, app);
+    
     submenu_add_item(app->submenu, "Send Config to Device", EvilBw16ConfigMenuIndexSendToDevice, evil_bw16_submenu_callback_attacks, app);
     
+    // Stay on the item that last changed the link when the menu is rebuilt
+    submenu_set_selected_item(app->submenu, scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneConfig));
+    
     view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
 }
 
 bool evil_bw16_scene_on_event_config(void* context, SceneManagerEvent event) {
     EvilBw16App* app = context;
     
+    // Worker events arrive here too; only the end of a negotiation concerns this scene,
+    // the rest must never be taken for menu selections
+    if(event.type == SceneManagerEventTypeCustom && event.event < EvilBw16ConfigMenuIndexCycleDelay) {
+        if(event.event != EvilBw16EventLinkReady) return false;
+        // Negotiation finished; show the rate and framing it settled on
+        evil_bw16_scene_on_exit_config(app);
+        evil_bw16_scene_on_enter_config(app);
+        return true;
+    }
+    
     if(event.type == SceneManagerEventTypeCustom) {
         switch(event.event) {
             case EvilBw16ConfigMenuIndexCycleDelay:
@@ -866,6 +1019,59 @@ bool evil_bw16_scene_on_event_config(void* context, SceneManagerEvent event) {
                 evil_bw16_scene_on_enter_config(app);
                 return true;
                 
+            case EvilBw16ConfigMenuIndexBaudRate:
+                // Cycle the preferred rate and renegotiate the link
+                if(app->config.baud_rate < 460800) {
+                    app->config.baud_rate = 460800;
+                } else if(app->config.baud_rate < 921600) {
+                    app->config.baud_rate = 921600;
+                } else {
+                    app->config.baud_rate = EVIL_BW16_UART_BAUD_RATE;
+                }
+                
+                // The worker renegotiates; EvilBw16EventLinkReady refreshes the menu when it is done
+                evil_bw16_uart_renegotiate(app->uart_worker);
+                scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneConfig, EvilBw16ConfigMenuIndexBaudRate);
+                
+                evil_bw16_scene_on_exit_config(app);
+                evil_bw16_scene_on_enter_config(app);
+                return true;
+                
+            case EvilBw16ConfigMenuIndexRxBuffer:
+                // Toggle adaptive RX ring growth; the worker picks it up on its next check
+                app->config.adaptive_rx_buffer = !app->config.adaptive_rx_buffer;
+                evil_bw16_scene_on_exit_config(app);
+                evil_bw16_scene_on_enter_config(app);
+                return true;
+                
+            case EvilBw16ConfigMenuIndexLogLevel:
+                // Cycle Off -> Error -> Warn -> Info -> Debug; takes effect immediately
+                evil_bw16_set_log_level(app, (app->config.log_level + 1) % (EVIL_BW16_LOG_LEVEL_DEBUG + 1));
+                evil_bw16_scene_on_exit_config(app);
+                evil_bw16_scene_on_enter_config(app);
+                return true;
+                
+            case EvilBw16ConfigMenuIndexLinkProtocol:
+                // Toggle framed BW16 output and renegotiate the link
+                app->config.binary_protocol = !app->config.binary_protocol;
+                
+                evil_bw16_uart_renegotiate(app->uart_worker);
+                scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneConfig, EvilBw16ConfigMenuIndexLinkProtocol);
+                
+                evil_bw16_scene_on_exit_config(app);
+                evil_bw16_scene_on_enter_config(app);
+                return true;
+                
+            case EvilBw16ConfigMenuIndexNetworkRam:
+                // Cycle 4 -> 8 -> 16 -> 32 KB; resizing empties the scan list
+                app->config.network_ram_kb = app->config.network_ram_kb >= 32 ? 4 : app->config.network_ram_kb * 2;
+                evil_bw16_network_table_set_budget(app->networks, app->config.network_ram_kb * 1024);
+                app->attack_state.num_targets = 0;
+                
+                evil_bw16_scene_on_exit_config(app);
+                evil_bw16_scene_on_enter_config(app);
+                return true;
+                
             case EvilBw16ConfigMenuIndexSendToDevice:
                 // Send all config settings to BW16
                 evil_bw16_send_config_to_device(app);
@@ -914,6 +1120,50 @@ void evil_bw16_scene_on_enter_device_info(void* context) {
     furi_string_cat_printf(app->text_box_string, "- Real-time packet monitoring\n");
     furi_string_cat_printf(app->text_box_string, "- Multi-target selection\n\n");
     
+    furi_string_cat_printf(app->text_box_string, "=== LINK STATS ===\n\n");
+    EvilBw16UartStats uart_stats;
+    evil_bw16_uart_get_stats(app->uart_worker, &uart_stats);
+    furi_string_cat_printf(app->text_box_string, "RX ring: %lu B (%s)\n", uart_stats.ring_size,
+        app->config.adaptive_rx_buffer ? "adaptive" : "fixed");
+    furi_string_cat_printf(app->text_box_string, "High-water: %lu B\n", uart_stats.high_water);
+    furi_string_cat_printf(app->text_box_string, "Dropped bytes: %lu\n", uart_stats.dropped_bytes);
+    furi_string_cat_printf(app->text_box_string, "Truncated lines: %lu\n", uart_stats.truncated_lines);
+    if(uart_stats.ring_grows) {
+        furi_string_cat_printf(app->text_box_string, "Ring grown: %lu times\n", uart_stats.ring_grows);
+    }
+    furi_string_cat_printf(app->text_box_string, "Protocol: %s\n", uart_stats.binary_protocol ? "binary" : "text");
+    if(uart_stats.frames || uart_stats.frame_crc_errors) {
+        furi_string_cat_printf(app->text_box_string, "Frames: %lu (%lu bad CRC)\n", uart_stats.frames, uart_stats.frame_crc_errors);
+    }
+    if(uart_stats.proto_fallbacks) {
+        furi_string_cat_printf(app->text_box_string, "Fell back to text: %lu times\n", uart_stats.proto_fallbacks);
+    }
+    furi_string_cat_printf(app->text_box_string, "UI wakeups: %lu\n", evil_bw16_notifier_get_wakeups(app->notifier));
+    furi_string_cat_printf(app->text_box_string, "UI events coalesced: %lu\n", evil_bw16_notifier_get_suppressed(app->notifier));
+    EvilBw16NetworkTableStats table_stats;
+    evil_bw16_network_table_get_stats(app->networks, &table_stats);
+    furi_string_cat_printf(app->text_box_string, "Scan list: %u/%u networks\n", table_stats.count, table_stats.capacity);
+    furi_string_cat_printf(app->text_box_string, "Scan list RAM: %u/%u B\n", table_stats.bytes, table_stats.budget);
+    furi_string_cat_printf(app->text_box_string, "SSID arena: %u B (%lu shared)\n", table_stats.ssid_bytes, table_stats.ssids_shared);
+    furi_string_cat_printf(app->text_box_string, "Duplicate BSSIDs: %lu\n", table_stats.duplicates);
+    furi_string_cat_printf(app->text_box_string, "Heard again later: %lu\n", table_stats.merged);
+    if(table_stats.evicted) {
+        furi_string_cat_printf(app->text_box_string, "Dropped for room: %lu\n", table_stats.evicted);
+    }
+    if(table_stats.rejected) {
+        furi_string_cat_printf(app->text_box_string, "Over budget: %lu networks\n", table_stats.rejected);
+    }
+    furi_string_cat_printf(app->text_box_string, "\n");
+    EvilBw16LineFilter* webui_filter = evil_bw16_uart_get_webui_filter(app->uart_worker);
+    furi_string_cat_printf(app->text_box_string, "WebUI lines filtered:\n");
+    for(size_t i = 0; i < evil_bw16_filter_get_rule_count(webui_filter); i++) {
+        uint32_t lines, bytes;
+        evil_bw16_filter_get_stats(webui_filter, i, &lines, &bytes);
+        furi_string_cat_printf(app->text_box_string, "%s: %lu (%lu B)\n",
+            evil_bw16_filter_get_rule_pattern(webui_filter, i), lines, bytes);
+    }
+    furi_string_cat_printf(app->text_box_string, "\n");
+    
     furi_string_cat_printf(app->text_box_string, "App developed by dag nazty\n");
     furi_string_cat_printf(app->text_box_string, "BW16 firmware by 7h30th3r0n3");
     
@@ -933,6 +1183,22 @@ void evil_bw16_scene_on_exit_device_info(void* context) {
 }
 
 // Scene: UART Terminal
+// Status line of the terminal view; the log itself is drawn straight from the log store
+static void evil_bw16_uart_terminal_show(EvilBw16App* app) {
+    char header[32];
+    const char* gpio_pins = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "13/14" : "15/16";
+#ifdef EVIL_BW16_DEVTOOLS
+    if(evil_bw16_sim_is_running(app->simulator)) {
+        snprintf(header, sizeof(header), "UART %lu  Simulated", evil_bw16_uart_get_baud_rate(app->uart_worker));
+    } else
+#endif
+    {
+        snprintf(header, sizeof(header), "UART %lu  GPIO %s", evil_bw16_uart_get_baud_rate(app->uart_worker), gpio_pins);
+    }
+    evil_bw16_terminal_view_reset(app->terminal_view, header);
+    app->terminal_log_seq = evil_bw16_log_store_get_seq(app->log_store);
+}
+
 void evil_bw16_scene_on_enter_uart_terminal(void* context) {
     EvilBw16App* app = context;
     
@@ -952,25 +1218,9 @@ void evil_bw16_scene_on_enter_uart_terminal(void* context) {
         );
         view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTextInput);
     } else {
-        // Terminal display mode - show UART communication
-        // Initialize UART log with header
-        furi_string_reset(app->uart_log_string);
-        furi_string_printf(app->uart_log_string, "=== UART TERMINAL ===\n");
-        const char* gpio_pins = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "13↔14" : "15↔16";
-        furi_string_cat_printf(app->uart_log_string, "115200 baud, GPIO %s\n", gpio_pins);
-        furi_string_cat_printf(app->uart_log_string, "BW16 PB2←TX  PB1→RX\n");
-        furi_string_cat_printf(app->uart_log_string, "Status: LISTENING...\n\n");
-        
-        // Immediately start displaying any existing log content
-        if(furi_string_size(app->log_string) > 0) {
-            furi_string_cat(app->uart_log_string, app->log_string);
-        } else {
-            furi_string_cat_printf(app->uart_log_string, "[Waiting for UART data...]\n");
-        }
-        
-        text_box_set_text(app->text_box, furi_string_get_cstr(app->uart_log_string));
-        text_box_set_focus(app->text_box, TextBoxFocusEnd);
-        view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTextBox);
+        // Terminal display mode - show UART communication, starting with any existing log content
+        evil_bw16_uart_terminal_show(app);
+        view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTerminal);
         
         // Note: Live updates are now triggered directly by UART worker when data arrives
     }
@@ -985,47 +1235,12 @@ bool evil_bw16_scene_on_event_uart_terminal(void* context, SceneManagerEvent eve
     
     // Handle refresh timer event
     if(event.type == SceneManagerEventTypeCustom && event.event == EvilBw16EventUartTerminalRefresh) {
-        // Only update if log actually changed to reduce CPU usage
-        static size_t last_log_size = 0;
-        size_t current_log_size = furi_string_size(app->log_string);
+        // Only redraw if lines were added or cleared since the last frame
+        uint32_t log_seq = evil_bw16_log_store_get_seq(app->log_store);
         
-        if(current_log_size != last_log_size) {
-            // Create display string with header + current log content
-            furi_string_reset(app->uart_log_string);
-            furi_string_printf(app->uart_log_string, "=== UART TERMINAL ===\n");
-            const char* gpio_pins = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "13↔14" : "15↔16";
-            furi_string_cat_printf(app->uart_log_string, "115200 baud, GPIO %s\n", gpio_pins);
-            furi_string_cat_printf(app->uart_log_string, "BW16 PB2←TX  PB1→RX\n");
-            furi_string_cat_printf(app->uart_log_string, "Status: ACTIVE\n\n");
-            
-            // Add current log content (which is updated by UART worker)
-            if(current_log_size > 0) {
-                furi_string_cat(app->uart_log_string, app->log_string);
-            } else {
-                furi_string_cat_printf(app->uart_log_string, "[Waiting for UART data...]\n");
-            }
-            
-            // Limit total size to prevent memory issues
-            if(furi_string_size(app->uart_log_string) > EVIL_BW16_TEXT_BOX_STORE_SIZE - 512) {
-                // Keep header and recent content
-                const char* gpio_pins_str = (app->config.gpio_pins == EvilBw16GpioPins13_14) ? "13↔14" : "15↔16";
-                char header[256];
-                snprintf(header, sizeof(header), "=== UART TERMINAL ===\n115200 baud, GPIO %s\nBW16 PB2←TX  PB1→RX\nStatus: ACTIVE\n\n[...truncated...]\n", gpio_pins_str);
-                size_t keep_size = EVIL_BW16_TEXT_BOX_STORE_SIZE / 2;
-                
-                // Get recent content from app->log_string
-                if(current_log_size > keep_size) {
-                    furi_string_set_str(app->uart_log_string, header);
-                    const char* recent_content = furi_string_get_cstr(app->log_string) + (current_log_size - keep_size);
-                    furi_string_cat_str(app->uart_log_string, recent_content);
-                }
-            }
-            
-            // Update the display
-            text_box_set_text(app->text_box, furi_string_get_cstr(app->uart_log_string));
-            text_box_set_focus(app->text_box, TextBoxFocusEnd);
-            
-            last_log_size = current_log_size;
+        if(log_seq != app->terminal_log_seq) {
+            evil_bw16_terminal_view_update(app->terminal_view);
+            app->terminal_log_seq = log_seq;
         }
         
         return true;
@@ -1035,6 +1250,182 @@ bool evil_bw16_scene_on_event_uart_terminal(void* context, SceneManagerEvent eve
 }
 
 void evil_bw16_scene_on_exit_uart_terminal(void* context) {
+    UNUSED(context);
+} 
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Scene: Replay Benchmark
+// Menu indices start high so they can't be confused with worker events (scan complete etc.)
+enum EvilBw16ReplayMenuIndex {
+    EvilBw16ReplayMenuIndexCapture = 200,
+    EvilBw16ReplayMenuIndexCaptureTimed,
+    EvilBw16ReplayMenuIndexCaptureFast,
+    EvilBw16ReplayMenuIndex115200,
+    EvilBw16ReplayMenuIndex460800,
+    EvilBw16ReplayMenuIndex921600,
+    EvilBw16ReplayMenuIndexMax,
+    EvilBw16ReplayMenuIndexProtoBench,
+    EvilBw16ReplayMenuIndexParserBench,
+    EvilBw16ReplayMenuIndexSimScanBench,
+    EvilBw16ReplayMenuIndexSimSniffBench,
+    EvilBw16ReplayMenuIndexSimToggle,
+    EvilBw16ReplayMenuIndexSimNetworks,
+    EvilBw16ReplayMenuIndexSimFrameRate,
+};
+
+static const uint8_t sim_network_options[] = {10, 20, 50};
+static const uint32_t sim_frame_rate_options[] = {50, 200, 1000, 5000};
+
+static void evil_bw16_replay_menu_build(EvilBw16App* app) {
+    submenu_reset(app->submenu);
+    submenu_set_header(app->submenu, "Capture & Replay");
+    
+    if(evil_bw16_uart_capture_is_active(app->uart_worker)) {
+        char label[32];
+        snprintf(label, sizeof(label), "Stop Capture (%luB)", evil_bw16_uart_capture_get_bytes(app->uart_worker));
+        submenu_add_item(app->submenu, label, EvilBw16ReplayMenuIndexCapture, evil_bw16_submenu_callback_main_menu, app);
+    } else {
+        submenu_add_item(app->submenu, "Start RX Capture", EvilBw16ReplayMenuIndexCapture, evil_bw16_submenu_callback_main_menu, app);
+    }
+    submenu_add_item(app->submenu, "Capture: Recorded Timing", EvilBw16ReplayMenuIndexCaptureTimed, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Capture: Max Speed", EvilBw16ReplayMenuIndexCaptureFast, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Text Log: 115200 baud", EvilBw16ReplayMenuIndex115200, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Text Log: 460800 baud", EvilBw16ReplayMenuIndex460800, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Text Log: 921600 baud", EvilBw16ReplayMenuIndex921600, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Text Log: Max Speed", EvilBw16ReplayMenuIndexMax, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Protocol: Text vs Binary", EvilBw16ReplayMenuIndexProtoBench, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Parser: Scan Lines", EvilBw16ReplayMenuIndexParserBench, evil_bw16_submenu_callback_main_menu, app);
+    
+    char label[32];
+    submenu_add_item(app->submenu, evil_bw16_sim_is_running(app->simulator) ? "Simulator: On" : "Simulator: Off", EvilBw16ReplayMenuIndexSimToggle, evil_bw16_submenu_callback_main_menu, app);
+    snprintf(label, sizeof(label), "Sim Networks: %u", evil_bw16_sim_get_network_count(app->simulator));
+    submenu_add_item(app->submenu, label, EvilBw16ReplayMenuIndexSimNetworks, evil_bw16_submenu_callback_main_menu, app);
+    snprintf(label, sizeof(label), "Sim Frame Rate: %lu/s", evil_bw16_sim_get_frame_rate(app->simulator));
+    submenu_add_item(app->submenu, label, EvilBw16ReplayMenuIndexSimFrameRate, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Sim: Scan Latency", EvilBw16ReplayMenuIndexSimScanBench, evil_bw16_submenu_callback_main_menu, app);
+    submenu_add_item(app->submenu, "Sim: Sniff Throughput", EvilBw16ReplayMenuIndexSimSniffBench, evil_bw16_submenu_callback_main_menu, app);
+}
+
+void evil_bw16_scene_on_enter_replay(void* context) {
     EvilBw16App* app = context;
+    
+    // State 0: pick a source, state 1: running or showing the report
+    scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneReplay, 0);
+    
+    // The simulator outlives the scene so the rest of the app can use it
+    if(!app->simulator) {
+        app->simulator = evil_bw16_sim_alloc(app);
+    }
+    evil_bw16_replay_menu_build(app);
+    view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewMainMenu);
+}
+
+bool evil_bw16_scene_on_event_replay(void* context, SceneManagerEvent event) {
+    EvilBw16App* app = context;
+    
+    if(event.type != SceneManagerEventTypeCustom) return false;
+    
+    uint32_t state = scene_manager_get_scene_state(app->scene_manager, EvilBw16SceneReplay);
+    
+    if(state == 0 && event.event == EvilBw16ReplayMenuIndexCapture) {
+        if(evil_bw16_uart_capture_is_active(app->uart_worker)) {
+            evil_bw16_uart_capture_stop(app->uart_worker);
+        } else if(!evil_bw16_uart_capture_start(app->uart_worker, EVIL_BW16_CAPTURE_PATH)) {
+            evil_bw16_show_popup(app, "Capture", "Could not open\ncapture file");
+            return true;
+        }
+        evil_bw16_replay_menu_build(app);
+        submenu_set_selected_item(app->submenu, EvilBw16ReplayMenuIndexCapture);
+        return true;
+    } else if(state == 0 && event.event >= EvilBw16ReplayMenuIndexSimToggle && event.event <= EvilBw16ReplayMenuIndexSimFrameRate) {
+        EvilBw16Sim* sim = app->simulator;
+        uint8_t networks = evil_bw16_sim_get_network_count(sim);
+        uint32_t frame_rate = evil_bw16_sim_get_frame_rate(sim);
+        
+        if(event.event == EvilBw16ReplayMenuIndexSimToggle) {
+            if(evil_bw16_sim_is_running(sim)) {
+                evil_bw16_sim_stop(sim);
+            } else if(!app->uart_worker) {
+                evil_bw16_show_popup(app, "Simulator", "UART not available");
+                return true;
+            } else {
+                evil_bw16_sim_start(sim);
+            }
+        } else if(event.event == EvilBw16ReplayMenuIndexSimNetworks) {
+            size_t i = 0;
+            while(i < COUNT_OF(sim_network_options) && sim_network_options[i] != networks) i++;
+            networks = sim_network_options[(i + 1) % COUNT_OF(sim_network_options)];
+        } else {
+            size_t i = 0;
+            while(i < COUNT_OF(sim_frame_rate_options) && sim_frame_rate_options[i] != frame_rate) i++;
+            frame_rate = sim_frame_rate_options[(i + 1) % COUNT_OF(sim_frame_rate_options)];
+        }
+        evil_bw16_sim_configure(sim, networks, frame_rate, evil_bw16_sim_get_scan_ms(sim));
+        
+        evil_bw16_replay_menu_build(app);
+        submenu_set_selected_item(app->submenu, event.event);
+        return true;
+    } else if(state == 0 && event.event >= EvilBw16ReplayMenuIndexCaptureTimed && event.event <= EvilBw16ReplayMenuIndexSimSniffBench) {
+        static const uint32_t rates[] = {115200, 460800, 921600, 0};
+        
+        if(!app->replay) {
+            app->replay = evil_bw16_replay_alloc(app);
+        }
+        const bool sim_bench = event.event == EvilBw16ReplayMenuIndexSimScanBench || event.event == EvilBw16ReplayMenuIndexSimSniffBench;
+        const bool parser_bench = event.event == EvilBw16ReplayMenuIndexParserBench;
+        if(!sim_bench && !parser_bench && evil_bw16_sim_is_running(app->simulator)) {
+            evil_bw16_show_popup(app, "Replay", "Turn the simulator\noff first");
+            return true;
+        }
+        bool started;
+        if(parser_bench) {
+            started = evil_bw16_replay_start_parser_bench(app->replay);
+        } else if(sim_bench) {
+            started = evil_bw16_replay_start_sim_bench(app->replay, event.event == EvilBw16ReplayMenuIndexSimSniffBench);
+        } else if(event.event == EvilBw16ReplayMenuIndexProtoBench) {
+            started = evil_bw16_replay_start_proto_bench(app->replay);
+        } else if(event.event == EvilBw16ReplayMenuIndexCaptureTimed || event.event == EvilBw16ReplayMenuIndexCaptureFast) {
+            started = evil_bw16_replay_start_capture(app->replay, event.event == EvilBw16ReplayMenuIndexCaptureTimed);
+        } else {
+            started = evil_bw16_replay_start(app->replay, rates[event.event - EvilBw16ReplayMenuIndex115200]);
+        }
+        if(!started) {
+            evil_bw16_show_popup(app, "Replay", "UART not available");
+            return true;
+        }
+        
+        scene_manager_set_scene_state(app->scene_manager, EvilBw16SceneReplay, 1);
+        furi_string_set(
+            app->text_box_string,
+            parser_bench ? "Parsing scan lines..." :
+            sim_bench    ? "Running against the\nsimulated BW16..." :
+                           "Replaying capture...\n\nLive UART input is paused\nuntil the run completes.");
+        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_string));
+        view_dispatcher_switch_to_view(app->view_dispatcher, EvilBw16ViewTextBox);
+        return true;
+    } else if(state == 1 && event.event == EvilBw16EventReplayDone) {
+        // Thread has finished; join it so the next run can start
+        evil_bw16_replay_stop(app->replay);
+        evil_bw16_replay_format_report(app->replay, app->text_box_string);
+        text_box_set_text(app->text_box, furi_string_get_cstr(app->text_box_string));
+        return true;
+    }
+    
+    // Swallow worker events (scan complete, refreshes) while this scene is up
+    return true;
+}
+
+void evil_bw16_scene_on_exit_replay(void* context) {
+    EvilBw16App* app = context;
+    
+    // Leaving mid-run aborts the replay and hands RX back to the UART.
+    // A capture keeps recording in the background until stopped here or the app exits.
+    if(app->replay) {
+        evil_bw16_replay_free(app->replay);
+        app->replay = NULL;
+    }
+    
+    submenu_reset(app->submenu);
     text_box_reset(app->text_box);
-} 
+}
+#endif // EVIL_BW16_DEVTOOLS
@@ -0,0 +1,464 @@
+#include "evil_bw16.h"
+#include <stdarg.h>
+
+#ifdef EVIL_BW16_DEVTOOLS
+
+// Simulated BW16.
+//
+// Stands in for the module so scans, sniffing and the terminal can be exercised without
+// hardware. While it runs, async RX is paused and commands go to the simulator instead of
+// the pins (see evil_bw16_uart_set_tx_tap). Its thread answers the way the firmware does,
+// echo included, by injecting into the worker's RX ring. Output is paced at the link's
+// byte rate and overruns are dropped like in the ISR, so the worker sees what the wire
+// would deliver. Networks come from the device stand-in in evil_bw16_proto.c, with the
+// RSSI moving a little between scans. The simulator starts in the link's current
+// framing and follows "set proto", so both the text and binary protocol can be driven.
+
+#define SIM_COMMAND_MAX (64)
+#define SIM_QUEUE_DEPTH (8)
+#define SIM_SEED (0xB16)
+#define SIM_HOP_INTERVAL_MS (250)
+#define SIM_RSSI_JITTER (4)        // +- dBm between scans
+#define SIM_FRAMES_PER_PASS (32)   // Sniffed frames generated before commands are checked again
+#define SIM_LINE_MAX (128)
+
+typedef enum {
+    SimSniffAll,
+    SimSniffBeacon,
+    SimSniffProbe,
+    SimSniffDeauth,
+    SimSniffEapol,
+} SimSniffMode;
+
+static const struct {
+    const char* name;
+    SimSniffMode mode;
+} sim_sniff_modes[] = {
+    {"all", SimSniffAll},
+    {"beacon", SimSniffBeacon},
+    {"probe", SimSniffProbe},
+    {"deauth", SimSniffDeauth},
+    {"eapol", SimSniffEapol},
+};
+
+static const uint8_t sim_hop_channels[] = {1, 6, 11, 2, 7, 12, 3, 8, 13, 36, 40, 44, 48, 149, 153, 157, 161};
+
+typedef struct {
+    char text[SIM_COMMAND_MAX];
+} SimCommand;
+
+struct EvilBw16Sim {
+    EvilBw16App* app;
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    volatile bool running;
+
+    // Settings, see evil_bw16_sim_configure()
+    uint8_t network_count;
+    uint32_t frame_rate;  // Sniffed frames per second offered
+    uint32_t scan_ms;     // Time a scan takes before results are printed
+
+    // Device state, sim thread only
+    bool binary;
+    bool was_binary;  // Link framing when the simulator took over
+    bool sniffing;
+    SimSniffMode sniff_mode;
+    bool hopping;
+    uint8_t hop_index;
+    uint8_t channel;
+    uint32_t rng;
+    uint32_t sniff_start;
+    uint32_t sniff_generated;
+    uint32_t last_hop;
+
+    // Output pacing
+    uint32_t pace_start;
+    uint32_t pace_bytes;
+
+    EvilBw16SimStats stats;
+};
+
+static uint32_t sim_random(EvilBw16Sim* sim) {
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+// Hand bytes to the worker no faster than the line would carry them
+static void sim_write(EvilBw16Sim* sim, const uint8_t* data, size_t len) {
+    EvilBw16UartWorker* worker = sim->app->uart_worker;
+    const uint32_t baud = evil_bw16_uart_get_baud_rate(worker);
+    size_t pos = 0;
+
+    // An idle line earns no credit: once earlier output has gone out, restart the
+    // schedule one tick back
+    const uint32_t now = furi_get_tick();
+    if(sim->pace_bytes < (uint64_t)(now - sim->pace_start) * baud / 10000) {
+        sim->pace_start = now - 1;
+        sim->pace_bytes = 0;
+    }
+
+    while(pos < len && sim->running) {
+        // 10 bits per byte at 8N1
+        const uint32_t due = (uint32_t)((uint64_t)(furi_get_tick() - sim->pace_start) * baud / 10000);
+        if(sim->pace_bytes >= due) {
+            furi_delay_tick(1);
+            continue;
+        }
+        const size_t count = MIN(len - pos, (size_t)(due - sim->pace_bytes));
+        evil_bw16_uart_inject_rx(worker, data + pos, count, true);
+        pos += count;
+        sim->pace_bytes += count;
+    }
+    sim->stats.bytes += pos;
+}
+
+// One line of output, framed as Text in binary mode
+static void sim_write_text(EvilBw16Sim* sim, const char* text, size_t len) {
+    uint8_t out[EVIL_BW16_PROTO_MAX_FRAME];
+    if(sim->binary) {
+        len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)text, len, out, sizeof(out));
+    } else {
+        len = MIN(len, sizeof(out) - 1);
+        memcpy(out, text, len);
+        out[len++] = '\n';
+    }
+    sim_write(sim, out, len);
+}
+
+static void sim_printf(EvilBw16Sim* sim, const char* format, ...) {
+    char line[SIM_LINE_MAX];
+    va_list args;
+    va_start(args, format);
+    const int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if(len > 0) sim_write_text(sim, line, MIN((size_t)len, sizeof(line) - 1));
+}
+
+// Network i as seen by the current scan
+static void sim_network(EvilBw16Sim* sim, uint8_t index, EvilBw16ProtoScanResult* network) {
+    evil_bw16_proto_standin_network(SIM_SEED, index, network);
+    const int rssi = network->rssi + (int)(sim_random(sim) % (2 * SIM_RSSI_JITTER + 1)) - SIM_RSSI_JITTER;
+    network->rssi = (int8_t)CLAMP(rssi, -20, -95);
+}
+
+static void sim_format_bssid(const uint8_t* bssid, char* out, size_t size) {
+    snprintf(out, size, "%02X:%02X:%02X:%02X:%02X:%02X", bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+}
+
+static void sim_scan(EvilBw16Sim* sim) {
+    sim_printf(sim, "[CMD] Starting WiFi scan...");
+
+    // The radio is busy for the scan time; commands wait in the queue meanwhile
+    const uint32_t start = furi_get_tick();
+    while(sim->running && furi_get_tick() - start < sim->scan_ms) {
+        furi_delay_tick(MIN(sim->scan_ms - (furi_get_tick() - start), 50UL));
+    }
+
+    sim_printf(sim, "[INFO] Index\tSSID\tBSSID\tChannel\tRSSI\tFrequency");
+
+    EvilBw16ProtoScanResult network;
+    uint8_t out[EVIL_BW16_PROTO_MAX_FRAME];
+    for(uint8_t i = 0; i < sim->network_count && sim->running; i++) {
+        sim_network(sim, i, &network);
+        const size_t len = sim->binary ? evil_bw16_proto_encode_scan_result(&network, out, sizeof(out)) :
+                                         evil_bw16_proto_format_scan_text(&network, (char*)out, sizeof(out));
+        sim_write(sim, out, len);
+    }
+
+    if(sim->binary) {
+        const size_t len = evil_bw16_proto_encode(EvilBw16ProtoTypeScanDone, &sim->network_count, 1, out, sizeof(out));
+        sim_write(sim, out, len);
+    } else {
+        sim_printf(sim, "[INFO] Scan results printed");
+    }
+    sim->stats.scans++;
+}
+
+// One sniffed frame from a random known network
+static void sim_sniff_frame(EvilBw16Sim* sim) {
+    // Management subtype numbers, as in the frame control field
+    static const uint8_t any_subtypes[] = {8, 8, 8, 8, 4, 5, 11, 0, 12, 10, 13};
+    static const uint8_t probe_subtypes[] = {4, 5};
+    static const uint8_t deauth_subtypes[] = {12, 10};
+    static const char* const mgmt_names[16] = {
+        [0] = "Assoc Request", [4] = "Probe Request", [5] = "Probe Response", [8] = "Beacon",
+        [10] = "Disassoc", [11] = "Auth", [12] = "Deauth", [13] = "Action",
+    };
+
+    EvilBw16ProtoScanResult network;
+    sim_network(sim, sim_random(sim) % MAX(sim->network_count, 1), &network);
+
+    EvilBw16ProtoFrameInfo info = {
+        .channel = sim->channel,
+        .rssi = network.rssi,
+    };
+    const uint32_t pick = sim_random(sim);
+    switch(sim->sniff_mode) {
+        case SimSniffBeacon:
+            info.subtype = 8;
+            break;
+        case SimSniffProbe:
+            info.subtype = probe_subtypes[pick % COUNT_OF(probe_subtypes)];
+            break;
+        case SimSniffDeauth:
+            info.subtype = deauth_subtypes[pick % COUNT_OF(deauth_subtypes)];
+            break;
+        case SimSniffEapol:
+            info.data = true;
+            info.eapol = true;
+            break;
+        default:
+            // Mostly management traffic, some data and the odd handshake
+            if(pick % 8 == 0) {
+                info.data = true;
+                info.eapol = pick % 64 == 0;
+            } else {
+                info.subtype = any_subtypes[(pick >> 3) % COUNT_OF(any_subtypes)];
+            }
+            break;
+    }
+
+    if(sim->binary) {
+        uint8_t out[EVIL_BW16_PROTO_MAX_FRAME];
+        sim_write(sim, out, evil_bw16_proto_encode_frame_info(&info, out, sizeof(out)));
+    } else {
+        char bssid[18];
+        sim_format_bssid(network.bssid, bssid, sizeof(bssid));
+        if(info.data) {
+            sim_printf(sim, "[DATA] %s BSSID: %s CH: %u RSSI: %d", info.eapol ? "EAPOL Key" : "QoS Data",
+                       bssid, info.channel, info.rssi);
+        } else if(info.subtype == 8 || info.subtype == 5) {
+            sim_printf(sim, "[MGMT] %s SSID: %s BSSID: %s CH: %u RSSI: %d", mgmt_names[info.subtype],
+                       network.ssid, bssid, info.channel, info.rssi);
+        } else {
+            sim_printf(sim, "[MGMT] %s BSSID: %s CH: %u RSSI: %d", mgmt_names[info.subtype], bssid,
+                       info.channel, info.rssi);
+        }
+    }
+    sim->stats.frames++;
+}
+
+// Emit the frames that are due at the offered rate, and hop channels
+static void sim_sniff_tick(EvilBw16Sim* sim) {
+    const uint32_t now = furi_get_tick();
+
+    if(sim->hopping && now - sim->last_hop >= SIM_HOP_INTERVAL_MS) {
+        sim->last_hop = now;
+        sim->hop_index = (sim->hop_index + 1) % COUNT_OF(sim_hop_channels);
+        sim->channel = sim_hop_channels[sim->hop_index];
+        sim_printf(sim, "[HOP] Channel %u", sim->channel);
+    }
+
+    const uint32_t due = (uint32_t)((uint64_t)(now - sim->sniff_start) * sim->frame_rate / 1000);
+    for(uint32_t i = 0; i < SIM_FRAMES_PER_PASS && sim->sniff_generated < due && sim->running; i++) {
+        sim_sniff_frame(sim);
+        sim->sniff_generated++;
+    }
+}
+
+static void sim_command_sniff(EvilBw16Sim* sim, EvilBw16LineView mode) {
+    if(evil_bw16_line_starts_with(mode, "stop") || evil_bw16_line_starts_with(mode, "off")) {
+        sim->sniffing = false;
+        sim_printf(sim, "[CMD] Sniffer stopped");
+        return;
+    }
+
+    for(size_t i = 0; i < COUNT_OF(sim_sniff_modes); i++) {
+        if(mode.len == strlen(sim_sniff_modes[i].name) && evil_bw16_line_starts_with(mode, sim_sniff_modes[i].name)) {
+            sim->sniff_mode = sim_sniff_modes[i].mode;
+            sim->sniffing = true;
+            sim->sniff_start = furi_get_tick();
+            sim->sniff_generated = 0;
+            sim_printf(sim, "[CMD] Starting sniffing mode: %s", sim_sniff_modes[i].name);
+            return;
+        }
+    }
+    sim_printf(sim, "[ERROR] Unknown sniff mode: %.*s", (int)mode.len, mode.data);
+}
+
+static void sim_command_set(EvilBw16Sim* sim, EvilBw16LineView args) {
+    EvilBw16LineView key;
+    if(!evil_bw16_line_next_field(&args, ' ', &key) || args.len == 0) {
+        sim_printf(sim, "[ERROR] Usage: set <key> <value>");
+        return;
+    }
+
+    int value;
+    if(key.len == 5 && evil_bw16_line_starts_with(key, "proto")) {
+        // Acknowledged in the old framing, like the firmware
+        const bool binary = evil_bw16_line_starts_with(args, "binary");
+        sim_printf(sim, "[INFO] Proto %s", binary ? "binary" : "text");
+        sim->binary = binary;
+    } else if(key.len == 2 && evil_bw16_line_starts_with(key, "ch") && evil_bw16_line_parse_int(args, &value)) {
+        sim->channel = (uint8_t)value;
+        sim->hopping = false;
+        sim_printf(sim, "[CMD] Channel set to %d", value);
+    } else {
+        sim_printf(sim, "[CMD] %.*s set to %.*s", (int)key.len, key.data, (int)args.len, args.data);
+    }
+}
+
+static void sim_handle_command(EvilBw16Sim* sim, const char* command) {
+    EvilBw16LineView line = evil_bw16_line_view(command, strlen(command));
+    sim->stats.commands++;
+
+    // The firmware echoes what it receives
+    sim_write_text(sim, line.data, line.len);
+
+    EvilBw16LineView name;
+    EvilBw16LineView args = line;
+    evil_bw16_line_next_field(&args, ' ', &name);
+
+    if(name.len == 4 && evil_bw16_line_starts_with(name, "scan")) {
+        sim_scan(sim);
+    } else if(name.len == 4 && evil_bw16_line_starts_with(name, "info")) {
+        sim_printf(sim, "[INFO] Evil-BW16 (simulated)");
+        sim_printf(sim, "[INFO] Networks: %u, frame rate: %lu/s", sim->network_count, sim->frame_rate);
+        sim_printf(sim, "[INFO] Channel: %u%s", sim->channel, sim->hopping ? " (hopping)" : "");
+    } else if(name.len == 5 && evil_bw16_line_starts_with(name, "sniff")) {
+        sim_command_sniff(sim, args);
+    } else if(name.len == 3 && evil_bw16_line_starts_with(name, "hop")) {
+        sim->hopping = evil_bw16_line_starts_with(args, "on");
+        sim->last_hop = furi_get_tick();
+        sim_printf(sim, "[CMD] Channel hopping %s", sim->hopping ? "enabled" : "disabled");
+    } else if(name.len == 3 && evil_bw16_line_starts_with(name, "set")) {
+        sim_command_set(sim, args);
+    } else if(evil_bw16_line_starts_with(line, "start deauther")) {
+        sim_printf(sim, "[CMD] Deauther started");
+    } else if(evil_bw16_line_starts_with(line, "stop deauther")) {
+        sim_printf(sim, "[CMD] Deauther stopped");
+    } else if(evil_bw16_line_starts_with(line, "disassoc") || evil_bw16_line_starts_with(line, "random_attack")) {
+        sim_printf(sim, "[CMD] Starting %s", command);
+    } else {
+        sim_printf(sim, "[ERROR] Unknown command: %s", command);
+    }
+}
+
+static int32_t sim_thread(void* context) {
+    EvilBw16Sim* sim = context;
+    SimCommand command;
+
+    while(sim->running) {
+        // Poll every tick while frames are due, otherwise just wait for commands
+        const uint32_t timeout = sim->sniffing ? 1 : 100;
+        if(furi_message_queue_get(sim->queue, &command, timeout) == FuriStatusOk) {
+            sim_handle_command(sim, command.text);
+        }
+        if(sim->sniffing) sim_sniff_tick(sim);
+    }
+
+    return 0;
+}
+
+// Runs on whichever thread sent the command; the answer comes from the sim thread
+static void sim_tx_tap(const char* command, void* context) {
+    EvilBw16Sim* sim = context;
+    SimCommand message;
+    strncpy(message.text, command, sizeof(message.text) - 1);
+    message.text[sizeof(message.text) - 1] = '\0';
+    if(furi_message_queue_put(sim->queue, &message, 0) != FuriStatusOk) {
+        EVIL_BW16_LOG_W("Simulator busy, command dropped: %s", command);
+    }
+}
+
+EvilBw16Sim* evil_bw16_sim_alloc(EvilBw16App* app) {
+    EvilBw16Sim* sim = malloc(sizeof(EvilBw16Sim));
+    memset(sim, 0, sizeof(EvilBw16Sim));
+    sim->app = app;
+    sim->queue = furi_message_queue_alloc(SIM_QUEUE_DEPTH, sizeof(SimCommand));
+    sim->network_count = 20;
+    sim->frame_rate = 200;
+    sim->scan_ms = 1000;
+    return sim;
+}
+
+void evil_bw16_sim_free(EvilBw16Sim* sim) {
+    if(!sim) return;
+    evil_bw16_sim_stop(sim);
+    furi_message_queue_free(sim->queue);
+    free(sim);
+}
+
+// Settings take effect with the next command; network_count is capped at the scan list size
+void evil_bw16_sim_configure(EvilBw16Sim* sim, uint8_t network_count, uint32_t frame_rate, uint32_t scan_ms) {
+    if(!sim) return;
+    sim->network_count = MIN(network_count, (uint8_t)EVIL_BW16_MAX_NETWORKS);
+    sim->frame_rate = frame_rate;
+    sim->scan_ms = scan_ms;
+}
+
+// Take over from the BW16 until evil_bw16_sim_stop()
+bool evil_bw16_sim_start(EvilBw16Sim* sim) {
+    if(!sim || sim->thread) return false;
+    EvilBw16UartWorker* worker = sim->app->uart_worker;
+    if(!worker) return false;
+
+    // Nothing from the real module is read while the simulator answers
+    evil_bw16_uart_pause_rx(worker, true);
+    furi_message_queue_reset(sim->queue);
+
+    sim->was_binary = evil_bw16_uart_is_binary(worker);
+    sim->binary = sim->was_binary;
+    sim->sniffing = false;
+    sim->hopping = false;
+    sim->hop_index = 0;
+    sim->channel = 1;
+    sim->rng = furi_get_tick() | 1;
+    sim->pace_start = furi_get_tick();
+    sim->pace_bytes = 0;
+    memset(&sim->stats, 0, sizeof(sim->stats));
+
+    sim->running = true;
+    sim->thread = furi_thread_alloc_ex("EvilBw16Sim", 2048, sim_thread, sim);
+    furi_thread_start(sim->thread);
+    evil_bw16_uart_set_tx_tap(worker, sim_tx_tap, sim);
+
+    EVIL_BW16_LOG_I("BW16 simulator started");
+    return true;
+}
+
+// Hand the link back to the BW16, in the framing it was left in
+void evil_bw16_sim_stop(EvilBw16Sim* sim) {
+    if(!sim || !sim->thread) return;
+    EvilBw16UartWorker* worker = sim->app->uart_worker;
+
+    evil_bw16_uart_set_tx_tap(worker, NULL, NULL);
+    sim->running = false;
+    furi_thread_join(sim->thread);
+    furi_thread_free(sim->thread);
+    sim->thread = NULL;
+
+    if(worker) {
+        evil_bw16_uart_flush_rx(worker);
+        evil_bw16_uart_force_protocol(worker, sim->was_binary);
+        evil_bw16_uart_pause_rx(worker, false);
+    }
+    EVIL_BW16_LOG_I("BW16 simulator stopped");
+}
+
+bool evil_bw16_sim_is_running(EvilBw16Sim* sim) {
+    return sim && sim->thread;
+}
+
+uint8_t evil_bw16_sim_get_network_count(EvilBw16Sim* sim) {
+    return sim ? sim->network_count : 0;
+}
+
+uint32_t evil_bw16_sim_get_frame_rate(EvilBw16Sim* sim) {
+    return sim ? sim->frame_rate : 0;
+}
+
+uint32_t evil_bw16_sim_get_scan_ms(EvilBw16Sim* sim) {
+    return sim ? sim->scan_ms : 0;
+}
+
+void evil_bw16_sim_get_stats(EvilBw16Sim* sim, EvilBw16SimStats* stats) {
+    memset(stats, 0, sizeof(EvilBw16SimStats));
+    if(sim) *stats = sim->stats;
+}
+
+#endif // EVIL_BW16_DEVTOOLS
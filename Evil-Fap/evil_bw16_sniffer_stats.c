@@ -0,0 +1,212 @@
+#include "evil_bw16.h"
+
+// Sniffer statistics.
+//
+// [MGMT] and [DATA] lines are reduced to a frame subtype and a channel in one pass over
+// the words of the line, and counted in the fixed tables of EvilBw16SnifferCounters.
+// Nothing is allocated or copied per frame. The firmware's exact wording varies between
+// builds, so fields are found by keyword rather than position: the first word naming a
+// frame type decides the subtype ("Beacon", "Probe Req", "ProbeResp", "Deauth", ...),
+// and "CH", "Chan" or "Channel" followed by a number gives the channel. Frames reported
+// over the binary protocol carry the 802.11 subtype and channel directly.
+//
+// Counters are only written by the UART worker. Readers copy them without a lock; each
+// counter is a single word, so a copy may mix two frames' worth of updates but never
+// holds a torn value.
+
+static const char* const sniffer_subtype_names[EvilBw16FrameSubtypeNum] = {
+    [EvilBw16FrameBeacon] = "Beacon",
+    [EvilBw16FrameProbeReq] = "Probe Req",
+    [EvilBw16FrameProbeResp] = "Probe Resp",
+    [EvilBw16FrameAuth] = "Auth",
+    [EvilBw16FrameDeauth] = "Deauth",
+    [EvilBw16FrameAssoc] = "Assoc",
+    [EvilBw16FrameDisassoc] = "Disassoc",
+    [EvilBw16FrameAction] = "Action",
+    [EvilBw16FrameEapol] = "EAPOL",
+    [EvilBw16FrameData] = "Data",
+    [EvilBw16FrameOther] = "Other",
+};
+
+// Word prefixes naming a subtype, case-insensitive. Longer words that share a prefix
+// with a shorter entry must come first.
+static const struct {
+    const char* prefix;
+    EvilBw16FrameSubtype subtype;
+} sniffer_keywords[] = {
+    {"beacon", EvilBw16FrameBeacon},
+    {"deauth", EvilBw16FrameDeauth},
+    {"disas", EvilBw16FrameDisassoc},
+    {"auth", EvilBw16FrameAuth},
+    {"reassoc", EvilBw16FrameAssoc},
+    {"assoc", EvilBw16FrameAssoc},
+    {"action", EvilBw16FrameAction},
+    {"eapol", EvilBw16FrameEapol},
+    {"qos", EvilBw16FrameData},
+    {"null", EvilBw16FrameData},
+    {"data", EvilBw16FrameData},
+};
+
+// 802.11 management frame subtype field (frame control bits 4-7)
+static const EvilBw16FrameSubtype sniffer_mgmt_subtypes[16] = {
+    EvilBw16FrameAssoc,    // Association request
+    EvilBw16FrameAssoc,    // Association response
+    EvilBw16FrameAssoc,    // Reassociation request
+    EvilBw16FrameAssoc,    // Reassociation response
+    EvilBw16FrameProbeReq,
+    EvilBw16FrameProbeResp,
+    EvilBw16FrameOther,    // Timing advertisement
+    EvilBw16FrameOther,    // Reserved
+    EvilBw16FrameBeacon,
+    EvilBw16FrameOther,    // ATIM
+    EvilBw16FrameDisassoc,
+    EvilBw16FrameAuth,
+    EvilBw16FrameDeauth,
+    EvilBw16FrameAction,
+    EvilBw16FrameAction,   // Action no ack
+    EvilBw16FrameOther,    // Reserved
+};
+
+static inline char sniffer_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static inline bool sniffer_is_word_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool sniffer_word_starts_with(EvilBw16LineView word, const char* prefix) {
+    size_t i = 0;
+    for(; prefix[i]; i++) {
+        if(i >= word.len || sniffer_lower(word.data[i]) != prefix[i]) return false;
+    }
+    return true;
+}
+
+static bool sniffer_word_equals(EvilBw16LineView word, const char* text) {
+    return strlen(text) == word.len && sniffer_word_starts_with(word, text);
+}
+
+// Next run of letters and digits, false at the end of the line
+static bool sniffer_next_word(EvilBw16LineView* rest, EvilBw16LineView* word) {
+    size_t i = 0;
+    while(i < rest->len && !sniffer_is_word_char(rest->data[i])) i++;
+    size_t start = i;
+    while(i < rest->len && sniffer_is_word_char(rest->data[i])) i++;
+    if(i == start) return false;
+
+    *word = evil_bw16_line_view(rest->data + start, i - start);
+    *rest = evil_bw16_line_skip(*rest, i);
+    return true;
+}
+
+// Table slot for a channel: 2.4 GHz channels 1-14 first, then 5 GHz in steps of four
+static int sniffer_channel_slot(int channel) {
+    if(channel >= 1 && channel <= 14) return channel - 1;
+    if(channel >= 32 && channel <= 177) return 14 + (channel - 32) / 4;
+    return -1;
+}
+
+// Channel number for a table slot (5 GHz channels from 149 up are odd)
+uint8_t evil_bw16_sniffer_slot_channel(size_t slot) {
+    if(slot < 14) return slot + 1;
+    const uint32_t channel = 32 + (slot - 14) * 4;
+    return channel >= 148 ? channel + 1 : channel;
+}
+
+static void sniffer_count(EvilBw16SnifferCounters* counters, EvilBw16FrameSubtype subtype, int channel) {
+    counters->total++;
+    counters->subtype[subtype]++;
+
+    const int slot = sniffer_channel_slot(channel);
+    if(slot >= 0) {
+        counters->channel[slot]++;
+        counters->band[channel > 14 ? 1 : 0]++;
+    } else {
+        counters->no_channel++;
+    }
+}
+
+const char* evil_bw16_sniffer_subtype_name(EvilBw16FrameSubtype subtype) {
+    return subtype < EvilBw16FrameSubtypeNum ? sniffer_subtype_names[subtype] : "?";
+}
+
+void evil_bw16_sniffer_stats_reset(EvilBw16SnifferCounters* counters) {
+    memset(counters, 0, sizeof(EvilBw16SnifferCounters));
+}
+
+// Count one [MGMT] (data_frame false) or [DATA] line
+void evil_bw16_sniffer_stats_record(EvilBw16SnifferCounters* counters, EvilBw16LineView line, bool data_frame) {
+    EvilBw16FrameSubtype subtype = EvilBw16FrameSubtypeNum;
+    int channel = -1;
+    bool channel_next = false;
+    bool probe_next = false;
+
+    // Skip the tag itself
+    EvilBw16LineView rest = line;
+    if(rest.len && rest.data[0] == '[') {
+        const char* end = memchr(rest.data, ']', rest.len);
+        if(end) rest = evil_bw16_line_skip(rest, end - rest.data + 1);
+    }
+
+    EvilBw16LineView word;
+    while((subtype == EvilBw16FrameSubtypeNum || channel < 0) && sniffer_next_word(&rest, &word)) {
+        if(channel_next) {
+            channel_next = false;
+            int value;
+            if(channel < 0 && evil_bw16_line_parse_int(word, &value)) {
+                channel = value;
+                continue;
+            }
+        }
+        if(probe_next) {
+            // "Probe Resp(onse)" vs "Probe Req(uest)"
+            probe_next = false;
+            subtype = sniffer_word_starts_with(word, "resp") ? EvilBw16FrameProbeResp : EvilBw16FrameProbeReq;
+            continue;
+        }
+
+        if(channel < 0 && (sniffer_word_equals(word, "ch") || sniffer_word_equals(word, "chan") ||
+                           sniffer_word_equals(word, "channel"))) {
+            channel_next = true;
+            continue;
+        }
+
+        if(subtype != EvilBw16FrameSubtypeNum) continue;
+
+        if(sniffer_word_starts_with(word, "probe")) {
+            EvilBw16LineView tail = evil_bw16_line_skip(word, 5);
+            if(tail.len == 0) {
+                probe_next = true;
+            } else {
+                subtype = sniffer_word_starts_with(tail, "resp") ? EvilBw16FrameProbeResp : EvilBw16FrameProbeReq;
+            }
+            continue;
+        }
+        for(size_t i = 0; i < COUNT_OF(sniffer_keywords); i++) {
+            if(sniffer_word_starts_with(word, sniffer_keywords[i].prefix)) {
+                subtype = sniffer_keywords[i].subtype;
+                break;
+            }
+        }
+    }
+
+    if(probe_next) subtype = EvilBw16FrameProbeReq;
+    if(subtype == EvilBw16FrameSubtypeNum) {
+        subtype = data_frame ? EvilBw16FrameData : EvilBw16FrameOther;
+    }
+
+    sniffer_count(counters, subtype, channel);
+}
+
+// Count one frame reported over the binary protocol, already split into fields
+void evil_bw16_sniffer_stats_record_frame(EvilBw16SnifferCounters* counters, const EvilBw16ProtoFrameInfo* info) {
+    EvilBw16FrameSubtype subtype;
+    if(info->data) {
+        subtype = info->eapol ? EvilBw16FrameEapol : EvilBw16FrameData;
+    } else {
+        subtype = info->subtype < COUNT_OF(sniffer_mgmt_subtypes) ? sniffer_mgmt_subtypes[info->subtype] :
+                                                                      EvilBw16FrameOther;
+    }
+    sniffer_count(counters, subtype, info->channel ? info->channel : -1);
+}
@@ -0,0 +1,220 @@
+#include "evil_bw16.h"
+
+// Live sniffer statistics view.
+//
+// Shows totals and per-second rates by frame subtype, band and busiest channels. Totals
+// follow the counters on every update; rates are recomputed when the scene takes a
+// sample (once per tick), from the difference to the previous sample.
+
+#define SNIFFER_VIEW_HEADER_HEIGHT (11)
+#define SNIFFER_VIEW_ROW_HEIGHT (9)
+#define SNIFFER_VIEW_VISIBLE_ROWS ((64 - SNIFFER_VIEW_HEADER_HEIGHT) / SNIFFER_VIEW_ROW_HEIGHT)
+#define SNIFFER_VIEW_TOP_CHANNELS (4)
+#define SNIFFER_VIEW_MAX_ROWS (2 + EvilBw16FrameSubtypeNum + SNIFFER_VIEW_TOP_CHANNELS + 1)
+
+typedef enum {
+    SnifferRowTotal,
+    SnifferRowBands,
+    SnifferRowSubtype,
+    SnifferRowChannel,
+    SnifferRowNoChannel,
+} SnifferRowKind;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t arg;  // Subtype or channel slot
+} SnifferRow;
+
+struct EvilBw16SnifferView {
+    View* view;
+};
+
+typedef struct {
+    EvilBw16SnifferCounters current;  // Latest totals
+    EvilBw16SnifferCounters sample;   // Totals at the last sample
+    EvilBw16SnifferCounters rates;    // Per second over the last sample interval
+    uint32_t sample_tick;
+    uint8_t scroll;
+} EvilBw16SnifferViewModel;
+
+// Busiest channels by rate, then by total; returns how many were found
+static size_t sniffer_view_top_channels(const EvilBw16SnifferViewModel* model, uint8_t* slots) {
+    size_t count = 0;
+    for(size_t slot = 0; slot < EVIL_BW16_SNIFF_CHANNEL_SLOTS; slot++) {
+        if(!model->current.channel[slot]) continue;
+
+        // Insertion into the short sorted list
+        size_t pos = count;
+        while(pos > 0) {
+            const uint8_t other = slots[pos - 1];
+            const bool busier = model->rates.channel[slot] > model->rates.channel[other] ||
+                                (model->rates.channel[slot] == model->rates.channel[other] &&
+                                 model->current.channel[slot] > model->current.channel[other]);
+            if(!busier) break;
+            if(pos < SNIFFER_VIEW_TOP_CHANNELS) slots[pos] = other;
+            pos--;
+        }
+        if(pos < SNIFFER_VIEW_TOP_CHANNELS) {
+            slots[pos] = slot;
+            if(count < SNIFFER_VIEW_TOP_CHANNELS) count++;
+        }
+    }
+    return count;
+}
+
+static size_t sniffer_view_rows(const EvilBw16SnifferViewModel* model, SnifferRow* rows) {
+    size_t count = 0;
+    rows[count++] = (SnifferRow){SnifferRowTotal, 0};
+    rows[count++] = (SnifferRow){SnifferRowBands, 0};
+
+    for(size_t i = 0; i < EvilBw16FrameSubtypeNum; i++) {
+        if(model->current.subtype[i]) rows[count++] = (SnifferRow){SnifferRowSubtype, i};
+    }
+
+    uint8_t slots[SNIFFER_VIEW_TOP_CHANNELS];
+    const size_t channels = sniffer_view_top_channels(model, slots);
+    for(size_t i = 0; i < channels; i++) {
+        rows[count++] = (SnifferRow){SnifferRowChannel, slots[i]};
+    }
+
+    if(model->current.no_channel) rows[count++] = (SnifferRow){SnifferRowNoChannel, 0};
+    return count;
+}
+
+static void sniffer_view_format_row(const EvilBw16SnifferViewModel* model, SnifferRow row, char* out, size_t size) {
+    const EvilBw16SnifferCounters* current = &model->current;
+    const EvilBw16SnifferCounters* rates = &model->rates;
+
+    switch(row.kind) {
+        case SnifferRowTotal:
+            snprintf(out, size, "Frames: %lu", current->total);
+            break;
+        case SnifferRowBands:
+            snprintf(out, size, "2.4G %lu/s  5G %lu/s", rates->band[0], rates->band[1]);
+            break;
+        case SnifferRowSubtype:
+            snprintf(out, size, "%s: %lu/s (%lu)", evil_bw16_sniffer_subtype_name(row.arg),
+                     rates->subtype[row.arg], current->subtype[row.arg]);
+            break;
+        case SnifferRowChannel:
+            snprintf(out, size, "Ch %u: %lu/s (%lu)", evil_bw16_sniffer_slot_channel(row.arg),
+                     rates->channel[row.arg], current->channel[row.arg]);
+            break;
+        default:
+            snprintf(out, size, "No channel: %lu", current->no_channel);
+            break;
+    }
+}
+
+static void sniffer_view_draw_callback(Canvas* canvas, void* _model) {
+    EvilBw16SnifferViewModel* model = _model;
+    char text[32];
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 0, 8, "Sniffer Stats");
+    snprintf(text, sizeof(text), "%lu/s", model->rates.total);
+    canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, text);
+    canvas_draw_line(canvas, 0, SNIFFER_VIEW_HEADER_HEIGHT - 2, 127, SNIFFER_VIEW_HEADER_HEIGHT - 2);
+
+    if(model->current.total == 0) {
+        canvas_draw_str(canvas, 0, SNIFFER_VIEW_HEADER_HEIGHT + SNIFFER_VIEW_ROW_HEIGHT - 1, "Waiting for frames...");
+        canvas_draw_str(canvas, 0, SNIFFER_VIEW_HEADER_HEIGHT + 2 * SNIFFER_VIEW_ROW_HEIGHT - 1, "Start one with sniff <mode>");
+        return;
+    }
+
+    SnifferRow rows[SNIFFER_VIEW_MAX_ROWS];
+    const size_t count = sniffer_view_rows(model, rows);
+    const size_t max_scroll = count > SNIFFER_VIEW_VISIBLE_ROWS ? count - SNIFFER_VIEW_VISIBLE_ROWS : 0;
+    if(model->scroll > max_scroll) model->scroll = max_scroll;
+
+    int32_t y = SNIFFER_VIEW_HEADER_HEIGHT + SNIFFER_VIEW_ROW_HEIGHT - 1;
+    for(size_t i = model->scroll; i < count && i < (size_t)model->scroll + SNIFFER_VIEW_VISIBLE_ROWS; i++) {
+        sniffer_view_format_row(model, rows[i], text, sizeof(text));
+        canvas_draw_str(canvas, 0, y, text);
+        y += SNIFFER_VIEW_ROW_HEIGHT;
+    }
+}
+
+static bool sniffer_view_input_callback(InputEvent* event, void* context) {
+    EvilBw16SnifferView* sniffer_view = context;
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+    if(event->key != InputKeyUp && event->key != InputKeyDown) return false;
+
+    with_view_model(
+        sniffer_view->view,
+        EvilBw16SnifferViewModel * model,
+        {
+            if(event->key == InputKeyUp && model->scroll > 0) {
+                model->scroll--;
+            } else if(event->key == InputKeyDown && model->scroll < SNIFFER_VIEW_MAX_ROWS) {
+                model->scroll++;  // Clamped when drawn
+            }
+        },
+        true);
+
+    return true;
+}
+
+EvilBw16SnifferView* evil_bw16_sniffer_view_alloc(void) {
+    EvilBw16SnifferView* sniffer_view = malloc(sizeof(EvilBw16SnifferView));
+    sniffer_view->view = view_alloc();
+    view_set_context(sniffer_view->view, sniffer_view);
+    view_allocate_model(sniffer_view->view, ViewModelTypeLocking, sizeof(EvilBw16SnifferViewModel));
+    view_set_draw_callback(sniffer_view->view, sniffer_view_draw_callback);
+    view_set_input_callback(sniffer_view->view, sniffer_view_input_callback);
+    return sniffer_view;
+}
+
+void evil_bw16_sniffer_view_free(EvilBw16SnifferView* sniffer_view) {
+    if(!sniffer_view) return;
+    view_free(sniffer_view->view);
+    free(sniffer_view);
+}
+
+View* evil_bw16_sniffer_view_get_view(EvilBw16SnifferView* sniffer_view) {
+    return sniffer_view->view;
+}
+
+// Start a fresh rate interval from the given totals
+void evil_bw16_sniffer_view_reset(EvilBw16SnifferView* sniffer_view, const EvilBw16SnifferCounters* counters) {
+    with_view_model(
+        sniffer_view->view,
+        EvilBw16SnifferViewModel * model,
+        {
+            model->current = *counters;
+            model->sample = *counters;
+            memset(&model->rates, 0, sizeof(model->rates));
+            model->sample_tick = furi_get_tick();
+            model->scroll = 0;
+        },
+        true);
+}
+
+// Refresh totals; with sample set, also recompute the rates since the previous sample
+void evil_bw16_sniffer_view_update(EvilBw16SnifferView* sniffer_view, const EvilBw16SnifferCounters* counters, bool sample) {
+    with_view_model(
+        sniffer_view->view,
+        EvilBw16SnifferViewModel * model,
+        {
+            model->current = *counters;
+
+            const uint32_t now = furi_get_tick();
+            const uint32_t elapsed = now - model->sample_tick;
+            if(sample && elapsed > 0) {
+                const uint32_t* cur = (const uint32_t*)&model->current;
+                const uint32_t* prev = (const uint32_t*)&model->sample;
+                uint32_t* rate = (uint32_t*)&model->rates;
+                // Every field of the counters is a uint32_t
+                for(size_t i = 0; i < sizeof(EvilBw16SnifferCounters) / sizeof(uint32_t); i++) {
+                    // The worker may have reset the counters since the last sample
+                    const uint32_t delta = cur[i] >= prev[i] ? cur[i] - prev[i] : cur[i];
+                    rate[i] = (uint32_t)((uint64_t)delta * furi_kernel_get_tick_frequency() / elapsed);
+                }
+                model->sample = model->current;
+                model->sample_tick = now;
+            }
+        },
+        true);
+}
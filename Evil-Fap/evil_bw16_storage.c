@@ -0,0 +1,198 @@
+#include "evil_bw16.h"
+#include <storage/storage.h>
+
+// Background SD card writer.
+//
+// Producers (mostly the UART worker) copy bytes into an in-RAM queue and return; a
+// dedicated thread owns the open file and commits whatever has queued up in one go,
+// either once STORAGE_FLUSH_THRESHOLD bytes are pending or every
+// STORAGE_FLUSH_INTERVAL_MS, followed by a single sync. Writes are all or nothing: if
+// the queue is full the data is counted as dropped instead of waiting for the card.
+
+#define STORAGE_QUEUE_SIZE (4096)  // Power of two
+#define STORAGE_WRITE_CHUNK (1024)
+#define STORAGE_FLUSH_THRESHOLD (1024)
+#define STORAGE_FLUSH_INTERVAL_MS (1000)
+
+typedef enum {
+    StorageEvtStop = (1 << 0),
+    StorageEvtFlush = (1 << 1),
+} StorageEvtFlags;
+
+#define STORAGE_ALL_EVENTS (StorageEvtStop | StorageEvtFlush)
+
+struct EvilBw16StorageWriter {
+    Storage* storage;
+    File* file;
+    FuriThread* thread;
+    FuriThreadId thread_id;
+
+    FuriMutex* mutex;  // Guards the queue and the flags below
+    uint8_t* queue;
+    uint32_t head;     // Free running, head - tail is the pending byte count
+    uint32_t tail;
+    bool flush_requested;
+    bool truncate_requested;
+    uint32_t dropped_bytes;
+
+    uint8_t* chunk;    // Writer thread only
+    volatile bool failed;
+};
+
+// Write everything queued so far; runs on the writer thread only
+static void storage_writer_commit(EvilBw16StorageWriter* writer) {
+    bool written = false;
+
+    while(true) {
+        furi_mutex_acquire(writer->mutex, FuriWaitForever);
+        const bool truncate = writer->truncate_requested;
+        writer->truncate_requested = false;
+        writer->flush_requested = false;
+
+        const uint32_t offset = writer->tail & (STORAGE_QUEUE_SIZE - 1);
+        const uint32_t count = MIN(MIN(writer->head - writer->tail, (uint32_t)STORAGE_QUEUE_SIZE - offset), (uint32_t)STORAGE_WRITE_CHUNK);
+        memcpy(writer->chunk, writer->queue + offset, count);
+        writer->tail += count;
+        furi_mutex_release(writer->mutex);
+
+        if(truncate) {
+            storage_file_seek(writer->file, 0, true);
+            storage_file_truncate(writer->file);
+            written = true;
+        }
+        if(count == 0) break;
+
+        if(!writer->failed && storage_file_write(writer->file, writer->chunk, count) != count) {
+            EVIL_BW16_LOG_E("SD write failed, further writes dropped");
+            writer->failed = true;
+        }
+        written = true;
+    }
+
+    if(written && !writer->failed) {
+        storage_file_sync(writer->file);
+    }
+}
+
+static int32_t storage_writer_thread(void* context) {
+    EvilBw16StorageWriter* writer = context;
+
+    while(true) {
+        uint32_t events = furi_thread_flags_wait(STORAGE_ALL_EVENTS, FuriFlagWaitAny, furi_ms_to_ticks(STORAGE_FLUSH_INTERVAL_MS));
+        storage_writer_commit(writer);
+        if(!(events & FuriFlagError) && (events & StorageEvtStop)) break;
+    }
+
+    return 0;
+}
+
+// Open path for writing (appending or replacing it) and start the writer thread
+EvilBw16StorageWriter* evil_bw16_storage_writer_alloc(const char* path, bool append) {
+    EvilBw16StorageWriter* writer = malloc(sizeof(EvilBw16StorageWriter));
+    memset(writer, 0, sizeof(EvilBw16StorageWriter));
+    writer->storage = furi_record_open(RECORD_STORAGE);
+    writer->file = storage_file_alloc(writer->storage);
+
+    storage_simply_mkdir(writer->storage, EXT_PATH("apps_data"));
+    if(!storage_file_open(writer->file, path, FSAM_WRITE, append ? FSOM_OPEN_APPEND : FSOM_CREATE_ALWAYS)) {
+        EVIL_BW16_LOG_E("Failed to open %s", path);
+        storage_file_free(writer->file);
+        furi_record_close(RECORD_STORAGE);
+        free(writer);
+        return NULL;
+    }
+
+    writer->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    writer->queue = malloc(STORAGE_QUEUE_SIZE);
+    writer->chunk = malloc(STORAGE_WRITE_CHUNK);
+
+    writer->thread = furi_thread_alloc_ex("EvilBw16Storage", 1024, storage_writer_thread, writer);
+    furi_thread_start(writer->thread);
+    writer->thread_id = furi_thread_get_id(writer->thread);
+
+    return writer;
+}
+
+// Commit what is still queued, then close the file
+void evil_bw16_storage_writer_free(EvilBw16StorageWriter* writer) {
+    if(!writer) return;
+
+    furi_thread_flags_set(writer->thread_id, StorageEvtStop);
+    furi_thread_join(writer->thread);
+    furi_thread_free(writer->thread);
+
+    if(writer->dropped_bytes) {
+        EVIL_BW16_LOG_W("SD writer dropped %lu bytes", writer->dropped_bytes);
+    }
+
+    storage_file_close(writer->file);
+    storage_file_free(writer->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_mutex_free(writer->mutex);
+    free(writer->queue);
+    free(writer->chunk);
+    free(writer);
+}
+
+// Queue the pieces back to back; false (and counted as dropped) if they don't all fit
+static bool storage_writer_queue(EvilBw16StorageWriter* writer, const void* const* parts, const size_t* lens, size_t part_count) {
+    size_t total = 0;
+    for(size_t i = 0; i < part_count; i++) total += lens[i];
+
+    furi_mutex_acquire(writer->mutex, FuriWaitForever);
+
+    if(writer->failed || STORAGE_QUEUE_SIZE - (writer->head - writer->tail) < total) {
+        writer->dropped_bytes += total;
+        furi_mutex_release(writer->mutex);
+        return false;
+    }
+
+    for(size_t i = 0; i < part_count; i++) {
+        const uint8_t* data = parts[i];
+        size_t len = lens[i];
+        while(len > 0) {
+            const uint32_t offset = writer->head & (STORAGE_QUEUE_SIZE - 1);
+            const size_t count = MIN(len, (size_t)(STORAGE_QUEUE_SIZE - offset));
+            memcpy(writer->queue + offset, data, count);
+            writer->head += count;
+            data += count;
+            len -= count;
+        }
+    }
+
+    bool flush = !writer->flush_requested && writer->head - writer->tail >= STORAGE_FLUSH_THRESHOLD;
+    if(flush) writer->flush_requested = true;
+
+    furi_mutex_release(writer->mutex);
+
+    if(flush) furi_thread_flags_set(writer->thread_id, StorageEvtFlush);
+    return true;
+}
+
+bool evil_bw16_storage_writer_write(EvilBw16StorageWriter* writer, const void* data, size_t len) {
+    if(!writer) return false;
+    return storage_writer_queue(writer, &data, &len, 1);
+}
+
+// Queue prefix (may be NULL), line and a newline as one unit
+bool evil_bw16_storage_writer_write_line(EvilBw16StorageWriter* writer, const char* prefix, EvilBw16LineView line) {
+    if(!writer) return false;
+    const void* parts[] = {prefix ? prefix : "", line.data, "\n"};
+    const size_t lens[] = {prefix ? strlen(prefix) : 0, line.len, 1};
+    return storage_writer_queue(writer, parts, lens, 3);
+}
+
+// Empty the file; data queued before the call is discarded, data queued after is kept
+void evil_bw16_storage_writer_truncate(EvilBw16StorageWriter* writer) {
+    if(!writer) return;
+    furi_mutex_acquire(writer->mutex, FuriWaitForever);
+    writer->tail = writer->head;
+    writer->truncate_requested = true;
+    writer->flush_requested = true;
+    furi_mutex_release(writer->mutex);
+    furi_thread_flags_set(writer->thread_id, StorageEvtFlush);
+}
+
+uint32_t evil_bw16_storage_writer_get_dropped(EvilBw16StorageWriter* writer) {
+    return writer ? writer->dropped_bytes : 0;
+}
@@ -0,0 +1,215 @@
+#include "evil_bw16.h"
+#include <gui/elements.h>
+
+// UART terminal view.
+//
+// Draws straight from the log store: each frame only walks back from the newest line
+// far enough to fill the screen, and only the visible rows are laid out. How many rows
+// a line wraps to is cached per line, so neither a refresh nor scrolling copies or
+// re-wraps the log. Lines are wrapped at character (not word) boundaries.
+
+#define TERMINAL_HEADER_HEIGHT (11)
+#define TERMINAL_ROW_HEIGHT (9)
+#define TERMINAL_VISIBLE_ROWS ((64 - TERMINAL_HEADER_HEIGHT) / TERMINAL_ROW_HEIGHT)
+#define TERMINAL_TEXT_WIDTH (122)  // Leaves room for the scroll marker
+#define TERMINAL_ROW_MAX_CHARS (64)
+#define TERMINAL_CACHE_SIZE EVIL_BW16_LOG_STORE_LINES
+
+typedef struct {
+    uint32_t id;   // Log store line id the entry belongs to
+    uint8_t rows;  // 0 = empty slot
+} EvilBw16TerminalWrap;
+
+struct EvilBw16TerminalView {
+    View* view;
+    EvilBw16LogStore* store;
+    EvilBw16TerminalWrap wrap_cache[TERMINAL_CACHE_SIZE];
+};
+
+typedef struct {
+    EvilBw16TerminalView* terminal;
+    uint32_t scroll_rows;  // Rows scrolled up from the newest line, 0 follows new output
+    char header[32];
+} EvilBw16TerminalViewModel;
+
+// Number of characters of text that fit on one row
+static size_t terminal_row_len(Canvas* canvas, const char* text, size_t len) {
+    size_t width = 0;
+    len = MIN(len, (size_t)TERMINAL_ROW_MAX_CHARS - 1);
+    for(size_t i = 0; i < len; i++) {
+        width += canvas_glyph_width(canvas, (uint8_t)text[i]);
+        if(width > TERMINAL_TEXT_WIDTH) return i ? i : 1;
+    }
+    return len;
+}
+
+static uint8_t terminal_line_rows(EvilBw16TerminalView* terminal, Canvas* canvas, uint32_t id, EvilBw16LineView line) {
+    EvilBw16TerminalWrap* wrap = &terminal->wrap_cache[id % TERMINAL_CACHE_SIZE];
+    if(wrap->rows && wrap->id == id) return wrap->rows;
+
+    uint8_t rows = 1;
+    size_t pos = terminal_row_len(canvas, line.data, line.len);
+    while(pos < line.len && rows < UINT8_MAX) {
+        pos += terminal_row_len(canvas, line.data + pos, line.len - pos);
+        rows++;
+    }
+
+    wrap->id = id;
+    wrap->rows = rows;
+    return rows;
+}
+
+static void terminal_draw_callback(Canvas* canvas, void* _model) {
+    EvilBw16TerminalViewModel* model = _model;
+    EvilBw16TerminalView* terminal = model->terminal;
+    EvilBw16LogStore* store = terminal->store;
+
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 0, 8, model->header);
+    canvas_draw_line(canvas, 0, TERMINAL_HEADER_HEIGHT - 2, 127, TERMINAL_HEADER_HEIGHT - 2);
+
+    evil_bw16_log_store_lock(store);
+
+    const size_t count = evil_bw16_log_store_count(store);
+    const uint32_t first_id = evil_bw16_log_store_get_first_id(store);
+    if(count == 0) {
+        evil_bw16_log_store_unlock(store);
+        canvas_draw_str(canvas, 0, TERMINAL_HEADER_HEIGHT + TERMINAL_ROW_HEIGHT - 1, "[Waiting for UART data...]");
+        return;
+    }
+
+    // Walk back from the newest line until the scrolled-to window is covered
+    const uint32_t wanted = model->scroll_rows + TERMINAL_VISIBLE_ROWS;
+    size_t line_index = count;
+    uint32_t rows_below = 0;  // Rows of the lines after line_index
+    uint8_t line_rows = 0;
+    while(line_index > 0) {
+        line_index--;
+        line_rows = terminal_line_rows(terminal, canvas, first_id + line_index, evil_bw16_log_store_get(store, line_index));
+        if(rows_below + line_rows >= wanted) break;
+        rows_below += line_rows;
+    }
+
+    uint32_t skip_rows;
+    if(rows_below + line_rows >= wanted) {
+        skip_rows = rows_below + line_rows - wanted;
+    } else {
+        // Less text than the window; clamp the scroll position to the top
+        const uint32_t total = rows_below + line_rows;
+        model->scroll_rows = total > TERMINAL_VISIBLE_ROWS ? total - TERMINAL_VISIBLE_ROWS : 0;
+        skip_rows = 0;
+    }
+
+    // Lay out only the visible rows
+    char row[TERMINAL_ROW_MAX_CHARS];
+    int32_t y = TERMINAL_HEADER_HEIGHT + TERMINAL_ROW_HEIGHT - 1;
+    uint32_t drawn = 0;
+    for(size_t i = line_index; i < count && drawn < TERMINAL_VISIBLE_ROWS; i++) {
+        EvilBw16LineView line = evil_bw16_log_store_get(store, i);
+        size_t pos = 0;
+        do {
+            const size_t len = terminal_row_len(canvas, line.data + pos, line.len - pos);
+            if(skip_rows > 0) {
+                skip_rows--;
+            } else {
+                memcpy(row, line.data + pos, len);
+                row[len] = '\0';
+                canvas_draw_str(canvas, 0, y, row);
+                y += TERMINAL_ROW_HEIGHT;
+                drawn++;
+            }
+            pos += len;
+        } while(pos < line.len && drawn < TERMINAL_VISIBLE_ROWS);
+    }
+
+    evil_bw16_log_store_unlock(store);
+
+    // Mark that the view is not following new output
+    if(model->scroll_rows > 0) {
+        canvas_draw_str(canvas, 123, 63, "v");
+    }
+}
+
+static bool terminal_input_callback(InputEvent* event, void* context) {
+    EvilBw16TerminalView* terminal = context;
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat && event->type != InputTypeLong) {
+        return false;
+    }
+
+    bool consumed = true;
+    with_view_model(
+        terminal->view,
+        EvilBw16TerminalViewModel * model,
+        {
+            if(event->key == InputKeyUp) {
+                model->scroll_rows++;
+            } else if(event->key == InputKeyDown) {
+                if(model->scroll_rows > 0) model->scroll_rows--;
+            } else if(event->key == InputKeyRight && event->type == InputTypeShort) {
+                model->scroll_rows += TERMINAL_VISIBLE_ROWS;
+            } else if(event->key == InputKeyLeft && event->type == InputTypeShort) {
+                model->scroll_rows = model->scroll_rows > TERMINAL_VISIBLE_ROWS ? model->scroll_rows - TERMINAL_VISIBLE_ROWS : 0;
+            } else if(event->key == InputKeyOk) {
+                model->scroll_rows = 0;  // Back to following new output
+            } else {
+                consumed = false;
+            }
+        },
+        consumed);
+
+    return consumed;
+}
+
+EvilBw16TerminalView* evil_bw16_terminal_view_alloc(EvilBw16LogStore* store) {
+    EvilBw16TerminalView* terminal = malloc(sizeof(EvilBw16TerminalView));
+    memset(terminal, 0, sizeof(EvilBw16TerminalView));
+    terminal->store = store;
+
+    terminal->view = view_alloc();
+    view_set_context(terminal->view, terminal);
+    view_allocate_model(terminal->view, ViewModelTypeLocking, sizeof(EvilBw16TerminalViewModel));
+    view_set_draw_callback(terminal->view, terminal_draw_callback);
+    view_set_input_callback(terminal->view, terminal_input_callback);
+
+    with_view_model(
+        terminal->view,
+        EvilBw16TerminalViewModel * model,
+        {
+            model->terminal = terminal;
+            model->scroll_rows = 0;
+            model->header[0] = '\0';
+        },
+        false);
+
+    return terminal;
+}
+
+void evil_bw16_terminal_view_free(EvilBw16TerminalView* terminal) {
+    if(!terminal) return;
+    view_free(terminal->view);
+    free(terminal);
+}
+
+View* evil_bw16_terminal_view_get_view(EvilBw16TerminalView* terminal) {
+    return terminal->view;
+}
+
+// Set the status line and jump back to the newest output
+void evil_bw16_terminal_view_reset(EvilBw16TerminalView* terminal, const char* header) {
+    with_view_model(
+        terminal->view,
+        EvilBw16TerminalViewModel * model,
+        {
+            strncpy(model->header, header, sizeof(model->header) - 1);
+            model->header[sizeof(model->header) - 1] = '\0';
+            model->scroll_rows = 0;
+        },
+        true);
+}
+
+// New lines were logged; just schedule a redraw
+void evil_bw16_terminal_view_update(EvilBw16TerminalView* terminal) {
+    with_view_model(terminal->view, EvilBw16TerminalViewModel * model, { UNUSED(model); }, true);
+}
@@ -2,224 +2,855 @@
 #include <furi_hal.h>
 #include <ctype.h>
 
-#define BAUDRATE (115200)
-#define RX_BUFFER_SIZE (512)
+#define RX_RING_SIZE EVIL_BW16_UART_RX_BUF_SIZE  // Must be a power of two
+#define RX_WAKE_THRESHOLD (RX_RING_SIZE / 4)     // Wake the worker early if a line is this long
+#define RX_PRESSURE_WINDOW_MS (1000)             // Ring fill is sampled once per window
+#define RX_PRESSURE_WINDOWS (3)                  // Consecutive near-full windows before growing
+#define RX_GROW_HEAP_RESERVE (16 * 1024)         // Heap that must stay free after a grow
+#define LINE_BUFFER_SIZE (512)
 #define MAX_RECENT_COMMANDS 10
 #define COMMAND_ECHO_TIMEOUT_MS 1000
+#define ECHO_SET_SIZE 16  // Hash buckets, power of two and larger than MAX_RECENT_COMMANDS
+#define ECHO_COMMAND_MAX 64
+#define BAUD_SWITCH_SETTLE_MS (50)     // Time for the BW16 to apply a new rate after "set baud"
+#define BAUD_VERIFY_TIMEOUT_MS (500)   // Wait for the "info" reply at a new rate
+#define PROTO_ACK_TIMEOUT_MS (500)     // Wait for the BW16 to acknowledge a framing change
+#define PROTO_FALLBACK_BYTES (64)      // Undecodable bytes in a row before giving up on frames
+#define PROTO_ACK_BINARY "[INFO] Proto binary"
+#define PROTO_ACK_TEXT "[INFO] Proto text"
+
+// Rates tried during negotiation, highest first
+static const uint32_t uart_baud_rates[] = {921600, 460800, EVIL_BW16_UART_BAUD_RATE};
 
 // Forward declarations for response handler functions
-static void handle_info_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_error_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_debug_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_cmd_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_mgmt_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_data_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_hop_response(EvilBw16UartWorker* worker, const char* line);
-static void handle_generic_response(EvilBw16UartWorker* worker, const char* line);
-static void parse_scan_result_line(EvilBw16UartWorker* worker, const char* line);
-static bool is_command_echo(EvilBw16UartWorker* worker, const char* line);
+static void handle_info_response(EvilBw16LineView line, void* context);
+static void handle_error_response(EvilBw16LineView line, void* context);
+static void handle_debug_response(EvilBw16LineView line, void* context);
+static void handle_cmd_response(EvilBw16LineView line, void* context);
+static void handle_mgmt_response(EvilBw16LineView line, void* context);
+static void handle_data_response(EvilBw16LineView line, void* context);
+static void handle_hop_response(EvilBw16LineView line, void* context);
+static void handle_generic_response(EvilBw16LineView line, void* context);
+static void parse_scan_result_line(EvilBw16UartWorker* worker, EvilBw16LineView line);
+static void store_scan_result(EvilBw16UartWorker* worker, const EvilBw16ProtoScanResult* result);
+static void scan_completed(EvilBw16UartWorker* worker);
+static bool is_command_echo(EvilBw16UartWorker* worker, EvilBw16LineView line);
 static void store_sent_command(EvilBw16UartWorker* worker, const char* command);
 
+// WebUI chatter the firmware mirrors onto the UART; matching lines are dropped before parsing
+static const EvilBw16FilterRule uart_webui_filter_rules[] = {
+    {.pattern = "WebSocket"},
+    {.pattern = "HTTP GET"},
+    {.pattern = "Content-Type:"},
+    {.pattern = "Connection:"},
+    {.pattern = "\"type\"", .first_char = '{'},  // JSON status messages
+};
+
+// Recently sent commands, hashed on their case-folded text so an echo check
+// costs one hash of the line and at most one compare
+typedef struct {
+    uint32_t hash;
+    uint32_t timestamp;
+    uint8_t len;  // 0 marks an empty bucket
+    char command[ECHO_COMMAND_MAX];
+} EvilBw16EchoEntry;
+
+typedef struct {
+    EvilBw16EchoEntry buckets[ECHO_SET_SIZE];
+    // Commands in the order they were sent, so expiry only ever looks at the oldest
+    struct {
+        uint32_t hash;
+        uint32_t timestamp;
+    } expiry_queue[MAX_RECENT_COMMANDS];
+    uint8_t expiry_head;
+    uint8_t expiry_count;
+} EvilBw16EchoSet;
+
+// Worker thread event flags
+typedef enum {
+    WorkerEvtStop = (1 << 0),
+    WorkerEvtRxDone = (1 << 1),
+    WorkerEvtRxFlush = (1 << 2),
+    WorkerEvtLink = (1 << 3),  // Renegotiate rate and framing
+} WorkerEvtFlags;
+
+#define WORKER_ALL_EVENTS (WorkerEvtStop | WorkerEvtRxDone | WorkerEvtRxFlush | WorkerEvtLink)
+
+// Link negotiation steps. Each sends a command and waits for a line starting with the
+// expected prefix; the worker keeps reading meanwhile, so the reply reaches it.
+typedef enum {
+    LinkStepIdle,
+    LinkStepTextAck,    // Back to plain lines before changing rate
+    LinkStepBaudReply,  // "info" answered at the candidate rate
+    LinkStepBinaryAck,  // Framing acknowledged
+} LinkStep;
+
+// Lock-free single-producer/single-consumer byte ring.
+// The UART ISR is the only writer of head, the worker thread the only writer of tail.
+// Indices run freely and are masked on access, so head - tail is always the fill level.
+typedef struct {
+    uint8_t* data;
+    uint32_t mask;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;  // Bytes lost because the ring was full (ISR only)
+    volatile uint32_t high_water;         // Highest fill level seen (ISR only)
+    volatile uint32_t window_high_water;  // Same, since the worker last sampled it
+} EvilBw16RxRing;
+
 struct EvilBw16UartWorker {
     FuriThread* thread;
-    FuriStreamBuffer* rx_stream;
+    FuriThreadId thread_id;
+    EvilBw16RxRing rx_ring;
     FuriHalSerialHandle* serial_handle;
     bool running;
     EvilBw16App* app;
     FuriMutex* tx_mutex;
-    char recent_commands[MAX_RECENT_COMMANDS][64];
-    uint32_t command_timestamps[MAX_RECENT_COMMANDS];
-    int recent_command_index;
+    EvilBw16LineFilter* webui_filter;
+    EvilBw16EchoSet echo_set;
+    FuriMutex* echo_mutex;  // Commands are stored from the GUI thread, checked on the worker
     char* line_buffer;  // Move line buffer to heap to reduce stack usage
-    uint32_t last_log_update;  // Rate limiting for high-volume WebUI data
+    size_t line_len;    // Bytes of a partial line stashed in line_buffer (only across a ring wrap)
+    size_t scan_pos;    // Bytes at the ring tail already scanned without finding a line end
+    bool line_overflow; // Current line exceeded LINE_BUFFER_SIZE, discard until its end
+    struct {
+        EvilBw16ResponseHandler handler;
+        void* context;
+    } handlers[EvilBw16ResponseTypeNum];  // Indexed by evil_bw16_classify_line() result
+    bool rx_paused;            // Async RX stopped so an injector can be the ring producer
+    volatile bool profiling;      // Time every processed line into profile
+    EvilBw16UartProfile profile;  // Owned by the worker so a stopped run can't leave it writing elsewhere
+#ifdef EVIL_BW16_DEVTOOLS
+    EvilBw16CaptureWriter* capture;  // Raw RX recording, NULL when off
+    FuriMutex* capture_mutex;        // Capture is started/stopped from the GUI thread
+    uint32_t capture_pos;            // Ring position up to which bytes have been recorded
+#endif
+    uint32_t baud_rate;              // Rate the link currently runs at
+    struct {
+        const char* prefix;  // NULL when nobody is waiting
+        char* buffer;
+        size_t buffer_size;
+        bool matched;
+    } waiter;                         // See evil_bw16_uart_wait_for_response()
+    FuriMutex* waiter_mutex;
+    FuriSemaphore* waiter_done;
+    uint32_t truncated_lines;     // Lines discarded for outgrowing LINE_BUFFER_SIZE
+    uint32_t ring_grows;          // Times the adaptive mode enlarged the ring
+    uint32_t pressure_windows;    // Consecutive windows the ring ran near full
+    uint32_t pressure_dropped;    // Drop count at the last window sample
+    uint32_t last_pressure_check;
+    // Binary framing (evil_bw16_proto.h). Mode changes happen on the worker thread, on
+    // the BW16's acknowledgement line, so no byte is ever read in the wrong mode.
+    volatile bool binary_mode;       // RX is decoded as frames instead of split into lines
+    volatile bool binary_requested;  // "set proto binary" sent, switch on the acknowledgement
+    EvilBw16ProtoDecoder* decoder;   // Allocated on the first switch to binary
+    uint32_t proto_skipped;          // Decoder skip count at the last good frame
+    // Link negotiation, run by the worker between reads (see uart_link_poll())
+    struct {
+        LinkStep step;
+        uint8_t rate_index;   // Candidate in uart_baud_rates being tried
+        const char* expect;   // Prefix of the line that ends the step, NULL when idle
+        bool matched;
+        uint32_t deadline;
+    } link;
+    volatile bool link_pending;  // Requested and not finished yet
+    uint32_t proto_fallbacks;
+#ifdef EVIL_BW16_DEVTOOLS
+    EvilBw16TxTap tx_tap;  // Takes commands instead of the serial port, under tx_mutex
+    void* tx_tap_context;
+#endif
 };
 
 static EvilBw16UartWorker* uart_worker = NULL;
 
+// Fill level, safe from any thread
+static inline uint32_t rx_ring_used(const EvilBw16RxRing* ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+// Get the contiguous readable region starting at the tail (consumer side only)
+static size_t rx_ring_peek(EvilBw16RxRing* ring, const uint8_t** data) {
+    const uint32_t tail = ring->tail;
+    const uint32_t used = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+    const uint32_t offset = tail & ring->mask;
+    *data = &ring->data[offset];
+    return MIN(used, ring->mask + 1 - offset);
+}
+
+// Hand len bytes at the tail back to the producer (consumer side only)
+static void rx_ring_release(EvilBw16RxRing* ring, size_t len) {
+    __atomic_store_n(&ring->tail, ring->tail + len, __ATOMIC_RELEASE);
+}
+
+// Drop everything currently buffered (consumer side only)
+static void rx_ring_discard(EvilBw16RxRing* ring) {
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+static inline uint32_t uart_cycles_now(void) {
+    // DWT cycle counter, already enabled by furi_hal for its microsecond delays
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+// Histogram bucket for a processing time: exact below 4us, then four buckets per power of two
+static uint32_t profile_bucket(uint32_t us) {
+    if(us < 4) return us;
+    const uint32_t msb = 31 - __builtin_clz(us);
+    const uint32_t bucket = 4 + (msb - 2) * 4 + ((us >> (msb - 2)) & 3);
+    return MIN(bucket, (uint32_t)EVIL_BW16_PROFILE_BUCKETS - 1);
+}
+
+// Lowest processing time that falls into a bucket
+static uint32_t profile_bucket_floor_us(uint32_t bucket) {
+    if(bucket < 4) return bucket;
+    const uint32_t msb = (bucket - 4) / 4 + 2;
+    return (4 + ((bucket - 4) & 3)) << (msb - 2);
+}
+
+static void profile_record(EvilBw16UartProfile* profile, uint32_t cycles) {
+    profile->lines++;
+    profile->cycles += cycles;
+    if(cycles > profile->max_cycles) profile->max_cycles = cycles;
+    profile->histogram[profile_bucket(cycles / furi_hal_cortex_instructions_per_microsecond())]++;
+}
+
+// Track the fill level after a burst (producer side only). The worker swaps the window
+// mark back to zero, so it is raised with a compare-and-swap rather than a plain store.
+static inline void rx_ring_note_fill(EvilBw16RxRing* ring, uint32_t head) {
+    const uint32_t used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if(used > ring->high_water) __atomic_store_n(&ring->high_water, used, __ATOMIC_RELAXED);
+    uint32_t window = __atomic_load_n(&ring->window_high_water, __ATOMIC_RELAXED);
+    while(used > window &&
+          !__atomic_compare_exchange_n(&ring->window_high_water, &window, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Bump a counter that other threads read for stats (writer thread only)
+static inline void uart_count(uint32_t* counter, uint32_t count) {
+    __atomic_store_n(counter, *counter + count, __ATOMIC_RELAXED);
+}
+
+// Count bytes lost to a full ring (producer side only)
+static inline void rx_ring_note_dropped(EvilBw16RxRing* ring, uint32_t count) {
+    __atomic_store_n(&ring->dropped, ring->dropped + count, __ATOMIC_RELAXED);
+}
+
 // UART receive callback function
 static void uart_on_irq_cb(FuriHalSerialHandle* handle, FuriHalSerialRxEvent event, void* context) {
     EvilBw16UartWorker* worker = (EvilBw16UartWorker*)context;
     
     if(event == FuriHalSerialRxEventData) {
-        // Read available data and put it in stream buffer
+        EvilBw16RxRing* ring = &worker->rx_ring;
+        uint32_t head = ring->head;
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        bool line_end = false;
+        
+        // Fill the ring directly and publish the new head once for the whole burst
         while(furi_hal_serial_async_rx_available(handle)) {
             uint8_t data = furi_hal_serial_async_rx(handle);
-            furi_stream_buffer_send(worker->rx_stream, &data, 1, 0);
+            if(head - tail > ring->mask) {
+                // Looks full - re-read tail in case the worker caught up meanwhile
+                tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+                if(head - tail > ring->mask) {
+                    rx_ring_note_dropped(ring, 1);
+                    continue;
+                }
+            }
+            ring->data[head & ring->mask] = data;
+            head++;
+            if(data == '\n' || data == '\r') line_end = true;
+        }
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        rx_ring_note_fill(ring, head);
+        
+        // Only wake the worker once there is something worth framing
+        if(line_end || head - tail >= RX_WAKE_THRESHOLD) {
+            furi_thread_flags_set(worker->thread_id, WorkerEvtRxDone);
         }
     }
+    
+    // Frames have no line end; the idle line after a burst marks the end of one
+    if((event & FuriHalSerialRxEventIdle) && __atomic_load_n(&worker->binary_mode, __ATOMIC_RELAXED)) {
+        furi_thread_flags_set(worker->thread_id, WorkerEvtRxDone);
+    }
 }
 
-// Worker thread for processing UART data
-static int32_t uart_worker_thread(void* context) {
-    EvilBw16UartWorker* worker = (EvilBw16UartWorker*)context;
+// Find the first '\n' or '\r' in a block
+static const uint8_t* uart_find_line_end(const uint8_t* data, size_t len) {
+    const uint8_t* lf = memchr(data, '\n', len);
+    const uint8_t* cr = memchr(data, '\r', lf ? (size_t)(lf - data) : len);
+    return cr ? cr : lf;
+}
+
+static void uart_check_waiter(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    furi_mutex_acquire(worker->waiter_mutex, FuriWaitForever);
+    if(worker->waiter.prefix && !worker->waiter.matched &&
+       evil_bw16_line_starts_with(line, worker->waiter.prefix)) {
+        const size_t len = MIN(line.len, worker->waiter.buffer_size - 1);
+        memcpy(worker->waiter.buffer, line.data, len);
+        worker->waiter.buffer[len] = '\0';
+        worker->waiter.matched = true;
+        furi_semaphore_release(worker->waiter_done);
+    }
+    furi_mutex_release(worker->waiter_mutex);
+}
+
+// Switch RX between lines and frames (worker thread, or with the worker idle)
+static void uart_set_binary(EvilBw16UartWorker* worker, bool binary) {
+    if(binary) {
+        if(!worker->decoder) {
+            EvilBw16ProtoDecoder* decoder = malloc(sizeof(EvilBw16ProtoDecoder));
+            evil_bw16_proto_decoder_init(decoder);
+            __atomic_store_n(&worker->decoder, decoder, __ATOMIC_RELEASE);
+        }
+        evil_bw16_proto_decoder_reset(worker->decoder);
+        worker->proto_skipped = worker->decoder->skipped;
+    }
+    worker->scan_pos = 0;
+    __atomic_store_n(&worker->binary_mode, binary, __ATOMIC_RELEASE);
+    EVIL_BW16_LOG_I("Link protocol: %s", binary ? "binary" : "text");
+}
+
+// The BW16 acknowledges a framing change in the old framing, then switches
+static void uart_check_proto_ack(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    if(worker->binary_mode) {
+        if(evil_bw16_line_starts_with(line, PROTO_ACK_TEXT)) uart_set_binary(worker, false);
+    } else if(worker->binary_requested && evil_bw16_line_starts_with(line, PROTO_ACK_BINARY)) {
+        uart_set_binary(worker, true);
+    }
+}
+
+// Handle one complete line of text from the BW16.
+// The view points straight into the RX ring (or the wrap stash) and is only valid for this call.
+static void uart_handle_line(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    // Filter out WebUI spam patterns to reduce log noise (single pass over the line)
+    if(evil_bw16_filter_match(worker->webui_filter, line) >= 0) {
+        return;  // Skip WebUI internal messages
+    }
+    
+    // Process complete line
+    EVIL_BW16_LOG_D("RX: %.*s", (int)line.len, line.data);
+    
+    // Check if this is a command echo - if so, only skip response processing, not display
+    bool is_echo = is_command_echo(worker, line);
+    
+    if(!is_echo && (worker->binary_requested || worker->binary_mode)) {
+        uart_check_proto_ack(worker, line);
+    }
+    
+    if(!is_echo && worker->link.expect && evil_bw16_line_starts_with(line, worker->link.expect)) {
+        worker->link.matched = true;
+    }
+    
+    // Hand the line to a thread blocked in evil_bw16_uart_wait_for_response(). The unlocked
+    // peek keeps the mutex off the path of every line; uart_check_waiter() looks again.
+    if(!is_echo && __atomic_load_n(&worker->waiter.prefix, __ATOMIC_ACQUIRE)) {
+        uart_check_waiter(worker, line);
+    }
     
-    char* line_buffer = worker->line_buffer;  // Use heap-allocated buffer
-    size_t line_pos = 0;
-    const size_t max_line_size = 512;
+    // Dispatch by response type only if not an echo
+    if(!is_echo) {
+        const EvilBw16ResponseType type = evil_bw16_classify_line(line);
+        if(worker->handlers[type].handler) {
+            worker->handlers[type].handler(line, worker->handlers[type].context);
+        }
+    }
     
-    while(worker->running) {
-        uint8_t byte;
-        size_t received = furi_stream_buffer_receive(worker->rx_stream, &byte, 1, 100);
+    // ALWAYS add to app log for live display (even command echoes)
+    if(worker->app) {
+        evil_bw16_append_log_line(worker->app, line);
         
-        if(received > 0) {
-            // Handle incoming byte
-            if(byte == '\n' || byte == '\r') {
-                if(line_pos > 0) {
-                    line_buffer[line_pos] = '\0';
-                    
-                    // Skip empty lines and filter WebUI spam
-                    if(strlen(line_buffer) == 0) {
-                        line_pos = 0;
-                        continue;
-                    }
-                    
-                    // Filter out WebUI spam patterns to reduce log noise
-                    if(strstr(line_buffer, "WebSocket") != NULL ||
-                       strstr(line_buffer, "HTTP GET") != NULL ||
-                       strstr(line_buffer, "Content-Type:") != NULL ||
-                       strstr(line_buffer, "Connection:") != NULL ||
-                       (line_buffer[0] == '{' && strstr(line_buffer, "\"type\"") != NULL)) {
-                        line_pos = 0;
-                        continue;  // Skip WebUI internal messages
-                    }
-                    
-                    // Process complete line
-                    FURI_LOG_I("EvilBw16", "RX: %s", line_buffer);
-                    
-                    // Check if this is a command echo - if so, only skip response processing, not display
-                    bool is_echo = is_command_echo(worker, line_buffer);
-                    
-                    // Parse different response types only if not an echo
-                    if(!is_echo) {
-                        if(strncmp(line_buffer, "[INFO]", 6) == 0) {
-                            handle_info_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[ERROR]", 7) == 0) {
-                            handle_error_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[DEBUG]", 7) == 0) {
-                            handle_debug_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[CMD]", 5) == 0) {
-                            handle_cmd_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[MGMT]", 6) == 0) {
-                            handle_mgmt_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[DATA]", 6) == 0) {
-                            handle_data_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "[HOP]", 5) == 0) {
-                            handle_hop_response(worker, line_buffer);
-                        }
-                        else if(strncmp(line_buffer, "RAW UART RX:", 12) == 0 ||
-                                strncmp(line_buffer, "Received Command:", 17) == 0 ||
-                                strncmp(line_buffer, "SCAN COMMAND", 12) == 0) {
-                            // These are our debug messages from Arduino - handle specially
-                            handle_debug_response(worker, line_buffer);
-                        }
-                        else {
-                            // Generic response - but be more selective
-                            if(strlen(line_buffer) > 3) { // Only process substantial responses
-                                handle_generic_response(worker, line_buffer);
-                            }
-                        }
-                    }
-                    
-                    // ALWAYS add to app log for live display (even command echoes)
-                    if(worker->app) {
-                        evil_bw16_append_log(worker->app, line_buffer);
-                        
-                        // Rate limit UI updates for high-volume WebUI data
-                        uint32_t now = furi_get_tick();
-                        if(now - worker->last_log_update > 200) { // Max 5 refreshes per second for WebUI data
-                            if(worker->app->view_dispatcher) {
-                                // Simply send refresh event - the scene handler will ignore it if not in UART terminal
-                                view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventUartTerminalRefresh);
-                                worker->last_log_update = now;
-                            }
-                        }
-                    }
-                }
-                line_pos = 0;
+        // Coalesced, the terminal scene ignores it when not shown
+        evil_bw16_notify(worker->app->notifier, EvilBw16NotifyTerminal);
+    }
+}
+
+static void uart_process_line(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    if(!worker->profiling) {
+        uart_handle_line(worker, line);
+        return;
+    }
+    
+    const uint32_t start = uart_cycles_now();
+    uart_handle_line(worker, line);
+    profile_record(&worker->profile, uart_cycles_now() - start);
+}
+
+// Handle one binary frame. Text frames take the line path; the structured types go
+// straight into the app state without any text parsing.
+static void uart_handle_frame(EvilBw16UartWorker* worker, const EvilBw16ProtoDecoder* frame) {
+    switch(frame->type) {
+        case EvilBw16ProtoTypeText:
+            uart_handle_line(worker, evil_bw16_line_view((const char*)frame->payload, frame->len));
+            break;
+        case EvilBw16ProtoTypeScanResult: {
+            EvilBw16ProtoScanResult result;
+            if(evil_bw16_proto_parse_scan_result(frame->payload, frame->len, &result)) {
+                store_scan_result(worker, &result);
+            }
+            break;
+        }
+        case EvilBw16ProtoTypeScanDone:
+            scan_completed(worker);
+            break;
+        case EvilBw16ProtoTypeFrame: {
+            EvilBw16ProtoFrameInfo info;
+            if(worker->app && evil_bw16_proto_parse_frame_info(frame->payload, frame->len, &info)) {
+                worker->app->sniffer_state.packet_count++;
+                evil_bw16_sniffer_stats_record_frame(&worker->app->sniffer_counters, &info);
+                evil_bw16_notify(worker->app->notifier, EvilBw16NotifyPacket);
+            }
+            break;
+        }
+        default:
+            EVIL_BW16_LOG_D("Unknown frame type 0x%02X", frame->type);
+            break;
+    }
+}
+
+static void uart_process_frame(EvilBw16UartWorker* worker, const EvilBw16ProtoDecoder* frame) {
+    if(!worker->profiling) {
+        uart_handle_frame(worker, frame);
+        return;
+    }
+    
+    const uint32_t start = uart_cycles_now();
+    uart_handle_frame(worker, frame);
+    profile_record(&worker->profile, uart_cycles_now() - start);
+}
+
+// Decode every frame in a contiguous block. The decoder keeps partial frames itself, so
+// the whole block is consumed unless a frame switches the link back to text.
+static size_t uart_decode_frames(EvilBw16UartWorker* worker, const uint8_t* data, size_t len) {
+    EvilBw16ProtoDecoder* decoder = worker->decoder;
+    size_t pos = 0;
+    
+    while(pos < len && worker->binary_mode) {
+        bool frame;
+        pos += evil_bw16_proto_decoder_feed(decoder, data + pos, len - pos, &frame);
+        if(frame) {
+            worker->proto_skipped = decoder->skipped;
+            uart_process_frame(worker, decoder);
+        } else if(decoder->skipped - worker->proto_skipped > PROTO_FALLBACK_BYTES) {
+            // Plain text where frames were expected, most likely the BW16 rebooted
+            EVIL_BW16_LOG_W("No valid frames, falling back to text");
+            uart_count(&worker->proto_fallbacks, 1);
+            worker->binary_requested = false;
+            uart_set_binary(worker, false);
+        }
+    }
+    
+    return pos;
+}
+
+// Append bytes to the partial line stash, flagging lines that outgrow the buffer
+static void uart_stash_line(EvilBw16UartWorker* worker, const uint8_t* data, size_t len) {
+    if(worker->line_overflow) return;
+    if(worker->line_len + len > LINE_BUFFER_SIZE - 1) {
+        // Line too long, drop it to prevent buffer overflow
+        worker->line_len = 0;
+        worker->line_overflow = true;
+        uart_count(&worker->truncated_lines, 1);
+        EVIL_BW16_LOG_W("Line buffer overflow, discarding line");
+        return;
+    }
+    memcpy(worker->line_buffer + worker->line_len, data, len);
+    worker->line_len += len;
+}
+
+// Dispatch every complete line in a contiguous block.
+// Returns how many bytes were consumed; the rest is an unterminated tail.
+static size_t uart_frame_lines(EvilBw16UartWorker* worker, const uint8_t* data, size_t len) {
+    size_t start = 0;
+    size_t pos = worker->scan_pos;
+    
+    while(pos < len) {
+        const uint8_t* line_end = uart_find_line_end(data + pos, len - pos);
+        if(!line_end) break;
+        
+        const size_t end = line_end - data;
+        if(worker->line_overflow) {
+            // Tail end of an oversized line
+            worker->line_overflow = false;
+        } else if(worker->line_len > 0) {
+            // Completes a line that was stashed across the ring wrap
+            uart_stash_line(worker, data + start, end - start);
+            if(!worker->line_overflow) {
+                uart_process_line(worker, evil_bw16_line_view(worker->line_buffer, worker->line_len));
+            }
+            worker->line_overflow = false;
+            worker->line_len = 0;
+        } else if(end > start) {
+            uart_process_line(worker, evil_bw16_line_view((const char*)data + start, end - start));
+        }
+        start = pos = end + 1;
+        
+        // The line was the acknowledgement of binary framing, the rest are frames
+        if(worker->binary_mode) break;
+    }
+    
+    worker->scan_pos = worker->binary_mode ? 0 : len - start;
+    return start;
+}
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Record bytes that arrived since the last drain, before framing releases them
+static void uart_capture_rx(EvilBw16UartWorker* worker) {
+    if(!worker->capture) return;
+    
+    furi_mutex_acquire(worker->capture_mutex, FuriWaitForever);
+    if(worker->capture) {
+        EvilBw16RxRing* ring = &worker->rx_ring;
+        const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        const uint32_t tick = furi_get_tick();
+        
+        // Injected replay data is not part of the session
+        if(worker->rx_paused || (int32_t)(ring->tail - worker->capture_pos) > 0) {
+            worker->capture_pos = worker->rx_paused ? head : ring->tail;
+        }
+        
+        while(worker->capture_pos != head) {
+            const uint32_t offset = worker->capture_pos & ring->mask;
+            const uint32_t count = MIN(head - worker->capture_pos, ring->mask + 1 - offset);
+            evil_bw16_capture_writer_append(worker->capture, tick, &ring->data[offset], count);
+            worker->capture_pos += count;
+        }
+    }
+    furi_mutex_release(worker->capture_mutex);
+}
+#endif
+
+// Frame everything currently in the RX ring
+static void uart_drain_rx(EvilBw16UartWorker* worker) {
+    EvilBw16RxRing* ring = &worker->rx_ring;
+    
+#ifdef EVIL_BW16_DEVTOOLS
+    uart_capture_rx(worker);
+#endif
+    
+    for(;;) {
+        const uint8_t* data;
+        const size_t avail = rx_ring_peek(ring, &data);
+        if(avail <= worker->scan_pos) break;  // Nothing new since the last scan
+        
+        if(worker->binary_mode) {
+            rx_ring_release(ring, uart_decode_frames(worker, data, avail));
+            continue;
+        }
+        
+        const size_t consumed = uart_frame_lines(worker, data, avail);
+        rx_ring_release(ring, consumed);
+        if(worker->binary_mode) continue;
+        
+        const size_t tail_len = avail - consumed;
+        if(tail_len == 0) continue;
+        
+        // The partial tail normally stays in place until its line end arrives. It is
+        // only moved out when it runs into the end of the ring memory or gets too long.
+        const bool at_wrap = ((ring->tail + tail_len) & ring->mask) == 0;
+        if(at_wrap || worker->line_overflow || tail_len >= LINE_BUFFER_SIZE - 1) {
+            uart_stash_line(worker, data + consumed, tail_len);
+            rx_ring_release(ring, tail_len);
+            worker->scan_pos = 0;
+            if(at_wrap) continue;
+        }
+        break;
+    }
+}
+
+// Double the ring (worker thread only). Buffered bytes are copied while the ISR keeps
+// filling the old ring, then the few that arrived meanwhile are copied and the buffers
+// swapped with interrupts off. Indices keep running, so nothing else changes.
+static bool uart_grow_rx_ring(EvilBw16UartWorker* worker) {
+    EvilBw16RxRing* ring = &worker->rx_ring;
+    const uint32_t old_size = ring->mask + 1;
+    const uint32_t new_size = old_size * 2;
+    
+    if(new_size > EVIL_BW16_UART_RX_BUF_MAX) return false;
+    if(memmgr_get_free_heap() < new_size + RX_GROW_HEAP_RESERVE) {
+        EVIL_BW16_LOG_W("Not enough heap to grow RX ring to %lu", new_size);
+        return false;
+    }
+    
+    uint8_t* new_data = malloc(new_size);
+    uint8_t* old_data = ring->data;
+    const uint32_t new_mask = new_size - 1;
+    bool swapped = false;
+    
+    // The producer never writes over unread bytes, so [tail, head) is stable here
+    const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    for(uint32_t i = ring->tail; i != head; i++) {
+        new_data[i & new_mask] = old_data[i & ring->mask];
+    }
+    
+    FURI_CRITICAL_ENTER();
+    // An injecting replay writes the ring from a thread; leave it alone meanwhile
+    if(!worker->rx_paused) {
+        for(uint32_t i = head; i != ring->head; i++) {
+            new_data[i & new_mask] = old_data[i & ring->mask];
+        }
+        ring->data = new_data;
+        ring->mask = new_mask;
+        swapped = true;
+    }
+    FURI_CRITICAL_EXIT();
+    
+    free(swapped ? old_data : new_data);
+    if(swapped) {
+        uart_count(&worker->ring_grows, 1);
+        EVIL_BW16_LOG_I("RX ring grown to %lu bytes", new_size);
+    }
+    return swapped;
+}
+
+// Once per window: report overruns and, in adaptive mode, grow a ring that keeps running near full
+static void uart_check_rx_pressure(EvilBw16UartWorker* worker) {
+    const uint32_t now = furi_get_tick();
+    if(now - worker->last_pressure_check < RX_PRESSURE_WINDOW_MS) return;
+    worker->last_pressure_check = now;
+    
+    EvilBw16RxRing* ring = &worker->rx_ring;
+    // Take and reset the window mark in one step, so a burst landing in between still counts
+    const uint32_t window_high = __atomic_exchange_n(&ring->window_high_water, 0, __ATOMIC_RELAXED);
+    const uint32_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    const bool overran = dropped != worker->pressure_dropped;
+    if(overran) {
+        EVIL_BW16_LOG_W("RX ring overrun: %lu bytes dropped", dropped - worker->pressure_dropped);
+        worker->pressure_dropped = dropped;
+    }
+    
+    const uint32_t size = ring->mask + 1;
+    if(overran || window_high >= size - size / 4) {
+        worker->pressure_windows++;
+    } else {
+        worker->pressure_windows = 0;
+    }
+    
+    if(worker->app && worker->app->config.adaptive_rx_buffer &&
+       (overran || worker->pressure_windows >= RX_PRESSURE_WINDOWS)) {
+        worker->pressure_windows = 0;
+        uart_grow_rx_ring(worker);
+    }
+}
+
+// Drop everything received so far, partial line included (worker thread)
+static void uart_discard_rx(EvilBw16UartWorker* worker) {
+    rx_ring_discard(&worker->rx_ring);
+    worker->line_len = 0;
+    worker->scan_pos = 0;
+    worker->line_overflow = false;
+}
+
+// Link negotiation.
+//
+// The worker runs it itself so no other thread blocks on the BW16: each step sends a
+// command and returns, the reply is matched as it is read, and uart_link_poll() moves on
+// when it arrives or the step times out. It always starts from the boot state (plain lines
+// at the boot rate), tries the rates up to the configured one highest first, then asks for
+// framing if configured. EvilBw16NotifyLink tells the GUI when the link is settled.
+
+static void uart_link_expect(EvilBw16UartWorker* worker, LinkStep step, const char* command, const char* expect, uint32_t timeout_ms) {
+    worker->link.step = step;
+    worker->link.expect = expect;
+    worker->link.matched = false;
+    worker->link.deadline = furi_get_tick() + furi_ms_to_ticks(timeout_ms);
+    evil_bw16_uart_send_command(worker, command);
+}
+
+// Tell the BW16 to change rate, then follow it
+static void uart_link_switch_baud(EvilBw16UartWorker* worker, uint32_t baud_rate) {
+    char command[32];
+    snprintf(command, sizeof(command), "set baud %lu", baud_rate);
+    evil_bw16_uart_send_command(worker, command);
+    furi_delay_ms(BAUD_SWITCH_SETTLE_MS);
+    furi_hal_serial_set_br(worker->serial_handle, baud_rate);
+    __atomic_store_n(&worker->baud_rate, baud_rate, __ATOMIC_RELAXED);
+    // Whatever arrived across the switch is line noise
+    uart_discard_rx(worker);
+}
+
+static void uart_link_finish(EvilBw16UartWorker* worker) {
+    worker->link.step = LinkStepIdle;
+    worker->link.expect = NULL;
+    __atomic_store_n(&worker->link_pending, false, __ATOMIC_RELEASE);
+    EVIL_BW16_LOG_I("Link ready: %lu baud, %s", worker->baud_rate, worker->binary_mode ? "binary" : "text");
+    if(worker->app) evil_bw16_notify(worker->app->notifier, EvilBw16NotifyLink);
+}
+
+static void uart_link_request_framing(EvilBw16UartWorker* worker) {
+    if(worker->app && worker->app->config.binary_protocol) {
+        worker->binary_requested = true;
+        uart_link_expect(worker, LinkStepBinaryAck, "set proto binary", PROTO_ACK_BINARY, PROTO_ACK_TIMEOUT_MS);
+    } else {
+        uart_link_finish(worker);
+    }
+}
+
+// Try the next rate up to the configured maximum, or move on to framing when none is left
+static void uart_link_try_next_rate(EvilBw16UartWorker* worker) {
+    const uint32_t max_baud = worker->app ? worker->app->config.baud_rate : EVIL_BW16_UART_BAUD_RATE;
+    for(; worker->link.rate_index < COUNT_OF(uart_baud_rates); worker->link.rate_index++) {
+        const uint32_t rate = uart_baud_rates[worker->link.rate_index];
+        if(rate > max_baud || rate <= EVIL_BW16_UART_BAUD_RATE) continue;
+        
+        EVIL_BW16_LOG_I("Trying %lu baud", rate);
+        uart_link_switch_baud(worker, rate);
+        uart_link_expect(worker, LinkStepBaudReply, "info", "[INFO]", BAUD_VERIFY_TIMEOUT_MS);
+        return;
+    }
+    uart_link_request_framing(worker);
+}
+
+static void uart_link_from_boot_rate(EvilBw16UartWorker* worker) {
+    if(worker->baud_rate != EVIL_BW16_UART_BAUD_RATE) {
+        uart_link_switch_baud(worker, EVIL_BW16_UART_BAUD_RATE);
+    }
+    worker->link.rate_index = 0;
+    uart_link_try_next_rate(worker);
+}
+
+static void uart_link_begin(EvilBw16UartWorker* worker) {
+    if(worker->binary_mode) {
+        worker->binary_requested = false;
+        uart_link_expect(worker, LinkStepTextAck, "set proto text", PROTO_ACK_TEXT, PROTO_ACK_TIMEOUT_MS);
+    } else {
+        uart_link_from_boot_rate(worker);
+    }
+}
+
+// Move on once the current step was answered or timed out
+static void uart_link_poll(EvilBw16UartWorker* worker) {
+    const bool matched = worker->link.matched;
+    if(!matched && (int32_t)(furi_get_tick() - worker->link.deadline) < 0) return;
+    worker->link.expect = NULL;
+    
+    switch(worker->link.step) {
+        case LinkStepTextAck:
+            if(!matched) {
+                // Read plain lines regardless; the fallback to text would get there anyway
+                EVIL_BW16_LOG_W("BW16 did not acknowledge text framing");
+                uart_set_binary(worker, false);
             }
-            else if(line_pos < max_line_size - 1) {
-                line_buffer[line_pos++] = byte;
+            uart_link_from_boot_rate(worker);
+            break;
+            
+        case LinkStepBaudReply:
+            if(matched) {
+                EVIL_BW16_LOG_I("Link verified at %lu baud", worker->baud_rate);
+                uart_link_request_framing(worker);
             } else {
-                // Line too long, reset to prevent buffer overflow
-                line_pos = 0;
-                FURI_LOG_W("EvilBw16", "Line buffer overflow, resetting");
+                // In case the BW16 did switch and only the reply got lost
+                EVIL_BW16_LOG_W("No reply at %lu baud, falling back", worker->baud_rate);
+                uart_link_switch_baud(worker, EVIL_BW16_UART_BAUD_RATE);
+                worker->link.rate_index++;
+                uart_link_try_next_rate(worker);
+            }
+            break;
+            
+        case LinkStepBinaryAck:
+            if(!matched) {
+                // As with firmware that predates framing; the link stays on text
+                worker->binary_requested = false;
+                EVIL_BW16_LOG_W("BW16 did not acknowledge binary framing");
             }
+            uart_link_finish(worker);
+            break;
+            
+        default:
+            break;
+    }
+}
+
+// Worker thread for processing UART data
+static int32_t uart_worker_thread(void* context) {
+    EvilBw16UartWorker* worker = (EvilBw16UartWorker*)context;
+    
+    while(__atomic_load_n(&worker->running, __ATOMIC_ACQUIRE)) {
+        // Sleep until the ISR sees a line end or a fill threshold
+        uint32_t events = furi_thread_flags_wait(WORKER_ALL_EVENTS, FuriFlagWaitAny, 100);
+        if(!(events & FuriFlagError)) {
+            if(events & WorkerEvtStop) break;
+            if(events & WorkerEvtRxFlush) uart_discard_rx(worker);
+            if(events & WorkerEvtLink) uart_link_begin(worker);
         }
+        
+        uart_drain_rx(worker);
+        uart_check_rx_pressure(worker);
+        if(worker->link.step != LinkStepIdle) uart_link_poll(worker);
     }
     
     return 0;
 }
 
 // Response handler functions
-static void handle_info_response(EvilBw16UartWorker* worker, const char* line) {
+static bool is_scan_result_line(EvilBw16LineView line) {
+    if(!evil_bw16_line_starts_with(line, "[INFO] ") || line.len <= 8) return false;
+    EvilBw16LineView after_prefix = evil_bw16_line_skip(line, 7); // Skip "[INFO] "
+    return after_prefix.data[0] >= '0' && after_prefix.data[0] <= '9' && memchr(after_prefix.data, '\t', after_prefix.len) != NULL;
+}
+
+static void handle_info_response(EvilBw16LineView line, void* context) {
+    EvilBw16UartWorker* worker = context;
     if(!worker->app) return;
     
     // Write to debug log
-    debug_write_to_sd(line);
+    debug_write_line_to_sd(worker->app, line);
     
     // Parse scan results - look for the actual header format
-    if(strstr(line, "Index") != NULL && strstr(line, "SSID") != NULL && strstr(line, "BSSID") != NULL) {
-        // This is a scan result header - clear previous results
-        worker->app->network_count = 0;
-        memset(worker->app->networks, 0, sizeof(worker->app->networks));
+    if(evil_bw16_line_contains(line, "Index") && evil_bw16_line_contains(line, "SSID") && evil_bw16_line_contains(line, "BSSID")) {
+        // This is a scan result header - merge what follows as a new scan, after dropping
+        // networks not heard for a while so the list does not fill with them
+        const size_t aged = evil_bw16_network_table_age(worker->app->networks, furi_ms_to_ticks(EVIL_BW16_NETWORK_MAX_AGE_MS));
+        evil_bw16_network_table_begin_scan(worker->app->networks);
         worker->app->scan_in_progress = true;
-        FURI_LOG_I("EvilBw16", "Scan results header detected - cleared previous results");
-    }
-    // Look for actual scan result lines - must start with "[INFO] " followed by a digit and tab
-    else if(strncmp(line, "[INFO] ", 7) == 0 && strlen(line) > 8) {
-        const char* after_prefix = line + 7; // Skip "[INFO] "
-        if(after_prefix[0] >= '0' && after_prefix[0] <= '9' && strchr(after_prefix, '\t') != NULL) {
-            // This looks like a scan result line: "[INFO] 0\tSSID\t..."
-            parse_scan_result_line(worker, line);
-        }
+        evil_bw16_notify(worker->app->notifier, EvilBw16NotifyScan);
+        EVIL_BW16_LOG_I("Scan results header detected - merging new scan into %u networks, %u aged out",
+                        evil_bw16_network_table_count(worker->app->networks), aged);
+    }
+    // Look for actual scan result lines - must start with "[INFO] " followed by a digit and tab,
+    // other INFO lines fall through to the checks below
+    else if(is_scan_result_line(line)) {
+        // This looks like a scan result line: "[INFO] 0\tSSID\t..."
+        parse_scan_result_line(worker, line);
     }
     // Scan completion - wait for "Scan results printed" message
-    else if(strstr(line, "Scan results printed") != NULL || 
-            strstr(line, "Scan completed") != NULL) {
-        // Scan finished - update UI
-        worker->app->scan_in_progress = false;
-        FURI_LOG_I("EvilBw16", "Scan completed with %d networks", worker->app->network_count);
-        // Send event to update scanner scene
-        if(worker->app->view_dispatcher) {
-            view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventScanComplete);
-        }
+    else if(evil_bw16_line_contains(line, "Scan results printed") || 
+            evil_bw16_line_contains(line, "Scan completed")) {
+        scan_completed(worker);
     }
-    else if(strstr(line, "Deauth") != NULL) {
+    else if(evil_bw16_line_contains(line, "Deauth")) {
         // Attack progress notification
-        FURI_LOG_I("EvilBw16", "Attack progress: %s", line);
+        EVIL_BW16_LOG_D("Attack progress: %.*s", (int)line.len, line.data);
     }
 }
 
-static void handle_error_response(EvilBw16UartWorker* worker, const char* line) {
-    UNUSED(worker);
-    FURI_LOG_E("EvilBw16", "Arduino Error: %s", line);
+static void handle_error_response(EvilBw16LineView line, void* context) {
+    UNUSED(context);
+    EVIL_BW16_LOG_E("Arduino Error: %.*s", (int)line.len, line.data);
 }
 
-static void handle_debug_response(EvilBw16UartWorker* worker, const char* line) {
-    UNUSED(worker);
-    FURI_LOG_D("EvilBw16", "Arduino Debug: %s", line);
+static void handle_debug_response(EvilBw16LineView line, void* context) {
+    UNUSED(context);
+    EVIL_BW16_LOG_D("Arduino Debug: %.*s", (int)line.len, line.data);
 }
 
-static void handle_cmd_response(EvilBw16UartWorker* worker, const char* line) {
+static void handle_cmd_response(EvilBw16LineView line, void* context) {
+    EvilBw16UartWorker* worker = context;
     if(!worker->app) return;
     
-    FURI_LOG_I("EvilBw16", "Command response: %s", line);
+    EVIL_BW16_LOG_D("Command response: %.*s", (int)line.len, line.data);
     
     // Update sniffer state based on command responses
-    if(strstr(line, "sniffing mode") != NULL) {
+    if(evil_bw16_line_contains(line, "sniffing mode")) {
+        // Counters first, so whoever sees is_running reads the fresh ones
+        evil_bw16_sniffer_stats_reset(&worker->app->sniffer_counters);
         worker->app->sniffer_state.is_running = true;
         // Send event to update sniffer UI
         if(worker->app->view_dispatcher) {
             view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventSnifferStarted);
         }
     }
-    else if(strstr(line, "Sniffer stopped") != NULL) {
+    else if(evil_bw16_line_contains(line, "Sniffer stopped")) {
         worker->app->sniffer_state.is_running = false;
         if(worker->app->view_dispatcher) {
             view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventSnifferStopped);
@@ -227,167 +858,113 @@ static void handle_cmd_response(EvilBw16UartWorker* worker, const char* line) {
     }
 }
 
-static void handle_mgmt_response(EvilBw16UartWorker* worker, const char* line) {
+static void handle_mgmt_response(EvilBw16LineView line, void* context) {
+    EvilBw16UartWorker* worker = context;
     if(!worker->app) return;
     
     // Increment packet count for management frames
     worker->app->sniffer_state.packet_count++;
+    evil_bw16_sniffer_stats_record(&worker->app->sniffer_counters, line, false);
     
     // Log the management frame
-    FURI_LOG_I("EvilBw16", "MGMT Frame: %s", line);
+    EVIL_BW16_LOG_D("MGMT Frame: %.*s", (int)line.len, line.data);
     
-    // Send event to update sniffer UI if in sniffer scene
-    if(worker->app->view_dispatcher) {
-        view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventPacketReceived);
-    }
+    // Update the sniffer UI, at most once per notify interval
+    evil_bw16_notify(worker->app->notifier, EvilBw16NotifyPacket);
 }
 
-static void handle_data_response(EvilBw16UartWorker* worker, const char* line) {
+static void handle_data_response(EvilBw16LineView line, void* context) {
+    EvilBw16UartWorker* worker = context;
     if(!worker->app) return;
     
     // Increment packet count for data frames
     worker->app->sniffer_state.packet_count++;
+    evil_bw16_sniffer_stats_record(&worker->app->sniffer_counters, line, true);
     
     // Log the data frame (especially EAPOL)
-    FURI_LOG_I("EvilBw16", "DATA Frame: %s", line);
+    EVIL_BW16_LOG_D("DATA Frame: %.*s", (int)line.len, line.data);
     
     // Special handling for EAPOL
-    if(strstr(line, "EAPOL") != NULL) {
-        FURI_LOG_I("EvilBw16", "EAPOL handshake detected!");
+    if(evil_bw16_line_contains(line, "EAPOL")) {
+        EVIL_BW16_LOG_I("EAPOL handshake detected!");
         // Could add special notification here
     }
     
-    if(worker->app->view_dispatcher) {
-        view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventPacketReceived);
-    }
+    evil_bw16_notify(worker->app->notifier, EvilBw16NotifyPacket);
 }
 
-static void handle_hop_response(EvilBw16UartWorker* worker, const char* line) {
-    UNUSED(worker);
-    FURI_LOG_I("EvilBw16", "Channel hop: %s", line);
+static void handle_hop_response(EvilBw16LineView line, void* context) {
+    UNUSED(context);
+    EVIL_BW16_LOG_D("Channel hop: %.*s", (int)line.len, line.data);
 }
 
-static void handle_generic_response(EvilBw16UartWorker* worker, const char* line) {
-    UNUSED(worker);
-    FURI_LOG_I("EvilBw16", "Generic: %s", line);
+static void handle_generic_response(EvilBw16LineView line, void* context) {
+    UNUSED(context);
+    // Be selective - only process substantial responses
+    if(line.len <= 3) return;
+    EVIL_BW16_LOG_D("Generic: %.*s", (int)line.len, line.data);
 }
 
-// Parse scan result line like: "[INFO] 0\tSSID_NAME\tBSSID\tChannel\tRSSI\tFrequency"
-static void parse_scan_result_line(EvilBw16UartWorker* worker, const char* line) {
-    if(!worker || !worker->app) return;
-    if(worker->app->network_count >= EVIL_BW16_MAX_NETWORKS) return;
-    
-    // Skip "[INFO] " prefix (7 characters)
-    const char* data = line + 7;
-    
-    // Manual tab parsing without strtok (not available in Flipper API)
-    const char* field_starts[6] = {0}; // index, ssid, bssid, channel, rssi, frequency
-    int field_lengths[6] = {0};
-    int field_count = 0;
-    
-    // Find field boundaries manually
-    const char* current = data;
-    field_starts[field_count] = current;
-    
-    while(*current && field_count < 6) {
-        if(*current == '\t' || *current == '\n' || *current == '\r') {
-            field_lengths[field_count] = current - field_starts[field_count];
-            field_count++;
-            
-            if(field_count < 6) {
-                current++; // Skip the tab
-                while(*current == ' ') current++; // Skip any spaces after tab
-                field_starts[field_count] = current;
-            }
-        } else {
-            current++;
-        }
-    }
-    
-    // Handle the last field if we reached end of string
-    if(field_count < 6 && *current == '\0') {
-        field_lengths[field_count] = current - field_starts[field_count];
-        field_count++;
+// Scan finished - update UI
+static void scan_completed(EvilBw16UartWorker* worker) {
+    if(!worker->app) return;
+    worker->app->scan_in_progress = false;
+    EVIL_BW16_LOG_I("Scan completed with %u networks", evil_bw16_network_table_count(worker->app->networks));
+    // Send event to update scanner scene
+    if(worker->app->view_dispatcher) {
+        view_dispatcher_send_custom_event(worker->app->view_dispatcher, EvilBw16EventScanComplete);
     }
-    
-    // Need at least 5 fields (index, ssid, bssid, channel, rssi)
-    if(field_count < 5) {
-        FURI_LOG_W("EvilBw16", "Invalid scan line, only %d fields: %s", field_count, line);
+}
+
+// Add a parsed network to the scan list, or refresh it if its BSSID is already there
+static void store_network(EvilBw16UartWorker* worker, const EvilBw16Network* network, EvilBw16LineView ssid) {
+    bool created;
+    const EvilBw16NetworkHandle handle = evil_bw16_network_table_upsert(worker->app->networks, network, ssid, &created);
+    if(handle == EVIL_BW16_NETWORK_NONE) {
+        EVIL_BW16_LOG_W("Scan list full, dropped '%.*s'", (int)ssid.len, ssid.data);
         return;
     }
+    evil_bw16_notify(worker->app->notifier, EvilBw16NotifyScan);
+    
+    EVIL_BW16_LOG_D("%s network %u (device_idx=%d): '%.*s' Ch:%d RSSI:%d %s",
+                    created ? "Added" : "Updated", handle, network->device_index, (int)ssid.len, ssid.data,
+                    network->channel, network->rssi, (network->band == EvilBw16Band5GHz) ? "5GHz" : "2.4GHz");
+}
+
+// Parse scan result line like: "[INFO] 0\tSSID_NAME\tBSSID\tChannel\tRSSI\tFrequency"
+static void parse_scan_result_line(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    if(!worker || !worker->app) return;
     
-    // Check if we have space for more networks
-    if(worker->app->network_count >= EVIL_BW16_MAX_NETWORKS) {
-        FURI_LOG_W("EvilBw16", "Maximum networks (%d) reached, ignoring additional network", EVIL_BW16_MAX_NETWORKS);
+    EvilBw16Network network = {0};
+    EvilBw16LineView ssid;
+    if(!evil_bw16_parse_scan_result(line, &network, &ssid)) {
+        EVIL_BW16_LOG_W("Invalid scan line: %.*s", (int)line.len, line.data);
         return;
     }
+    store_network(worker, &network, ssid);
+}
+
+// Store a scan result that arrived as a binary frame; the header that clears the
+// previous results still comes as a text frame
+static void store_scan_result(EvilBw16UartWorker* worker, const EvilBw16ProtoScanResult* result) {
+    EvilBw16App* app = worker->app;
+    if(!app) return;
     
-    // Store network data
-    int network_idx = worker->app->network_count;
-    EvilBw16Network* network = &worker->app->networks[network_idx];
-    
-    // Helper function to convert field to string
-    char temp_field[128];
-    
-    // Parse device index (field 0) - this is the index from the BW16 device
-    int len = (field_lengths[0] < 127) ? field_lengths[0] : 127;
-    strncpy(temp_field, field_starts[0], len);
-    temp_field[len] = '\0';
-    int device_index = atoi(temp_field);
-    
-    FURI_LOG_I("EvilBw16", "UART: Parsing field[0]='%s' -> device_index=%d", temp_field, device_index);
-    
-    // Use our internal array index for consistency, but store device index for commands
-    network->index = network_idx;        // Internal array index for menu selection
-    network->device_index = device_index; // Original device index for commands
-    
-    // Initialize selection state
-    network->selected = false;
-    
-    // Copy SSID (field 1)
-    len = (field_lengths[1] < (int)(sizeof(network->ssid) - 1)) ? field_lengths[1] : (int)(sizeof(network->ssid) - 1);
-    strncpy(network->ssid, field_starts[1], len);
-    network->ssid[len] = '\0';
-    
-    // Copy BSSID (field 2)
-    len = (field_lengths[2] < (int)(sizeof(network->bssid) - 1)) ? field_lengths[2] : (int)(sizeof(network->bssid) - 1);
-    strncpy(network->bssid, field_starts[2], len);
-    network->bssid[len] = '\0';
-    
-    // Parse channel (field 3)
-    len = (field_lengths[3] < 127) ? field_lengths[3] : 127;
-    strncpy(temp_field, field_starts[3], len);
-    temp_field[len] = '\0';
-    network->channel = atoi(temp_field);
-    
-    // Parse RSSI (field 4)
-    len = (field_lengths[4] < 127) ? field_lengths[4] : 127;
-    strncpy(temp_field, field_starts[4], len);
-    temp_field[len] = '\0';
-    network->rssi = atoi(temp_field);
-    
-    // Determine band from frequency field or channel number
-    if(field_count >= 6 && field_lengths[5] > 0) {
-        len = (field_lengths[5] < 127) ? field_lengths[5] : 127;
-        strncpy(temp_field, field_starts[5], len);
-        temp_field[len] = '\0';
-        
-        if(strstr(temp_field, "5GHz")) {
-            network->band = EvilBw16Band5GHz;
-        } else {
-            network->band = EvilBw16Band24GHz;
-        }
-    } else if(network->channel >= 36) {
-        network->band = EvilBw16Band5GHz;
-    } else {
-        network->band = EvilBw16Band24GHz;
+    EvilBw16Network network = {0};
+    network.device_index = result->index;
+    memcpy(network.bssid, result->bssid, sizeof(network.bssid));
+    network.channel = result->channel;
+    network.rssi = result->rssi;
+    network.band = result->band_5ghz ? EvilBw16Band5GHz : EvilBw16Band24GHz;
+    store_network(worker, &network, evil_bw16_line_view(result->ssid, result->ssid_len));
+    
+    // Keep the terminal showing what the text protocol would have printed
+    char text[96];
+    const size_t len = evil_bw16_proto_format_scan_text(result, text, sizeof(text));
+    if(len > 0) {
+        evil_bw16_append_log_line(app, evil_bw16_line_view(text, len - 1));
+        evil_bw16_notify(app->notifier, EvilBw16NotifyTerminal);
     }
-    
-    worker->app->network_count++;
-    
-    FURI_LOG_I("EvilBw16", "Parsed network[%d] (device_idx=%d): '%s' (%s) Ch:%d RSSI:%d %s", 
-               network_idx, device_index, network->ssid, network->bssid, network->channel, network->rssi,
-               (network->band == EvilBw16Band5GHz) ? "5GHz" : "2.4GHz");
 }
 
 EvilBw16UartWorker* evil_bw16_uart_init(EvilBw16App* app) {
@@ -396,23 +973,69 @@ EvilBw16UartWorker* evil_bw16_uart_init(EvilBw16App* app) {
     worker->app = app;
     worker->running = true;
     worker->tx_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
-    worker->rx_stream = furi_stream_buffer_alloc(RX_BUFFER_SIZE, 1);
+    worker->webui_filter = evil_bw16_filter_alloc(uart_webui_filter_rules, COUNT_OF(uart_webui_filter_rules));
+    worker->rx_ring.data = malloc(RX_RING_SIZE);
+    worker->rx_ring.mask = RX_RING_SIZE - 1;
+    worker->rx_ring.head = 0;
+    worker->rx_ring.tail = 0;
+    worker->rx_ring.dropped = 0;
+    worker->rx_ring.high_water = 0;
+    worker->rx_ring.window_high_water = 0;
     
     // Initialize echo filtering
-    worker->recent_command_index = 0;
-    memset(worker->recent_commands, 0, sizeof(worker->recent_commands));
-    memset(worker->command_timestamps, 0, sizeof(worker->command_timestamps));
+    memset(&worker->echo_set, 0, sizeof(worker->echo_set));
+    worker->echo_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     
     // Allocate line buffer on heap to reduce stack usage
-    worker->line_buffer = malloc(512);  // Larger buffer for WebUI data
+    worker->line_buffer = malloc(LINE_BUFFER_SIZE);  // Larger buffer for WebUI data
     if(!worker->line_buffer) {
-        FURI_LOG_E("EvilBw16", "Failed to allocate line buffer");
-        furi_stream_buffer_free(worker->rx_stream);
+        EVIL_BW16_LOG_E("Failed to allocate line buffer");
+        free(worker->rx_ring.data);
+        evil_bw16_filter_free(worker->webui_filter);
+        furi_mutex_free(worker->echo_mutex);
         furi_mutex_free(worker->tx_mutex);
         free(worker);
         return NULL;
     }
-    worker->last_log_update = 0;
+    worker->line_len = 0;
+    worker->scan_pos = 0;
+    worker->line_overflow = false;
+    worker->rx_paused = false;
+    worker->profiling = false;
+#ifdef EVIL_BW16_DEVTOOLS
+    worker->capture = NULL;
+    worker->capture_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->capture_pos = 0;
+#endif
+    worker->baud_rate = EVIL_BW16_UART_BAUD_RATE;
+    worker->truncated_lines = 0;
+    worker->ring_grows = 0;
+    worker->pressure_windows = 0;
+    worker->pressure_dropped = 0;
+    worker->last_pressure_check = 0;
+    worker->binary_mode = false;
+    worker->binary_requested = false;
+    worker->decoder = NULL;
+    worker->proto_skipped = 0;
+    worker->proto_fallbacks = 0;
+#ifdef EVIL_BW16_DEVTOOLS
+    worker->tx_tap = NULL;
+    worker->tx_tap_context = NULL;
+#endif
+    memset(&worker->waiter, 0, sizeof(worker->waiter));
+    worker->waiter_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->waiter_done = furi_semaphore_alloc(1, 0);
+    
+    // Built-in response handlers; untagged Arduino debug output is classified as debug too
+    memset(worker->handlers, 0, sizeof(worker->handlers));
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseInfo, handle_info_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseError, handle_error_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseDebug, handle_debug_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseCommand, handle_cmd_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseMgmt, handle_mgmt_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseData, handle_data_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseChannelHop, handle_hop_response, worker);
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseUnknown, handle_generic_response, worker);
     
     // Get serial handle based on GPIO pin configuration
     FuriHalSerialId serial_id;
@@ -426,34 +1049,48 @@ EvilBw16UartWorker* evil_bw16_uart_init(EvilBw16App* app) {
         pin_description = "LPUART (pins 15/16)";
     }
     
-    FURI_LOG_I("EvilBw16", "Attempting to acquire %s", pin_description);
+    EVIL_BW16_LOG_I("Attempting to acquire %s", pin_description);
     
     worker->serial_handle = furi_hal_serial_control_acquire(serial_id);
     if(!worker->serial_handle) {
-        FURI_LOG_E("EvilBw16", "Failed to acquire serial handle for %s", pin_description);
-        FURI_LOG_E("EvilBw16", "Serial ID requested: %d", (int)serial_id);
-        furi_stream_buffer_free(worker->rx_stream);
+        EVIL_BW16_LOG_E("Failed to acquire serial handle for %s", pin_description);
+        EVIL_BW16_LOG_E("Serial ID requested: %d", (int)serial_id);
+        free(worker->rx_ring.data);
+        free(worker->line_buffer);
+        evil_bw16_filter_free(worker->webui_filter);
+#ifdef EVIL_BW16_DEVTOOLS
+        furi_mutex_free(worker->capture_mutex);
+#endif
+        furi_mutex_free(worker->waiter_mutex);
+        furi_semaphore_free(worker->waiter_done);
+        furi_mutex_free(worker->echo_mutex);
         furi_mutex_free(worker->tx_mutex);
         free(worker);
         return NULL;
     }
     
-    FURI_LOG_I("EvilBw16", "Successfully acquired serial handle for %s", pin_description);
-    
-    // Initialize UART
-    furi_hal_serial_init(worker->serial_handle, BAUDRATE);
+    EVIL_BW16_LOG_I("Successfully acquired serial handle for %s", pin_description);
     
-    // Start async RX
-    furi_hal_serial_async_rx_start(worker->serial_handle, uart_on_irq_cb, worker, false);
+    // Initialize UART at the BW16 boot rate; a faster one is negotiated below
+    furi_hal_serial_init(worker->serial_handle, worker->baud_rate);
     
-    // Start worker thread with larger stack for handling high-volume WebUI data
+    // Start worker thread with larger stack for handling high-volume WebUI data.
+    // It must be running before async RX starts so the ISR has a thread to wake.
     worker->thread = furi_thread_alloc_ex("EvilBw16UartWorker", 4096, uart_worker_thread, worker);
     furi_thread_start(worker->thread);
+    worker->thread_id = furi_thread_get_id(worker->thread);
+    
+    // Start async RX
+    furi_hal_serial_async_rx_start(worker->serial_handle, uart_on_irq_cb, worker, false);
     
     uart_worker = worker;
     
-    FURI_LOG_I("EvilBw16", "Hardware UART initialized on %s at %u baud", pin_description, BAUDRATE);
-    FURI_LOG_I("EvilBw16", "UART worker thread started");
+    EVIL_BW16_LOG_I("Hardware UART initialized on %s at %lu baud", pin_description, worker->baud_rate);
+    EVIL_BW16_LOG_I("UART worker thread started");
+    
+    if(app->config.baud_rate > worker->baud_rate || app->config.binary_protocol) {
+        evil_bw16_uart_renegotiate(worker);
+    }
     
     return worker;
 }
@@ -461,11 +1098,16 @@ EvilBw16UartWorker* evil_bw16_uart_init(EvilBw16App* app) {
 void evil_bw16_uart_restart(EvilBw16App* app) {
     if(!app) return;
     
-    FURI_LOG_I("EvilBw16", "Restarting UART worker with new GPIO configuration...");
+    EVIL_BW16_LOG_I("Restarting UART worker with new GPIO configuration...");
+    
+#ifdef EVIL_BW16_DEVTOOLS
+    // The simulator injects into the worker that is about to go away
+    evil_bw16_sim_stop(app->simulator);
+#endif
     
     // Stop current UART worker if it exists
     if(app->uart_worker) {
-        FURI_LOG_I("EvilBw16", "Stopping existing UART worker...");
+        EVIL_BW16_LOG_I("Stopping existing UART worker...");
         evil_bw16_uart_free(app->uart_worker);
         app->uart_worker = NULL;
         // Small delay to ensure cleanup is complete
@@ -484,26 +1126,42 @@ void evil_bw16_uart_restart(EvilBw16App* app) {
     app->uart_worker = evil_bw16_uart_init(app);
     
     if(app->uart_worker) {
-        FURI_LOG_I("EvilBw16", "UART worker restarted successfully");
+        EVIL_BW16_LOG_I("UART worker restarted successfully");
         // Add small delay to ensure proper initialization
         furi_delay_ms(100);
         
         // Send a test command to verify communication
         evil_bw16_uart_send_command(app->uart_worker, "info");
     } else {
-        FURI_LOG_E("EvilBw16", "Failed to restart UART worker");
+        EVIL_BW16_LOG_E("Failed to restart UART worker");
     }
 }
 
 void evil_bw16_uart_free(EvilBw16UartWorker* worker) {
     if(!worker) return;
     
-    worker->running = false;
+    // Same for its boot framing
+    if(__atomic_load_n(&worker->binary_mode, __ATOMIC_ACQUIRE)) {
+        evil_bw16_uart_negotiate_protocol(worker, false);
+    }
+    
+    // Put the BW16 back on its boot rate so the next session can reach it
+    if(__atomic_load_n(&worker->baud_rate, __ATOMIC_RELAXED) != EVIL_BW16_UART_BAUD_RATE) {
+        char command[32];
+        snprintf(command, sizeof(command), "set baud %lu", (uint32_t)EVIL_BW16_UART_BAUD_RATE);
+        evil_bw16_uart_send_command(worker, command);
+        furi_delay_ms(BAUD_SWITCH_SETTLE_MS);
+    }
+    
+    __atomic_store_n(&worker->running, false, __ATOMIC_RELEASE);
     
     // Stop async RX
-    furi_hal_serial_async_rx_stop(worker->serial_handle);
+    if(!worker->rx_paused) {
+        furi_hal_serial_async_rx_stop(worker->serial_handle);
+    }
     
     // Stop worker thread
+    furi_thread_flags_set(worker->thread_id, WorkerEvtStop);
     furi_thread_join(worker->thread);
     furi_thread_free(worker->thread);
     
@@ -511,17 +1169,30 @@ void evil_bw16_uart_free(EvilBw16UartWorker* worker) {
     furi_hal_serial_deinit(worker->serial_handle);
     furi_hal_serial_control_release(worker->serial_handle);
     
+#ifdef EVIL_BW16_DEVTOOLS
+    // Finish a recording still in progress
+    evil_bw16_capture_writer_close(worker->capture);
+#endif
+    
     // Free resources
-    furi_stream_buffer_free(worker->rx_stream);
+    free(worker->rx_ring.data);
+    evil_bw16_filter_free(worker->webui_filter);
+#ifdef EVIL_BW16_DEVTOOLS
+    furi_mutex_free(worker->capture_mutex);
+#endif
+    furi_mutex_free(worker->waiter_mutex);
+    furi_semaphore_free(worker->waiter_done);
+    furi_mutex_free(worker->echo_mutex);
     furi_mutex_free(worker->tx_mutex);
     if(worker->line_buffer) {
         free(worker->line_buffer);
     }
+    free(worker->decoder);
     free(worker);
     
     uart_worker = NULL;
     
-    FURI_LOG_I("EvilBw16", "UART worker freed");
+    EVIL_BW16_LOG_I("UART worker freed");
 }
 
 void evil_bw16_uart_tx(EvilBw16UartWorker* worker, const uint8_t* data, size_t len) {
@@ -535,7 +1206,7 @@ void evil_bw16_uart_tx(EvilBw16UartWorker* worker, const uint8_t* data, size_t l
     
     furi_mutex_release(worker->tx_mutex);
     
-    FURI_LOG_D("EvilBw16", "TX: %.*s", (int)len, data);
+    EVIL_BW16_LOG_D("TX: %.*s", (int)len, data);
 }
 
 void evil_bw16_uart_tx_string(EvilBw16UartWorker* worker, const char* str) {
@@ -549,92 +1220,357 @@ void evil_bw16_uart_send_command(EvilBw16UartWorker* worker, const char* command
     // Store command for echo filtering
     store_sent_command(worker, command);
     
+#ifdef EVIL_BW16_DEVTOOLS
+    // A simulated BW16 answers instead of the real one
+    furi_mutex_acquire(worker->tx_mutex, FuriWaitForever);
+    if(worker->tx_tap) {
+        worker->tx_tap(command, worker->tx_tap_context);
+        furi_mutex_release(worker->tx_mutex);
+        EVIL_BW16_LOG_I("Sent command (simulated): %s", command);
+        return;
+    }
+    furi_mutex_release(worker->tx_mutex);
+#endif
+    
     // Add newline to command
     char cmd_with_newline[256];
     snprintf(cmd_with_newline, sizeof(cmd_with_newline), "%s\n", command);
     
     evil_bw16_uart_tx_string(worker, cmd_with_newline);
     
-    FURI_LOG_I("EvilBw16", "Sent command: %s", command);
+    EVIL_BW16_LOG_I("Sent command: %s", command);
 }
 
-bool evil_bw16_uart_read_line(EvilBw16UartWorker* worker, char* buffer, size_t buffer_size, uint32_t timeout_ms) {
-    if(!worker || !buffer || buffer_size == 0) return false;
-    
-    UNUSED(timeout_ms);
-    
-    // Try to read a line from stream buffer
-    size_t bytes_read = 0;
-    uint32_t start_time = furi_get_tick();
-    
-    while(bytes_read < buffer_size - 1 && (furi_get_tick() - start_time) < timeout_ms) {
-        uint8_t byte;
-        if(furi_stream_buffer_receive(worker->rx_stream, &byte, 1, 10) > 0) {
-            buffer[bytes_read++] = byte;
-            if(byte == '\n') {
-                break;
-            }
-        }
-    }
-    
-    buffer[bytes_read] = '\0';
-    return bytes_read > 0;
+// Install (or with NULL, remove) the handler for one response type.
+// Handlers run on the UART worker thread and the line view is only valid during the call.
+void evil_bw16_uart_set_response_handler(EvilBw16UartWorker* worker, EvilBw16ResponseType type, EvilBw16ResponseHandler handler, void* context) {
+    if(!worker || type >= EvilBw16ResponseTypeNum) return;
+    worker->handlers[type].context = context;
+    worker->handlers[type].handler = handler;
+}
+
+EvilBw16LineFilter* evil_bw16_uart_get_webui_filter(EvilBw16UartWorker* worker) {
+    return worker ? worker->webui_filter : NULL;
 }
 
 size_t evil_bw16_uart_rx_available(EvilBw16UartWorker* worker) {
     if(!worker) return 0;
-    return furi_stream_buffer_bytes_available(worker->rx_stream);
+    return rx_ring_used(&worker->rx_ring);
 }
 
 void evil_bw16_uart_flush_rx(EvilBw16UartWorker* worker) {
     if(!worker) return;
-    furi_stream_buffer_reset(worker->rx_stream);
+    // Only the worker may move the ring tail, so ask it to discard
+    furi_thread_flags_set(worker->thread_id, WorkerEvtRxFlush);
 }
 
-bool evil_bw16_uart_wait_for_response(EvilBw16UartWorker* worker, const char* expected_prefix, char* response_buffer, size_t buffer_size, uint32_t timeout_ms) {
-    if(!worker || !expected_prefix || !response_buffer) return false;
+#ifdef EVIL_BW16_DEVTOOLS
+// Feed bytes into the RX ring as if the UART had received them, for the replay benchmark.
+// The caller must pause async RX first so it is the only producer. Returns the bytes
+// accepted; with drop_when_full the rest is counted as dropped, like an ISR overrun.
+size_t evil_bw16_uart_inject_rx(EvilBw16UartWorker* worker, const uint8_t* data, size_t len, bool drop_when_full) {
+    if(!worker || !data || len == 0) return 0;
+    furi_check(worker->rx_paused);
+    
+    EvilBw16RxRing* ring = &worker->rx_ring;
+    const uint32_t head = ring->head;
+    const uint32_t used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    const size_t accepted = MIN(len, (size_t)(ring->mask + 1 - used));
+    
+    const uint32_t offset = head & ring->mask;
+    const size_t first = MIN(accepted, (size_t)(ring->mask + 1 - offset));
+    memcpy(&ring->data[offset], data, first);
+    memcpy(ring->data, data + first, accepted - first);
+    __atomic_store_n(&ring->head, head + accepted, __ATOMIC_RELEASE);
+    rx_ring_note_fill(ring, head + accepted);
+    
+    if(drop_when_full) rx_ring_note_dropped(ring, len - accepted);
+    
+    // Same wake rule as the ISR, where a binary burst ends with each injected chunk
+    if(__atomic_load_n(&worker->binary_mode, __ATOMIC_RELAXED) || memchr(data, '\n', accepted) || memchr(data, '\r', accepted) || used + accepted >= RX_WAKE_THRESHOLD) {
+        furi_thread_flags_set(worker->thread_id, WorkerEvtRxDone);
+    }
+    
+    return drop_when_full ? len : accepted;
+}
+
+// Stop or restart hardware reception so evil_bw16_uart_inject_rx() can own the ring
+void evil_bw16_uart_pause_rx(EvilBw16UartWorker* worker, bool paused) {
+    if(!worker || worker->rx_paused == paused) return;
+    
+    if(paused) {
+        furi_hal_serial_async_rx_stop(worker->serial_handle);
+        worker->rx_paused = true;
+    } else {
+        worker->rx_paused = false;
+        furi_hal_serial_async_rx_start(worker->serial_handle, uart_on_irq_cb, worker, false);
+    }
+}
+#endif
+
+uint32_t evil_bw16_uart_get_dropped_bytes(EvilBw16UartWorker* worker) {
+    return worker ? __atomic_load_n(&worker->rx_ring.dropped, __ATOMIC_RELAXED) : 0;
+}
+
+void evil_bw16_uart_get_stats(EvilBw16UartWorker* worker, EvilBw16UartStats* stats) {
+    memset(stats, 0, sizeof(EvilBw16UartStats));
+    if(!worker) return;
+    stats->dropped_bytes = __atomic_load_n(&worker->rx_ring.dropped, __ATOMIC_RELAXED);
+    stats->truncated_lines = __atomic_load_n(&worker->truncated_lines, __ATOMIC_RELAXED);
+    stats->high_water = __atomic_load_n(&worker->rx_ring.high_water, __ATOMIC_RELAXED);
+    stats->ring_size = worker->rx_ring.mask + 1;
+    stats->ring_grows = __atomic_load_n(&worker->ring_grows, __ATOMIC_RELAXED);
+    stats->binary_protocol = __atomic_load_n(&worker->binary_mode, __ATOMIC_RELAXED);
+    EvilBw16ProtoDecoder* decoder = __atomic_load_n(&worker->decoder, __ATOMIC_ACQUIRE);
+    stats->frames = decoder ? __atomic_load_n(&decoder->frames, __ATOMIC_RELAXED) : 0;
+    stats->frame_crc_errors = decoder ? __atomic_load_n(&decoder->crc_errors, __ATOMIC_RELAXED) : 0;
+    stats->proto_fallbacks = __atomic_load_n(&worker->proto_fallbacks, __ATOMIC_RELAXED);
+}
+
+// Time every processed line until evil_bw16_uart_profile_stop()
+void evil_bw16_uart_profile_start(EvilBw16UartWorker* worker) {
+    if(!worker) return;
+    worker->profiling = false;
+    memset(&worker->profile, 0, sizeof(EvilBw16UartProfile));
+    worker->profiling = true;
+}
+
+// Stop timing and copy out what was collected
+void evil_bw16_uart_profile_stop(EvilBw16UartWorker* worker, EvilBw16UartProfile* profile) {
+    if(!worker) return;
+    worker->profiling = false;
+    if(profile) *profile = worker->profile;
+}
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Start recording raw received bytes to a capture file, replacing any previous one
+bool evil_bw16_uart_capture_start(EvilBw16UartWorker* worker, const char* path) {
+    if(!worker || worker->capture) return false;
+    
+    EvilBw16CaptureWriter* writer = evil_bw16_capture_writer_open(path);
+    if(!writer) return false;
     
-    UNUSED(buffer_size);
-    UNUSED(timeout_ms);
+    furi_mutex_acquire(worker->capture_mutex, FuriWaitForever);
+    worker->capture_pos = __atomic_load_n(&worker->rx_ring.head, __ATOMIC_ACQUIRE);
+    worker->capture = writer;
+    furi_mutex_release(worker->capture_mutex);
+    
+    EVIL_BW16_LOG_I("RX capture started: %s", path);
+    return true;
+}
+
+void evil_bw16_uart_capture_stop(EvilBw16UartWorker* worker) {
+    if(!worker || !worker->capture) return;
     
-        // For now, return false - focusing on TX first
+    furi_mutex_acquire(worker->capture_mutex, FuriWaitForever);
+    EvilBw16CaptureWriter* writer = worker->capture;
+    worker->capture = NULL;
+    furi_mutex_release(worker->capture_mutex);
+    
+    EVIL_BW16_LOG_I("RX capture stopped after %lu bytes", evil_bw16_capture_writer_get_bytes(writer));
+    evil_bw16_capture_writer_close(writer);
+}
+
+bool evil_bw16_uart_capture_is_active(EvilBw16UartWorker* worker) {
+    return worker && worker->capture;
+}
+
+uint32_t evil_bw16_uart_capture_get_bytes(EvilBw16UartWorker* worker) {
+    return worker ? evil_bw16_capture_writer_get_bytes(worker->capture) : 0;
+}
+#endif
+
+// Processing time (lower bucket bound, microseconds) that percent of the profiled lines stayed within
+uint32_t evil_bw16_profile_percentile_us(const EvilBw16UartProfile* profile, uint8_t percent) {
+    if(!profile || profile->lines == 0) return 0;
+    
+    const uint32_t rank = (uint32_t)(((uint64_t)profile->lines * percent + 99) / 100);
+    uint32_t seen = 0;
+    for(uint32_t bucket = 0; bucket < EVIL_BW16_PROFILE_BUCKETS; bucket++) {
+        seen += profile->histogram[bucket];
+        if(seen >= rank) return profile_bucket_floor_us(bucket);
+    }
+    return profile_bucket_floor_us(EVIL_BW16_PROFILE_BUCKETS - 1);
+}
+
+// Block until a received line starts with expected_prefix and copy it out.
+// Only one thread can wait at a time; command echoes never match.
+bool evil_bw16_uart_wait_for_response(EvilBw16UartWorker* worker, const char* expected_prefix, char* response_buffer, size_t buffer_size, uint32_t timeout_ms) {
+    if(!worker || !expected_prefix || !response_buffer || buffer_size == 0) return false;
     response_buffer[0] = '\0';
-    return false;
+    
+    furi_mutex_acquire(worker->waiter_mutex, FuriWaitForever);
+    if(worker->waiter.prefix) {
+        furi_mutex_release(worker->waiter_mutex);
+        EVIL_BW16_LOG_W("Already waiting for a response");
+        return false;
+    }
+    __atomic_store_n(&worker->waiter.prefix, expected_prefix, __ATOMIC_RELEASE);
+    worker->waiter.buffer = response_buffer;
+    worker->waiter.buffer_size = buffer_size;
+    worker->waiter.matched = false;
+    furi_semaphore_acquire(worker->waiter_done, 0);  // Clear a release left over from a timed out wait
+    furi_mutex_release(worker->waiter_mutex);
+    
+    furi_semaphore_acquire(worker->waiter_done, furi_ms_to_ticks(timeout_ms));
+    
+    furi_mutex_acquire(worker->waiter_mutex, FuriWaitForever);
+    const bool matched = worker->waiter.matched;
+    __atomic_store_n(&worker->waiter.prefix, NULL, __ATOMIC_RELEASE);
+    furi_mutex_release(worker->waiter_mutex);
+    
+    return matched;
+}
+
+uint32_t evil_bw16_uart_get_baud_rate(EvilBw16UartWorker* worker) {
+    return worker ? __atomic_load_n(&worker->baud_rate, __ATOMIC_RELAXED) : 0;
+}
+
+// Renegotiate rate and framing from the app config. Returns at once: the worker does
+// the negotiation and raises EvilBw16NotifyLink when it is done.
+void evil_bw16_uart_renegotiate(EvilBw16UartWorker* worker) {
+    if(!worker) return;
+    __atomic_store_n(&worker->link_pending, true, __ATOMIC_RELEASE);
+    furi_thread_flags_set(worker->thread_id, WorkerEvtLink);
+}
+
+// Whether a renegotiation is requested or under way
+bool evil_bw16_uart_is_negotiating(EvilBw16UartWorker* worker) {
+    return worker && __atomic_load_n(&worker->link_pending, __ATOMIC_ACQUIRE);
+}
+
+// Ask the BW16 to frame its output (or go back to plain lines). Commands stay text
+// either way. Returns whether the BW16 acknowledged; without an acknowledgement, as
+// with firmware that predates framing, the link simply stays on text.
+bool evil_bw16_uart_negotiate_protocol(EvilBw16UartWorker* worker, bool binary) {
+    if(!worker) return false;
+    if(__atomic_load_n(&worker->binary_mode, __ATOMIC_ACQUIRE) == binary) return true;
+    
+    char response[64];
+    worker->binary_requested = binary;
+    evil_bw16_uart_send_command(worker, binary ? "set proto binary" : "set proto text");
+    const bool acknowledged = evil_bw16_uart_wait_for_response(
+        worker, binary ? PROTO_ACK_BINARY : PROTO_ACK_TEXT, response, sizeof(response), PROTO_ACK_TIMEOUT_MS);
+    
+    if(!acknowledged) {
+        worker->binary_requested = false;
+        EVIL_BW16_LOG_W("BW16 did not acknowledge %s framing", binary ? "binary" : "text");
+    }
+    return acknowledged;
+}
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Route commands to tap instead of the serial port (NULL restores the port). The tap
+// runs on the sending thread and must not block.
+void evil_bw16_uart_set_tx_tap(EvilBw16UartWorker* worker, EvilBw16TxTap tap, void* context) {
+    if(!worker) return;
+    furi_mutex_acquire(worker->tx_mutex, FuriWaitForever);
+    worker->tx_tap = tap;
+    worker->tx_tap_context = context;
+    furi_mutex_release(worker->tx_mutex);
+}
+#endif
+
+bool evil_bw16_uart_is_binary(EvilBw16UartWorker* worker) {
+    return worker && __atomic_load_n(&worker->binary_mode, __ATOMIC_RELAXED);
+}
+
+#ifdef EVIL_BW16_DEVTOOLS
+// Switch local decoding without asking the BW16, for the protocol benchmark. RX must be
+// paused and the ring drained so the worker has nothing in flight.
+void evil_bw16_uart_force_protocol(EvilBw16UartWorker* worker, bool binary) {
+    if(!worker) return;
+    furi_check(worker->rx_paused);
+    worker->binary_requested = binary;
+    uart_set_binary(worker, binary);
 }
+#endif
 
-bool is_command_echo(EvilBw16UartWorker* worker, const char* line) {
-    if(!worker || !line) return false;
+// FNV-1a over the lower-cased bytes
+static uint32_t echo_hash(const char* data, size_t len) {
+    uint32_t hash = 2166136261UL;
+    for(size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)tolower((unsigned char)data[i]);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+// Retire the oldest queued command. Its bucket is only cleared if a newer,
+// colliding command has not taken it over since.
+static void echo_set_pop(EvilBw16EchoSet* set) {
+    const uint32_t hash = set->expiry_queue[set->expiry_head].hash;
+    EvilBw16EchoEntry* entry = &set->buckets[hash & (ECHO_SET_SIZE - 1)];
+    if(entry->hash == hash && entry->timestamp == set->expiry_queue[set->expiry_head].timestamp) {
+        entry->len = 0;
+    }
+    set->expiry_head = (set->expiry_head + 1) % MAX_RECENT_COMMANDS;
+    __atomic_store_n(&set->expiry_count, set->expiry_count - 1, __ATOMIC_RELAXED);
+}
+
+// Drop entries older than the echo timeout, oldest first (caller holds echo_mutex)
+static void echo_set_expire(EvilBw16EchoSet* set, uint32_t now) {
+    while(set->expiry_count > 0 &&
+          now - set->expiry_queue[set->expiry_head].timestamp >= COMMAND_ECHO_TIMEOUT_MS) {
+        echo_set_pop(set);
+    }
+}
+
+bool is_command_echo(EvilBw16UartWorker* worker, EvilBw16LineView line) {
+    if(!worker || !line.data) return false;
     
-    uint32_t current_time = furi_get_tick();
+    // Nothing sent recently (the common case while sniffing) or too long to be a command
+    if(__atomic_load_n(&worker->echo_set.expiry_count, __ATOMIC_RELAXED) == 0 || line.len >= ECHO_COMMAND_MAX) return false;
     
-    // Check if this line matches any recently sent command
-    for(int i = 0; i < MAX_RECENT_COMMANDS; i++) {
-        if(strlen(worker->recent_commands[i]) > 0) {
-            // Check if command timestamp is within echo timeout
-            if(current_time - worker->command_timestamps[i] < COMMAND_ECHO_TIMEOUT_MS) {
-                // Check if line matches the command (case insensitive)
-                if(strcasecmp(line, worker->recent_commands[i]) == 0) {
-                    FURI_LOG_D("EvilBw16", "Filtered echo: %s", line);
-                    return true;
-                }
-            } else {
-                // Clear old command
-                worker->recent_commands[i][0] = '\0';
-                worker->command_timestamps[i] = 0;
-            }
-        }
+    const uint32_t hash = echo_hash(line.data, line.len);
+    bool is_echo = false;
+    
+    furi_mutex_acquire(worker->echo_mutex, FuriWaitForever);
+    EvilBw16EchoSet* set = &worker->echo_set;
+    echo_set_expire(set, furi_get_tick());
+    
+    const EvilBw16EchoEntry* entry = &set->buckets[hash & (ECHO_SET_SIZE - 1)];
+    if(entry->len == line.len && entry->hash == hash &&
+       strncasecmp(line.data, entry->command, line.len) == 0) {
+        is_echo = true;
     }
+    furi_mutex_release(worker->echo_mutex);
     
-    return false;
+    if(is_echo) {
+        EVIL_BW16_LOG_D("Filtered echo: %.*s", (int)line.len, line.data);
+    }
+    return is_echo;
 }
 
 void store_sent_command(EvilBw16UartWorker* worker, const char* command) {
     if(!worker || !command) return;
     
-    // Store command in circular buffer
-    strncpy(worker->recent_commands[worker->recent_command_index], command, 63);
-    worker->recent_commands[worker->recent_command_index][63] = '\0';
-    worker->command_timestamps[worker->recent_command_index] = furi_get_tick();
+    const size_t len = strlen(command);
+    if(len == 0 || len >= ECHO_COMMAND_MAX) return;  // Can never match an echoed line
     
-    worker->recent_command_index = (worker->recent_command_index + 1) % MAX_RECENT_COMMANDS;
-} 
\ No newline at end of file
+    const uint32_t hash = echo_hash(command, len);
+    const uint8_t bucket = hash & (ECHO_SET_SIZE - 1);
+    
+    furi_mutex_acquire(worker->echo_mutex, FuriWaitForever);
+    EvilBw16EchoSet* set = &worker->echo_set;
+    const uint32_t now = furi_get_tick();
+    echo_set_expire(set, now);
+    
+    // Make room in the expiry queue by retiring the oldest command
+    if(set->expiry_count == MAX_RECENT_COMMANDS) {
+        echo_set_pop(set);
+    }
+    
+    // A colliding older command simply loses its bucket
+    EvilBw16EchoEntry* entry = &set->buckets[bucket];
+    memcpy(entry->command, command, len);
+    entry->len = len;
+    entry->hash = hash;
+    entry->timestamp = now;
+    
+    const uint8_t tail = (set->expiry_head + set->expiry_count) % MAX_RECENT_COMMANDS;
+    set->expiry_queue[tail].hash = hash;
+    set->expiry_queue[tail].timestamp = now;
+    __atomic_store_n(&set->expiry_count, set->expiry_count + 1, __ATOMIC_RELAXED);
+    furi_mutex_release(worker->echo_mutex);
+}
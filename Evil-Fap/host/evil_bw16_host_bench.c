@@ -0,0 +1,103 @@
+#include "host_app.h"
+#include <storage/storage.h>
+#include <getopt.h>
+
+// Desktop front end for the replay benchmark: runs the benches from evil_bw16_replay.c
+// against the real worker and prints the same report the Replay scene shows.
+//
+// Text and capture replays read the files the app uses, under the host directory that
+// stands in for /ext:
+//   <ext>/apps_data/evil_bw16_replay.txt
+//   <ext>/apps_data/evil_bw16_capture.bin
+// The simulator benches run the simulated BW16 in this process; the serial port stays
+// unconnected, so the link is whatever the simulator answers on the worker's hooks.
+
+#define HOST_BENCH_TIMEOUT_MS (5 * 60 * 1000)
+
+static void host_bench_usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [-v] [-e ext_dir] [-n networks] [-r frames_per_s] [-s scan_ms] <bench>\n"
+            "benches:\n"
+            "  text <baud>      replay the text log, paced at baud (0 = as fast as possible)\n"
+            "  capture [timed]  replay the RX capture, optionally with its recorded timing\n"
+            "  proto            text vs binary protocol on a synthetic scan\n"
+            "  parser           scan line parser corpus check and timing\n"
+            "  sim-scan         scan latency against the simulated BW16\n"
+            "  sim-sniff        sniffer throughput against the simulated BW16\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    uint8_t sim_networks = 20;
+    uint32_t sim_frame_rate = 200;
+    uint32_t sim_scan_ms = 500;
+    int opt;
+    while((opt = getopt(argc, argv, "ve:n:r:s:")) != -1) {
+        switch(opt) {
+            case 'v':
+                evil_bw16_log_level = EVIL_BW16_LOG_LEVEL_DEBUG;
+                break;
+            case 'e':
+                storage_host_set_root(optarg);
+                break;
+            case 'n':
+                sim_networks = (uint8_t)MIN(atoi(optarg), EVIL_BW16_MAX_NETWORKS);
+                break;
+            case 'r':
+                sim_frame_rate = (uint32_t)atol(optarg);
+                break;
+            case 's':
+                sim_scan_ms = (uint32_t)atol(optarg);
+                break;
+            default:
+                host_bench_usage(argv[0]);
+                return 2;
+        }
+    }
+    if(optind >= argc) {
+        host_bench_usage(argv[0]);
+        return 2;
+    }
+    const char* bench = argv[optind];
+    const char* arg = optind + 1 < argc ? argv[optind + 1] : NULL;
+
+    EvilBw16App* app = evil_bw16_host_app_alloc();
+    evil_bw16_host_app_start(app);
+    app->replay = evil_bw16_replay_alloc(app);
+
+    bool started = false;
+    if(strcmp(bench, "text") == 0 && arg) {
+        started = evil_bw16_replay_start(app->replay, (uint32_t)atol(arg));
+    } else if(strcmp(bench, "capture") == 0) {
+        started = evil_bw16_replay_start_capture(app->replay, arg && strcmp(arg, "timed") == 0);
+    } else if(strcmp(bench, "proto") == 0) {
+        started = evil_bw16_replay_start_proto_bench(app->replay);
+    } else if(strcmp(bench, "parser") == 0) {
+        started = evil_bw16_replay_start_parser_bench(app->replay);
+    } else if(strcmp(bench, "sim-scan") == 0 || strcmp(bench, "sim-sniff") == 0) {
+        app->simulator = evil_bw16_sim_alloc(app);
+        evil_bw16_sim_configure(app->simulator, sim_networks, sim_frame_rate, sim_scan_ms);
+        started = evil_bw16_replay_start_sim_bench(app->replay, strcmp(bench, "sim-sniff") == 0);
+    } else {
+        host_bench_usage(argv[0]);
+        evil_bw16_host_app_free(app);
+        return 2;
+    }
+
+    int result = 1;
+    if(!started) {
+        fprintf(stderr, "%s: bench did not start\n", bench);
+    } else if(!evil_bw16_host_app_wait_event(app, EvilBw16EventReplayDone, HOST_BENCH_TIMEOUT_MS)) {
+        fprintf(stderr, "%s: bench did not finish\n", bench);
+    } else {
+        evil_bw16_replay_stop(app->replay);
+        FuriString* report = furi_string_alloc();
+        evil_bw16_replay_format_report(app->replay, report);
+        fputs(furi_string_get_cstr(report), stdout);
+        furi_string_free(report);
+        result = 0;
+    }
+
+    evil_bw16_host_app_free(app);
+    return result;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#define RECORD_DIALOGS "dialogs"
+
+typedef struct DialogsApp DialogsApp;
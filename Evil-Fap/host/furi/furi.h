@@ -0,0 +1,143 @@
+#pragma once
+
+// Host stand-in for the parts of the furi API the BW16 link code uses, on top of
+// pthreads (see furi_host.c). Semantics follow the firmware where the code relies on
+// them: one tick per millisecond, thread flags cleared on wait, FuriWaitForever.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <strings.h>
+
+// The firmware heap hands out zeroed blocks and the app relies on it
+#define malloc(size) calloc(1, size)
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define CLAMP(x, upper, lower) (MIN(upper, MAX(x, lower)))
+
+void furi_host_crash(const char* expr, const char* file, int line) __attribute__((noreturn));
+#define furi_check(x) \
+    do { \
+        if(!(x)) furi_host_crash(#x, __FILE__, __LINE__); \
+    } while(0)
+#define furi_assert(x) furi_check(x)
+
+// Critical sections keep the serial reader thread, the host's RX interrupt, out
+void furi_host_critical_enter(void);
+void furi_host_critical_exit(void);
+#define FURI_CRITICAL_ENTER() furi_host_critical_enter()
+#define FURI_CRITICAL_EXIT() furi_host_critical_exit()
+
+// Logging
+typedef enum {
+    FuriLogLevelError = 1,
+    FuriLogLevelWarn,
+    FuriLogLevelInfo,
+    FuriLogLevelDebug,
+} FuriLogLevel;
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+#define FURI_LOG_E(tag, ...) furi_log_print_format(FuriLogLevelError, tag, __VA_ARGS__)
+#define FURI_LOG_W(tag, ...) furi_log_print_format(FuriLogLevelWarn, tag, __VA_ARGS__)
+#define FURI_LOG_I(tag, ...) furi_log_print_format(FuriLogLevelInfo, tag, __VA_ARGS__)
+#define FURI_LOG_D(tag, ...) furi_log_print_format(FuriLogLevelDebug, tag, __VA_ARGS__)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriFlagWaitAny = 0x00000000U,
+    FuriFlagWaitAll = 0x00000001U,
+    FuriFlagNoClear = 0x00000002U,
+    FuriFlagError = 0x80000000U,
+    FuriFlagErrorTimeout = 0xFFFFFFFEU,
+} FuriFlag;
+
+// Kernel
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t ms);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t ms);
+void furi_delay_tick(uint32_t ticks);
+size_t memmgr_get_free_heap(void);
+
+// Threads and thread flags
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+FuriThreadId furi_thread_get_current_id(void);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+// Mutex
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+typedef struct FuriMutex FuriMutex;
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* instance);
+FuriStatus furi_mutex_acquire(FuriMutex* instance, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* instance);
+
+// Semaphore
+typedef struct FuriSemaphore FuriSemaphore;
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count);
+void furi_semaphore_free(FuriSemaphore* instance);
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout);
+FuriStatus furi_semaphore_release(FuriSemaphore* instance);
+
+// Message queue
+typedef struct FuriMessageQueue FuriMessageQueue;
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* instance);
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout);
+FuriStatus furi_message_queue_reset(FuriMessageQueue* instance);
+
+// Timer; callbacks run on a thread of the timer's own
+typedef enum {
+    FuriTimerTypeOnce = 0,
+    FuriTimerTypePeriodic = 1,
+} FuriTimerType;
+typedef void (*FuriTimerCallback)(void* context);
+typedef struct FuriTimer FuriTimer;
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context);
+void furi_timer_free(FuriTimer* instance);
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer* instance);
+
+// Stream buffer; only referenced by the app's legacy RX stream, never filled on the host
+typedef struct FuriStreamBuffer FuriStreamBuffer;
+FuriStatus furi_stream_buffer_reset(FuriStreamBuffer* stream_buffer);
+
+// String
+typedef struct FuriString FuriString;
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+int furi_string_printf(FuriString* string, const char format[], ...) __attribute__((format(printf, 2, 3)));
+int furi_string_cat_printf(FuriString* string, const char format[], ...) __attribute__((format(printf, 2, 3)));
+
+// Records; the host has no services, handles are placeholders
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
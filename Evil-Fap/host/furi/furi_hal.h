@@ -0,0 +1,5 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_serial.h>
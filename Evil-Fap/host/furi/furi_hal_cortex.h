@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// The host counts cycles of a virtual 64 MHz core, like the Flipper's, so cycle counts
+// convert to microseconds the same way on both.
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
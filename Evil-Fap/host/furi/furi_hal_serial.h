@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Host stand-in for the serial HAL. Each port can be connected to a file descriptor,
+// typically one side of a pty; a reader thread plays the RX interrupt. Ports that are
+// not connected discard TX and never receive. RX is delivered at the configured baud rate;
+// TX goes out as fast as the other end takes it.
+
+typedef enum {
+    FuriHalSerialIdUsart,
+    FuriHalSerialIdLpuart,
+    FuriHalSerialIdMax,
+} FuriHalSerialId;
+
+typedef enum {
+    FuriHalSerialRxEventData = (1 << 0),
+    FuriHalSerialRxEventIdle = (1 << 1),
+    FuriHalSerialRxEventFrameError = (1 << 2),
+    FuriHalSerialRxEventNoiseError = (1 << 3),
+    FuriHalSerialRxEventOverrunError = (1 << 4),
+} FuriHalSerialRxEvent;
+
+typedef struct FuriHalSerialHandle FuriHalSerialHandle;
+typedef void (*FuriHalSerialAsyncRxCallback)(FuriHalSerialHandle* handle, FuriHalSerialRxEvent event, void* context);
+
+FuriHalSerialHandle* furi_hal_serial_control_acquire(FuriHalSerialId serial_id);
+void furi_hal_serial_control_release(FuriHalSerialHandle* handle);
+void furi_hal_serial_init(FuriHalSerialHandle* handle, uint32_t baud);
+void furi_hal_serial_deinit(FuriHalSerialHandle* handle);
+void furi_hal_serial_set_br(FuriHalSerialHandle* handle, uint32_t baud);
+void furi_hal_serial_tx(FuriHalSerialHandle* handle, const uint8_t* buffer, size_t buffer_size);
+void furi_hal_serial_tx_wait_complete(FuriHalSerialHandle* handle);
+void furi_hal_serial_async_rx_start(FuriHalSerialHandle* handle, FuriHalSerialAsyncRxCallback callback, void* context, bool report_errors);
+void furi_hal_serial_async_rx_stop(FuriHalSerialHandle* handle);
+bool furi_hal_serial_async_rx_available(FuriHalSerialHandle* handle);
+uint8_t furi_hal_serial_async_rx(FuriHalSerialHandle* handle);
+
+// Host only: route a port to fd (-1 disconnects) and read back its current rate
+void furi_hal_serial_host_connect(FuriHalSerialId serial_id, int fd);
+uint32_t furi_hal_serial_host_get_baud(FuriHalSerialId serial_id);
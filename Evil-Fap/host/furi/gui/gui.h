@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi.h>
+
+#define RECORD_GUI "gui"
+
+typedef struct Gui Gui;
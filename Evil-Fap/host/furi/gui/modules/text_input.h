@@ -0,0 +1,5 @@
+#pragma once
+
+#include <gui/view.h>
+
+typedef struct TextInput TextInput;
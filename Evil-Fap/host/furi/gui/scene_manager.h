@@ -0,0 +1,16 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum {
+    SceneManagerEventTypeCustom,
+    SceneManagerEventTypeBack,
+    SceneManagerEventTypeTick,
+} SceneManagerEventType;
+
+typedef struct {
+    SceneManagerEventType type;
+    uint32_t event;
+} SceneManagerEvent;
+
+typedef struct SceneManager SceneManager;
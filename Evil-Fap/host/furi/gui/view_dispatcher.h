@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gui/gui.h>
+#include <gui/view.h>
+
+// Host stand-in: custom events are queued instead of being run on a GUI thread, and the
+// harness takes them with view_dispatcher_host_next_event().
+
+typedef struct ViewDispatcher ViewDispatcher;
+
+ViewDispatcher* view_dispatcher_alloc(void);
+void view_dispatcher_free(ViewDispatcher* view_dispatcher);
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event);
+
+// Host only: next queued custom event, false on timeout
+bool view_dispatcher_host_next_event(ViewDispatcher* view_dispatcher, uint32_t* event, uint32_t timeout_ms);
@@ -0,0 +1,6 @@
+#pragma once
+
+#define RECORD_NOTIFICATION "notification"
+
+typedef struct NotificationApp NotificationApp;
+typedef struct NotificationSequence NotificationSequence;
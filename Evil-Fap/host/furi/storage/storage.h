@@ -0,0 +1,40 @@
+#pragma once
+
+#include <furi.h>
+
+// Host stand-in for storage: /ext/ paths map to a directory on the host, see
+// storage_host_set_root().
+
+#define RECORD_STORAGE "storage"
+#define EXT_PATH(path) "/ext/" path
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read);
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+bool storage_file_truncate(File* file);
+bool storage_file_sync(File* file);
+bool storage_simply_mkdir(Storage* storage, const char* path);
+
+// Host only: directory that stands in for /ext (default: $EVIL_BW16_HOST_EXT, else ./ext)
+void storage_host_set_root(const char* path);
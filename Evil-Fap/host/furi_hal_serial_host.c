@@ -0,0 +1,184 @@
+#include <furi.h>
+#include <furi_hal_serial.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// Host stand-in for the serial HAL.
+//
+// A port connected to a file descriptor gets a reader thread that plays the RX
+// interrupt: every read() becomes one FuriHalSerialRxEventData burst for the callback
+// to drain with furi_hal_serial_async_rx(), and a quiet poll interval after data
+// raises FuriHalSerialRxEventIdle, like the idle line detection on the Flipper. The
+// callback runs inside a critical section, so FURI_CRITICAL_ENTER holds it off.
+//
+// Bytes are handed over no faster than the configured baud rate would deliver them (10
+// bits per byte at 8N1), however quickly the other end writes.
+
+#define SERIAL_HOST_BURST (64)         // Bytes handed to the callback per "interrupt"
+#define SERIAL_HOST_IDLE_MS (2)        // Quiet time that counts as an idle line
+#define SERIAL_HOST_CLOSED_WAIT_US (10000)
+#define SERIAL_HOST_MAX_LAG_NS (2000000ULL)  // Wire time caught up after a late wakeup
+
+struct FuriHalSerialHandle {
+    FuriHalSerialId id;
+    int fd;
+    bool acquired;
+    uint32_t baud;  // Read by test stand-ins on other threads
+    pthread_t rx_thread;
+    bool rx_running;  // Accessed atomically, the reader thread polls it
+    FuriHalSerialAsyncRxCallback callback;
+    void* context;
+    uint8_t burst[SERIAL_HOST_BURST];
+    size_t burst_len;
+    size_t burst_pos;
+};
+
+static FuriHalSerialHandle serial_host_handles[FuriHalSerialIdMax] = {
+    {.id = FuriHalSerialIdUsart, .fd = -1},
+    {.id = FuriHalSerialIdLpuart, .fd = -1},
+};
+
+static uint64_t serial_host_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// Hold the burst back until the wire would have finished delivering it. wire_ns is the
+// absolute time the previous burst finished; it only restarts from now after an idle
+// line, so a short delay while this thread was descheduled is caught up, not dropped.
+// A longer one is not: the worker would have drained the ring meanwhile, and delivering
+// all of it back to back would overrun the ring on a host with one CPU.
+static void serial_host_pace(FuriHalSerialHandle* handle, uint64_t* wire_ns, size_t len) {
+    const uint64_t now = serial_host_now_ns();
+    if(*wire_ns == 0) *wire_ns = now;
+    *wire_ns = MAX(*wire_ns, now - SERIAL_HOST_MAX_LAG_NS);
+    *wire_ns += (uint64_t)len * 10 * 1000000000ULL / MAX(__atomic_load_n(&handle->baud, __ATOMIC_RELAXED), 1U);
+    if(*wire_ns > now) {
+        const uint64_t wait = *wire_ns - now;
+        const struct timespec delay = {.tv_sec = wait / 1000000000ULL, .tv_nsec = wait % 1000000000ULL};
+        nanosleep(&delay, NULL);
+    }
+}
+
+static void* serial_host_rx_body(void* context) {
+    FuriHalSerialHandle* handle = context;
+    bool idle_pending = false;
+    uint64_t wire_ns = 0;
+
+    while(__atomic_load_n(&handle->rx_running, __ATOMIC_ACQUIRE)) {
+        struct pollfd pfd = {.fd = handle->fd, .events = POLLIN};
+        const int ready = poll(&pfd, 1, SERIAL_HOST_IDLE_MS);
+        if(ready == 0) {
+            wire_ns = 0;
+            if(idle_pending) {
+                furi_host_critical_enter();
+                handle->callback(handle, FuriHalSerialRxEventIdle, handle->context);
+                furi_host_critical_exit();
+                idle_pending = false;
+            }
+            continue;
+        }
+
+        const ssize_t len = ready > 0 ? read(handle->fd, handle->burst, sizeof(handle->burst)) : -1;
+        if(len <= 0) {
+            // The other end is gone (EIO on a pty) or not there yet; keep the line quiet
+            if(len < 0 && errno == EINTR) continue;
+            usleep(SERIAL_HOST_CLOSED_WAIT_US);
+            continue;
+        }
+
+        serial_host_pace(handle, &wire_ns, (size_t)len);
+        handle->burst_len = (size_t)len;
+        handle->burst_pos = 0;
+        furi_host_critical_enter();
+        handle->callback(handle, FuriHalSerialRxEventData, handle->context);
+        furi_host_critical_exit();
+        idle_pending = true;
+    }
+    return NULL;
+}
+
+void furi_hal_serial_host_connect(FuriHalSerialId serial_id, int fd) {
+    furi_check(serial_id < FuriHalSerialIdMax);
+    furi_check(!serial_host_handles[serial_id].rx_running);
+    serial_host_handles[serial_id].fd = fd;
+}
+
+uint32_t furi_hal_serial_host_get_baud(FuriHalSerialId serial_id) {
+    furi_check(serial_id < FuriHalSerialIdMax);
+    return __atomic_load_n(&serial_host_handles[serial_id].baud, __ATOMIC_RELAXED);
+}
+
+FuriHalSerialHandle* furi_hal_serial_control_acquire(FuriHalSerialId serial_id) {
+    if(serial_id >= FuriHalSerialIdMax) return NULL;
+    FuriHalSerialHandle* handle = &serial_host_handles[serial_id];
+    if(handle->acquired) return NULL;
+    handle->acquired = true;
+    return handle;
+}
+
+void furi_hal_serial_control_release(FuriHalSerialHandle* handle) {
+    furi_check(handle->acquired && !handle->rx_running);
+    handle->acquired = false;
+}
+
+void furi_hal_serial_init(FuriHalSerialHandle* handle, uint32_t baud) {
+    __atomic_store_n(&handle->baud, baud, __ATOMIC_RELAXED);
+}
+
+void furi_hal_serial_deinit(FuriHalSerialHandle* handle) {
+    furi_check(!handle->rx_running);
+}
+
+void furi_hal_serial_set_br(FuriHalSerialHandle* handle, uint32_t baud) {
+    __atomic_store_n(&handle->baud, baud, __ATOMIC_RELAXED);
+}
+
+void furi_hal_serial_tx(FuriHalSerialHandle* handle, const uint8_t* buffer, size_t buffer_size) {
+    if(handle->fd < 0) return;
+    while(buffer_size > 0) {
+        const ssize_t written = write(handle->fd, buffer, buffer_size);
+        if(written < 0) {
+            if(errno == EINTR) continue;
+            return;  // Nobody on the other end, like an unconnected TX pin
+        }
+        buffer += written;
+        buffer_size -= (size_t)written;
+    }
+}
+
+void furi_hal_serial_tx_wait_complete(FuriHalSerialHandle* handle) {
+    UNUSED(handle);
+}
+
+void furi_hal_serial_async_rx_start(FuriHalSerialHandle* handle, FuriHalSerialAsyncRxCallback callback, void* context, bool report_errors) {
+    UNUSED(report_errors);
+    furi_check(handle->acquired && !handle->rx_running);
+    handle->callback = callback;
+    handle->context = context;
+    handle->burst_len = 0;
+    handle->burst_pos = 0;
+    if(handle->fd < 0) return;
+
+    __atomic_store_n(&handle->rx_running, true, __ATOMIC_RELEASE);
+    furi_check(pthread_create(&handle->rx_thread, NULL, serial_host_rx_body, handle) == 0);
+}
+
+void furi_hal_serial_async_rx_stop(FuriHalSerialHandle* handle) {
+    if(!handle->rx_running) return;
+    __atomic_store_n(&handle->rx_running, false, __ATOMIC_RELEASE);
+    pthread_join(handle->rx_thread, NULL);
+}
+
+bool furi_hal_serial_async_rx_available(FuriHalSerialHandle* handle) {
+    return handle->burst_pos < handle->burst_len;
+}
+
+uint8_t furi_hal_serial_async_rx(FuriHalSerialHandle* handle) {
+    furi_check(handle->burst_pos < handle->burst_len);
+    return handle->burst[handle->burst_pos++];
+}
@@ -0,0 +1,575 @@
+#define _GNU_SOURCE  // pthread_mutex_clocklock
+#include <furi.h>
+#include <furi_hal_cortex.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+
+// Host stand-in for the furi kernel objects, on pthreads.
+//
+// Normal mutexes are error checking, so a thread taking a mutex it already holds fails
+// loudly here instead of deadlocking like it would on the Flipper. Timeouts count on
+// the monotonic clock. Objects are plain heap structs; nothing is pooled.
+
+#define HOST_FREE_HEAP (128 * 1024)  // What the Flipper typically has left with the app running
+#define HOST_CPU_MHZ (64)
+
+void furi_host_crash(const char* expr, const char* file, int line) {
+    fprintf(stderr, "furi_check failed: %s (%s:%d)\n", expr, file, line);
+    abort();
+}
+
+// Interrupts are masked for the whole section on the Flipper; here the serial reader
+// thread takes the same lock around its callback
+static pthread_mutex_t host_critical_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void furi_host_critical_enter(void) {
+    pthread_mutex_lock(&host_critical_lock);
+}
+
+void furi_host_critical_exit(void) {
+    pthread_mutex_unlock(&host_critical_lock);
+}
+
+// Kernel
+
+static uint64_t host_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+uint32_t furi_get_tick(void) {
+    return (uint32_t)(host_now_ns() / 1000000ULL);
+}
+
+uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+void furi_delay_ms(uint32_t ms) {
+    usleep((useconds_t)ms * 1000);
+}
+
+void furi_delay_tick(uint32_t ticks) {
+    furi_delay_ms(ticks);
+}
+
+size_t memmgr_get_free_heap(void) {
+    return HOST_FREE_HEAP;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return HOST_CPU_MHZ;
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer timer = {
+        .start = (uint32_t)(host_now_ns() * HOST_CPU_MHZ / 1000),
+        .value = timeout_us * HOST_CPU_MHZ,
+    };
+    return timer;
+}
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    static const char level_letters[] = "?EWID";
+    fprintf(stderr, "%lu [%c][%s] ", (unsigned long)furi_get_tick(), level_letters[level <= FuriLogLevelDebug ? level : 0], tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// Waits
+
+static void host_cond_init(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static struct timespec host_deadline(uint32_t timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+// Wait on cond until woken or the deadline passes; false on timeout. FuriWaitForever
+// never times out, a zero timeout does not wait at all.
+static bool host_cond_wait(pthread_cond_t* cond, pthread_mutex_t* lock, uint32_t timeout, const struct timespec* deadline) {
+    if(timeout == FuriWaitForever) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    if(timeout == 0) return false;
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// Threads and thread flags
+
+struct FuriThread {
+    pthread_t pthread;
+    char name[32];
+    FuriThreadCallback callback;
+    void* context;
+    bool started;
+    pthread_mutex_t flags_lock;
+    pthread_cond_t flags_cond;
+    uint32_t flags;
+};
+
+static __thread FuriThread* host_current_thread;
+
+static FuriThread* host_thread_new(const char* name) {
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    memset(thread, 0, sizeof(FuriThread));
+    snprintf(thread->name, sizeof(thread->name), "%s", name);
+    pthread_mutex_init(&thread->flags_lock, NULL);
+    host_cond_init(&thread->flags_cond);
+    return thread;
+}
+
+static void* host_thread_body(void* context) {
+    FuriThread* thread = context;
+    host_current_thread = thread;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context) {
+    UNUSED(stack_size);
+    FuriThread* thread = host_thread_new(name);
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    furi_check(thread);
+    pthread_cond_destroy(&thread->flags_cond);
+    pthread_mutex_destroy(&thread->flags_lock);
+    free(thread);
+}
+
+void furi_thread_start(FuriThread* thread) {
+    furi_check(!thread->started);
+    thread->started = true;
+    furi_check(pthread_create(&thread->pthread, NULL, host_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(!thread->started) return true;
+    pthread_join(thread->pthread, NULL);
+    thread->started = false;
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+// Threads the harness created itself get flags on first use; their record is not freed
+FuriThreadId furi_thread_get_current_id(void) {
+    if(!host_current_thread) host_current_thread = host_thread_new("host");
+    return host_current_thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    furi_check(thread_id);
+    pthread_mutex_lock(&thread_id->flags_lock);
+    thread_id->flags |= flags;
+    const uint32_t result = thread_id->flags;
+    pthread_cond_broadcast(&thread_id->flags_cond);
+    pthread_mutex_unlock(&thread_id->flags_lock);
+    return result;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    FuriThread* thread = furi_thread_get_current_id();
+    const struct timespec deadline = host_deadline(timeout == FuriWaitForever ? 0 : timeout);
+    uint32_t result = FuriFlagErrorTimeout;
+
+    pthread_mutex_lock(&thread->flags_lock);
+    for(;;) {
+        const uint32_t set = thread->flags & flags;
+        const bool done = (options & FuriFlagWaitAll) ? set == flags : set != 0;
+        if(done) {
+            result = set;
+            if(!(options & FuriFlagNoClear)) thread->flags &= ~set;
+            break;
+        }
+        if(!host_cond_wait(&thread->flags_cond, &thread->flags_lock, timeout, &deadline)) break;
+    }
+    pthread_mutex_unlock(&thread->flags_lock);
+    return result;
+}
+
+// Mutex
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* instance = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, type == FuriMutexTypeRecursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(&instance->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return instance;
+}
+
+void furi_mutex_free(FuriMutex* instance) {
+    furi_check(instance);
+    pthread_mutex_destroy(&instance->mutex);
+    free(instance);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* instance, uint32_t timeout) {
+    int result;
+    if(timeout == FuriWaitForever) {
+        result = pthread_mutex_lock(&instance->mutex);
+    } else if(timeout == 0) {
+        result = pthread_mutex_trylock(&instance->mutex);
+    } else {
+        const struct timespec deadline = host_deadline(timeout);
+        result = pthread_mutex_clocklock(&instance->mutex, CLOCK_MONOTONIC, &deadline);
+    }
+    // Taking a normal mutex twice would hang the Flipper
+    furi_check(result != EDEADLK);
+    if(result == 0) return FuriStatusOk;
+    return timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* instance) {
+    furi_check(pthread_mutex_unlock(&instance->mutex) == 0);
+    return FuriStatusOk;
+}
+
+// Semaphore
+
+struct FuriSemaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t count;
+    uint32_t max_count;
+};
+
+FuriSemaphore* furi_semaphore_alloc(uint32_t max_count, uint32_t initial_count) {
+    FuriSemaphore* instance = malloc(sizeof(FuriSemaphore));
+    pthread_mutex_init(&instance->lock, NULL);
+    host_cond_init(&instance->cond);
+    instance->count = initial_count;
+    instance->max_count = max_count;
+    return instance;
+}
+
+void furi_semaphore_free(FuriSemaphore* instance) {
+    furi_check(instance);
+    pthread_cond_destroy(&instance->cond);
+    pthread_mutex_destroy(&instance->lock);
+    free(instance);
+}
+
+FuriStatus furi_semaphore_acquire(FuriSemaphore* instance, uint32_t timeout) {
+    const struct timespec deadline = host_deadline(timeout == FuriWaitForever ? 0 : timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&instance->lock);
+    while(instance->count == 0) {
+        if(!host_cond_wait(&instance->cond, &instance->lock, timeout, &deadline)) {
+            status = timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) instance->count--;
+    pthread_mutex_unlock(&instance->lock);
+    return status;
+}
+
+FuriStatus furi_semaphore_release(FuriSemaphore* instance) {
+    FuriStatus status = FuriStatusErrorResource;
+    pthread_mutex_lock(&instance->lock);
+    if(instance->count < instance->max_count) {
+        instance->count++;
+        pthread_cond_signal(&instance->cond);
+        status = FuriStatusOk;
+    }
+    pthread_mutex_unlock(&instance->lock);
+    return status;
+}
+
+// Message queue
+
+struct FuriMessageQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t* messages;
+    uint32_t msg_size;
+    uint32_t capacity;
+    uint32_t head;  // Next message to get
+    uint32_t count;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* instance = malloc(sizeof(FuriMessageQueue));
+    pthread_mutex_init(&instance->lock, NULL);
+    host_cond_init(&instance->not_empty);
+    host_cond_init(&instance->not_full);
+    instance->messages = malloc((size_t)msg_count * msg_size);
+    instance->msg_size = msg_size;
+    instance->capacity = msg_count;
+    instance->head = 0;
+    instance->count = 0;
+    return instance;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    furi_check(instance);
+    pthread_cond_destroy(&instance->not_full);
+    pthread_cond_destroy(&instance->not_empty);
+    pthread_mutex_destroy(&instance->lock);
+    free(instance->messages);
+    free(instance);
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout) {
+    const struct timespec deadline = host_deadline(timeout == FuriWaitForever ? 0 : timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&instance->lock);
+    while(instance->count == instance->capacity) {
+        if(!host_cond_wait(&instance->not_full, &instance->lock, timeout, &deadline)) {
+            status = timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        const uint32_t slot = (instance->head + instance->count) % instance->capacity;
+        memcpy(&instance->messages[(size_t)slot * instance->msg_size], msg_ptr, instance->msg_size);
+        instance->count++;
+        pthread_cond_signal(&instance->not_empty);
+    }
+    pthread_mutex_unlock(&instance->lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout) {
+    const struct timespec deadline = host_deadline(timeout == FuriWaitForever ? 0 : timeout);
+    FuriStatus status = FuriStatusOk;
+
+    pthread_mutex_lock(&instance->lock);
+    while(instance->count == 0) {
+        if(!host_cond_wait(&instance->not_empty, &instance->lock, timeout, &deadline)) {
+            status = timeout ? FuriStatusErrorTimeout : FuriStatusErrorResource;
+            break;
+        }
+    }
+    if(status == FuriStatusOk) {
+        memcpy(msg_ptr, &instance->messages[(size_t)instance->head * instance->msg_size], instance->msg_size);
+        instance->head = (instance->head + 1) % instance->capacity;
+        instance->count--;
+        pthread_cond_signal(&instance->not_full);
+    }
+    pthread_mutex_unlock(&instance->lock);
+    return status;
+}
+
+FuriStatus furi_message_queue_reset(FuriMessageQueue* instance) {
+    pthread_mutex_lock(&instance->lock);
+    instance->head = 0;
+    instance->count = 0;
+    pthread_cond_broadcast(&instance->not_full);
+    pthread_mutex_unlock(&instance->lock);
+    return FuriStatusOk;
+}
+
+// Timer
+
+struct FuriTimer {
+    pthread_t pthread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    FuriTimerCallback callback;
+    void* context;
+    FuriTimerType type;
+    uint32_t period;
+    uint64_t due_ns;
+    bool armed;
+    bool exit;
+};
+
+static void* host_timer_body(void* context) {
+    FuriTimer* timer = context;
+
+    pthread_mutex_lock(&timer->lock);
+    while(!timer->exit) {
+        if(!timer->armed) {
+            pthread_cond_wait(&timer->cond, &timer->lock);
+            continue;
+        }
+        const uint64_t now = host_now_ns();
+        if(now < timer->due_ns) {
+            const uint64_t wait_ms = (timer->due_ns - now + 999999ULL) / 1000000ULL;
+            const struct timespec deadline = host_deadline((uint32_t)wait_ms);
+            pthread_cond_timedwait(&timer->cond, &timer->lock, &deadline);
+            continue;
+        }
+        if(timer->type == FuriTimerTypePeriodic) {
+            timer->due_ns += (uint64_t)timer->period * 1000000ULL;
+        } else {
+            timer->armed = false;
+        }
+        // Like the timer service, the callback runs without anything held
+        pthread_mutex_unlock(&timer->lock);
+        timer->callback(timer->context);
+        pthread_mutex_lock(&timer->lock);
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return NULL;
+}
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    FuriTimer* instance = malloc(sizeof(FuriTimer));
+    memset(instance, 0, sizeof(FuriTimer));
+    pthread_mutex_init(&instance->lock, NULL);
+    host_cond_init(&instance->cond);
+    instance->callback = func;
+    instance->context = context;
+    instance->type = type;
+    furi_check(pthread_create(&instance->pthread, NULL, host_timer_body, instance) == 0);
+    return instance;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    furi_check(instance);
+    pthread_mutex_lock(&instance->lock);
+    instance->exit = true;
+    pthread_cond_signal(&instance->cond);
+    pthread_mutex_unlock(&instance->lock);
+    pthread_join(instance->pthread, NULL);
+    pthread_cond_destroy(&instance->cond);
+    pthread_mutex_destroy(&instance->lock);
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    pthread_mutex_lock(&instance->lock);
+    instance->period = ticks;
+    instance->due_ns = host_now_ns() + (uint64_t)ticks * 1000000ULL;
+    instance->armed = true;
+    pthread_cond_signal(&instance->cond);
+    pthread_mutex_unlock(&instance->lock);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    pthread_mutex_lock(&instance->lock);
+    instance->armed = false;
+    pthread_cond_signal(&instance->cond);
+    pthread_mutex_unlock(&instance->lock);
+    return FuriStatusOk;
+}
+
+// Stream buffer
+
+FuriStatus furi_stream_buffer_reset(FuriStreamBuffer* stream_buffer) {
+    UNUSED(stream_buffer);
+    return FuriStatusOk;
+}
+
+// String
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->capacity = 64;
+    string->data = malloc(string->capacity);
+    string->data[0] = '\0';
+    string->size = 0;
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    if(!string) return;
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+static int host_string_cat_vprintf(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    const int len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if(len < 0) return len;
+
+    if(string->size + len + 1 > string->capacity) {
+        while(string->size + len + 1 > string->capacity) string->capacity *= 2;
+        string->data = realloc(string->data, string->capacity);
+    }
+    vsnprintf(string->data + string->size, len + 1, format, args);
+    string->size += len;
+    return len;
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    furi_string_reset(string);
+    va_list args;
+    va_start(args, format);
+    const int result = host_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return result;
+}
+
+int furi_string_cat_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    const int result = host_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return result;
+}
+
+// Records
+
+void* furi_record_open(const char* name) {
+    return (void*)name;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
@@ -0,0 +1,31 @@
+#include <gui/view_dispatcher.h>
+
+// Host stand-in for the view dispatcher: custom events go to a queue the harness reads,
+// there is no GUI thread to run them.
+
+#define VIEW_DISPATCHER_HOST_QUEUE (64)
+
+struct ViewDispatcher {
+    FuriMessageQueue* events;
+};
+
+ViewDispatcher* view_dispatcher_alloc(void) {
+    ViewDispatcher* view_dispatcher = malloc(sizeof(ViewDispatcher));
+    view_dispatcher->events = furi_message_queue_alloc(VIEW_DISPATCHER_HOST_QUEUE, sizeof(uint32_t));
+    return view_dispatcher;
+}
+
+void view_dispatcher_free(ViewDispatcher* view_dispatcher) {
+    if(!view_dispatcher) return;
+    furi_message_queue_free(view_dispatcher->events);
+    free(view_dispatcher);
+}
+
+// Events the harness does not keep up with are dropped rather than stalling the sender
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event) {
+    furi_message_queue_put(view_dispatcher->events, &event, 0);
+}
+
+bool view_dispatcher_host_next_event(ViewDispatcher* view_dispatcher, uint32_t* event, uint32_t timeout_ms) {
+    return furi_message_queue_get(view_dispatcher->events, event, timeout_ms) == FuriStatusOk;
+}
@@ -0,0 +1,95 @@
+#include "host_app.h"
+
+// The app layer the link code calls back into, minus the GUI. Mirrors evil_bw16_app.c;
+// the debug log goes nowhere unless a test opens app->debug_log itself.
+
+uint8_t evil_bw16_log_level = EVIL_BW16_LOG_LEVEL_WARN;
+
+EvilBw16App* evil_bw16_host_app_alloc(void) {
+    EvilBw16App* app = malloc(sizeof(EvilBw16App));
+    memset(app, 0, sizeof(EvilBw16App));
+
+    app->config.cycle_delay = 2000;
+    app->config.scan_time = 5000;
+    app->config.num_frames = 3;
+    app->config.start_channel = 1;
+    app->config.led_enabled = true;
+    app->config.gpio_pins = EvilBw16GpioPins13_14;
+    app->config.baud_rate = EVIL_BW16_UART_BAUD_RATE;
+    app->config.log_level = evil_bw16_log_level;
+    app->config.network_ram_kb = EVIL_BW16_NETWORK_RAM_DEFAULT;
+    app->results_sort = EvilBw16NetworkSortRssi;
+    app->results_filter.band = EvilBw16BandUnknown;
+    app->results_filter.min_rssi = INT8_MIN;
+    app->networks = evil_bw16_network_table_alloc(app->config.network_ram_kb * 1024);
+
+    app->view_dispatcher = view_dispatcher_alloc();
+    app->log_store = evil_bw16_log_store_alloc(EVIL_BW16_LOG_STORE_SIZE, EVIL_BW16_LOG_STORE_LINES);
+    app->notifier = evil_bw16_notifier_alloc(app->view_dispatcher);
+    return app;
+}
+
+void evil_bw16_host_app_start(EvilBw16App* app) {
+    furi_check(!app->uart_worker);
+    app->uart_worker = evil_bw16_uart_init(app);
+    furi_check(app->uart_worker);
+}
+
+void evil_bw16_host_app_free(EvilBw16App* app) {
+    if(app->replay) {
+        evil_bw16_replay_free(app->replay);
+    }
+    evil_bw16_sim_free(app->simulator);
+    if(app->uart_worker) {
+        evil_bw16_uart_free(app->uart_worker);
+    }
+    evil_bw16_storage_writer_free(app->debug_log);
+    evil_bw16_notifier_free(app->notifier);
+    evil_bw16_log_store_free(app->log_store);
+    evil_bw16_network_table_free(app->networks);
+    view_dispatcher_free(app->view_dispatcher);
+    free(app);
+}
+
+bool evil_bw16_host_app_wait_event(EvilBw16App* app, uint32_t event, uint32_t timeout_ms) {
+    const uint32_t start = furi_get_tick();
+    for(;;) {
+        const uint32_t elapsed = furi_get_tick() - start;
+        if(elapsed >= timeout_ms) return false;
+
+        uint32_t custom_event;
+        if(!view_dispatcher_host_next_event(app->view_dispatcher, &custom_event, timeout_ms - elapsed)) {
+            return false;
+        }
+        if(custom_event == event) return true;
+        if(custom_event != EvilBw16EventNotify) continue;
+
+        const uint32_t flags = evil_bw16_notifier_take(app->notifier);
+        if((flags & EvilBw16NotifyTerminal) && event == EvilBw16EventUartTerminalRefresh) return true;
+        if((flags & EvilBw16NotifyPacket) && event == EvilBw16EventPacketReceived) return true;
+        if((flags & EvilBw16NotifyScan) && event == EvilBw16EventScanResult) return true;
+        if((flags & EvilBw16NotifyLink) && event == EvilBw16EventLinkReady) return true;
+    }
+}
+
+void evil_bw16_append_log_line(EvilBw16App* app, EvilBw16LineView line) {
+    if(line.len < 3) return;
+    evil_bw16_log_store_append(app->log_store, NULL, line);
+}
+
+void evil_bw16_clear_log(EvilBw16App* app) {
+    evil_bw16_log_store_clear(app->log_store);
+}
+
+void evil_bw16_send_command(EvilBw16App* app, const char* command) {
+    if(!app || !app->uart_worker || !command) return;
+    evil_bw16_log_store_append(app->log_store, "TX: ", evil_bw16_line_view(command, strlen(command)));
+    evil_bw16_uart_send_command(app->uart_worker, command);
+}
+
+void debug_write_line_to_sd(EvilBw16App* app, EvilBw16LineView line) {
+    if(!app->debug_log) return;
+    char timestamp[16];
+    snprintf(timestamp, sizeof(timestamp), "[%lu] ", (unsigned long)furi_get_tick());
+    evil_bw16_storage_writer_write_line(app->debug_log, timestamp, line);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../evil_bw16.h"
+
+// Headless EvilBw16App for the host build: the data the UART worker fills in and the
+// link to the BW16, no views or scenes. Custom events the app would hand to the scene
+// manager are read back with evil_bw16_host_app_wait_event().
+
+// Allocate with the app's default config; tweak app->config before starting the worker
+EvilBw16App* evil_bw16_host_app_alloc(void);
+void evil_bw16_host_app_start(EvilBw16App* app);
+void evil_bw16_host_app_free(EvilBw16App* app);
+
+// Wait for one custom event, fanning worker notifications out like the app does.
+// Other events arriving meanwhile are dropped. False on timeout.
+bool evil_bw16_host_app_wait_event(EvilBw16App* app, uint32_t event, uint32_t timeout_ms);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal checks for the host tests: a failed CHECK reports and carries on, the test
+// program exits non-zero if any failed.
+
+static int host_test_failures;
+
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if(!(cond)) {                                                                  \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);   \
+            host_test_failures++;                                                      \
+        }                                                                              \
+    } while(0)
+
+#define CHECK_EQ(actual, expected)                                                      \
+    do {                                                                                \
+        const long long check_actual = (long long)(actual);                             \
+        const long long check_expected = (long long)(expected);                         \
+        if(check_actual != check_expected) {                                            \
+            fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %lld, expected %lld\n",      \
+                    __FILE__, __LINE__, #actual, check_actual, check_expected);         \
+            host_test_failures++;                                                       \
+        }                                                                               \
+    } while(0)
+
+#define RUN_TEST(test)                         \
+    do {                                       \
+        const int failures_before = host_test_failures; \
+        test();                                \
+        printf("%s %s\n", host_test_failures == failures_before ? "ok  " : "FAIL", #test); \
+    } while(0)
+
+static inline int host_test_result(void) {
+    return host_test_failures ? 1 : 0;
+}
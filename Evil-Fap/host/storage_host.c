@@ -0,0 +1,105 @@
+#include <storage/storage.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Host stand-in for storage: files are stdio streams and /ext/ is a host directory, so
+// a capture or UART log copied off the SD card replays from the same relative path.
+
+#define STORAGE_HOST_PATH_MAX (512)
+
+struct File {
+    FILE* stream;
+};
+
+static char storage_host_root[STORAGE_HOST_PATH_MAX];
+
+void storage_host_set_root(const char* path) {
+    snprintf(storage_host_root, sizeof(storage_host_root), "%s", path);
+}
+
+static const char* storage_host_get_root(void) {
+    if(!storage_host_root[0]) {
+        const char* env = getenv("EVIL_BW16_HOST_EXT");
+        storage_host_set_root(env && env[0] ? env : "ext");
+    }
+    return storage_host_root;
+}
+
+static void storage_host_map(const char* path, char* out, size_t out_size) {
+    static const char ext_prefix[] = "/ext";
+    if(strncmp(path, ext_prefix, sizeof(ext_prefix) - 1) == 0 &&
+       (path[sizeof(ext_prefix) - 1] == '/' || path[sizeof(ext_prefix) - 1] == '\0')) {
+        snprintf(out, out_size, "%s%s", storage_host_get_root(), path + sizeof(ext_prefix) - 1);
+    } else {
+        snprintf(out, out_size, "%s", path);
+    }
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    File* file = malloc(sizeof(File));
+    file->stream = NULL;
+    return file;
+}
+
+void storage_file_free(File* file) {
+    if(!file) return;
+    storage_file_close(file);
+    free(file);
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host_path[STORAGE_HOST_PATH_MAX];
+    storage_host_map(path, host_path, sizeof(host_path));
+    const bool write = access_mode & FSAM_WRITE;
+
+    if(open_mode == FSOM_OPEN_APPEND) {
+        file->stream = fopen(host_path, (access_mode & FSAM_READ) ? "a+b" : "ab");
+    } else if(open_mode == FSOM_CREATE_ALWAYS) {
+        file->stream = fopen(host_path, (access_mode & FSAM_READ) ? "w+b" : "wb");
+    } else if(open_mode == FSOM_CREATE_NEW) {
+        file->stream = fopen(host_path, (access_mode & FSAM_READ) ? "w+xb" : "wxb");
+    } else {
+        file->stream = fopen(host_path, write ? "r+b" : "rb");
+        if(!file->stream && open_mode == FSOM_OPEN_ALWAYS) file->stream = fopen(host_path, "w+b");
+    }
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->stream) return false;
+    fclose(file->stream);
+    file->stream = NULL;
+    return true;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    return file->stream ? fread(buff, 1, bytes_to_read, file->stream) : 0;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    return file->stream ? fwrite(buff, 1, bytes_to_write, file->stream) : 0;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return file->stream && fseek(file->stream, (long)offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+bool storage_file_truncate(File* file) {
+    if(!file->stream) return false;
+    fflush(file->stream);
+    return ftruncate(fileno(file->stream), ftell(file->stream)) == 0;
+}
+
+bool storage_file_sync(File* file) {
+    return file->stream && fflush(file->stream) == 0;
+}
+
+bool storage_simply_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[STORAGE_HOST_PATH_MAX];
+    storage_host_map(path, host_path, sizeof(host_path));
+    mkdir(storage_host_get_root(), 0777);
+    return mkdir(host_path, 0777) == 0 || errno == EEXIST;
+}
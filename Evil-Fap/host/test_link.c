@@ -0,0 +1,260 @@
+#define _GNU_SOURCE
+#include "host_test.h"
+#include "host_app.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Link negotiation against a BW16 stand-in on the far side of a pty. The stand-in
+// answers "set baud", "info" and "set proto" like the firmware, up to the rate and
+// framing it is given, and sees only garbage whenever its rate differs from the one the
+// serial stand-in is set to: commands sent at the wrong rate are lost and its replies
+// arrive mangled.
+
+#define DEVICE_BOOT_BAUD EVIL_BW16_UART_BAUD_RATE
+#define DEVICE_POLL_MS (5)
+#define LINK_TIMEOUT_MS (5000)
+
+typedef struct {
+    int fd;      // Slave side, the device's UART
+    int master;  // Handed to the serial stand-in
+    FuriThread* thread;
+    bool running;
+    uint32_t max_baud;      // Highest rate "set baud" accepts
+    bool binary_supported;  // Whether "set proto binary" is understood
+    // Device state, read by the test thread with test_device_get()
+    uint32_t baud;
+    bool binary;
+    uint32_t garbled;  // Commands lost to a rate mismatch
+    char line[128];
+    size_t line_len;
+} TestDevice;
+
+#define test_device_get(device, field) __atomic_load_n(&(device)->field, __ATOMIC_ACQUIRE)
+#define test_device_set(device, field, value) __atomic_store_n(&(device)->field, value, __ATOMIC_RELEASE)
+
+static bool test_device_in_step(TestDevice* device) {
+    return test_device_get(device, baud) == furi_hal_serial_host_get_baud(FuriHalSerialIdUsart);
+}
+
+static void test_device_write(TestDevice* device, const uint8_t* data, size_t len) {
+    uint8_t out[EVIL_BW16_PROTO_MAX_FRAME];
+    len = MIN(len, sizeof(out));
+    memcpy(out, data, len);
+    if(!test_device_in_step(device)) {
+        // Sampled at the wrong rate, no byte survives intact and no line end comes through
+        for(size_t i = 0; i < len; i++) out[i] = (uint8_t)(out[i] ^ 0xA0) | 0x80;
+    }
+    furi_check(write(device->fd, out, len) == (ssize_t)len);
+}
+
+// One line of output, framed as Text once binary framing is on
+static void test_device_reply(TestDevice* device, const char* text) {
+    uint8_t out[EVIL_BW16_PROTO_MAX_FRAME];
+    size_t len = strlen(text);
+    if(device->binary) {
+        len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)text, len, out, sizeof(out));
+    } else {
+        memcpy(out, text, len);
+        out[len++] = '\r';
+        out[len++] = '\n';
+    }
+    test_device_write(device, out, len);
+}
+
+static void test_device_command(TestDevice* device, const char* command) {
+    unsigned long baud;
+    if(sscanf(command, "set baud %lu", &baud) == 1) {
+        if(baud > device->max_baud) {
+            test_device_reply(device, "[ERROR] Unsupported baud rate");
+            return;
+        }
+        test_device_reply(device, "[CMD] Baud rate changed");
+        test_device_set(device, baud, (uint32_t)baud);
+    } else if(strcmp(command, "info") == 0) {
+        char reply[64];
+        snprintf(reply, sizeof(reply), "[INFO] Evil-BW16 stand-in, %lu baud", (unsigned long)device->baud);
+        test_device_reply(device, reply);
+    } else if(strcmp(command, "set proto binary") == 0 && device->binary_supported) {
+        // Acknowledged in the old framing, like the firmware
+        test_device_reply(device, "[INFO] Proto binary");
+        test_device_set(device, binary, true);
+    } else if(strcmp(command, "set proto text") == 0) {
+        test_device_reply(device, "[INFO] Proto text");
+        test_device_set(device, binary, false);
+    } else {
+        test_device_reply(device, "[ERROR] Unknown command");
+    }
+}
+
+static int32_t test_device_body(void* context) {
+    TestDevice* device = context;
+    while(test_device_get(device, running)) {
+        struct pollfd pfd = {.fd = device->fd, .events = POLLIN};
+        if(poll(&pfd, 1, DEVICE_POLL_MS) <= 0) continue;
+
+        uint8_t data[64];
+        const ssize_t len = read(device->fd, data, sizeof(data));
+        if(len <= 0) continue;
+        const bool in_step = test_device_in_step(device);
+        for(ssize_t i = 0; i < len; i++) {
+            if(data[i] != '\n') {
+                if(device->line_len < sizeof(device->line) - 1) device->line[device->line_len++] = (char)data[i];
+                continue;
+            }
+            device->line[device->line_len] = '\0';
+            device->line_len = 0;
+            if(in_step) {
+                test_device_command(device, device->line);
+            } else {
+                test_device_set(device, garbled, device->garbled + 1);
+            }
+        }
+    }
+    return 0;
+}
+
+// Open a raw pty pair, hand the master to the serial stand-in and run the device on the slave
+static void test_device_start(TestDevice* device, uint32_t max_baud, bool binary_supported) {
+    memset(device, 0, sizeof(TestDevice));
+    device->max_baud = max_baud;
+    device->binary_supported = binary_supported;
+    device->baud = DEVICE_BOOT_BAUD;
+
+    device->master = posix_openpt(O_RDWR | O_NOCTTY);
+    furi_check(device->master >= 0 && grantpt(device->master) == 0 && unlockpt(device->master) == 0);
+    device->fd = open(ptsname(device->master), O_RDWR | O_NOCTTY);
+    furi_check(device->fd >= 0);
+    const int fds[] = {device->master, device->fd};
+    for(size_t i = 0; i < COUNT_OF(fds); i++) {
+        struct termios tio;
+        furi_check(tcgetattr(fds[i], &tio) == 0);
+        cfmakeraw(&tio);
+        furi_check(tcsetattr(fds[i], TCSANOW, &tio) == 0);
+    }
+    furi_hal_serial_host_connect(FuriHalSerialIdUsart, device->master);
+
+    test_device_set(device, running, true);
+    device->thread = furi_thread_alloc_ex("TestDevice", 2048, test_device_body, device);
+    furi_thread_start(device->thread);
+}
+
+static void test_device_stop(TestDevice* device) {
+    test_device_set(device, running, false);
+    furi_thread_join(device->thread);
+    furi_thread_free(device->thread);
+    furi_hal_serial_host_connect(FuriHalSerialIdUsart, -1);
+    close(device->fd);
+    close(device->master);
+}
+
+static EvilBw16App* test_app_start(uint32_t baud_rate, bool binary_protocol) {
+    EvilBw16App* app = evil_bw16_host_app_alloc();
+    app->config.baud_rate = baud_rate;
+    app->config.binary_protocol = binary_protocol;
+    evil_bw16_host_app_start(app);
+    return app;
+}
+
+// After negotiation, the link must carry replies end to end
+static void test_check_link(EvilBw16App* app, TestDevice* device, uint32_t baud_rate, bool binary) {
+    EvilBw16UartWorker* worker = app->uart_worker;
+    CHECK(!evil_bw16_uart_is_negotiating(worker));
+    CHECK_EQ(evil_bw16_uart_get_baud_rate(worker), baud_rate);
+    CHECK_EQ(furi_hal_serial_host_get_baud(FuriHalSerialIdUsart), baud_rate);
+    CHECK_EQ(test_device_get(device, baud), baud_rate);
+    CHECK_EQ(test_device_get(device, binary), binary);
+
+    EvilBw16UartStats stats;
+    evil_bw16_uart_get_stats(worker, &stats);
+    CHECK_EQ(stats.binary_protocol, binary);
+
+    char response[64];
+    char expected[64];
+    snprintf(expected, sizeof(expected), "[INFO] Evil-BW16 stand-in, %lu baud", (unsigned long)baud_rate);
+    evil_bw16_uart_send_command(worker, "info");
+    CHECK(evil_bw16_uart_wait_for_response(worker, "[INFO] Evil-BW16", response, sizeof(response), 1000));
+    CHECK(strcmp(response, expected) == 0);
+}
+
+static void test_negotiates_highest_rate(void) {
+    TestDevice device;
+    test_device_start(&device, 921600, true);
+    EvilBw16App* app = test_app_start(921600, true);
+
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+    test_check_link(app, &device, 921600, true);
+    CHECK_EQ(test_device_get(&device, garbled), 0);
+
+    // Freeing the worker puts the BW16 back on its boot rate and framing
+    evil_bw16_host_app_free(app);
+    furi_delay_ms(20);
+    CHECK_EQ(test_device_get(&device, baud), DEVICE_BOOT_BAUD);
+    CHECK(!test_device_get(&device, binary));
+    test_device_stop(&device);
+}
+
+static void test_falls_back_when_rate_refused(void) {
+    TestDevice device;
+    test_device_start(&device, 460800, false);
+    EvilBw16App* app = test_app_start(921600, false);
+
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+    test_check_link(app, &device, 460800, false);
+    // The "info" sent at 921600 and the fallback "set baud" never reached the device
+    CHECK_EQ(test_device_get(&device, garbled), 2);
+
+    evil_bw16_host_app_free(app);
+    test_device_stop(&device);
+}
+
+static void test_boot_rate_when_nothing_faster(void) {
+    TestDevice device;
+    test_device_start(&device, DEVICE_BOOT_BAUD, false);
+    EvilBw16App* app = test_app_start(921600, false);
+
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+    test_check_link(app, &device, DEVICE_BOOT_BAUD, false);
+
+    evil_bw16_host_app_free(app);
+    test_device_stop(&device);
+}
+
+static void test_text_without_binary_ack(void) {
+    TestDevice device;
+    test_device_start(&device, 921600, false);
+    EvilBw16App* app = test_app_start(921600, true);
+
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+    test_check_link(app, &device, 921600, false);
+
+    evil_bw16_host_app_free(app);
+    test_device_stop(&device);
+}
+
+static void test_renegotiate_down(void) {
+    TestDevice device;
+    test_device_start(&device, 921600, true);
+    EvilBw16App* app = test_app_start(921600, true);
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+
+    // Back to the boot state from a framed link at full rate
+    app->config.baud_rate = DEVICE_BOOT_BAUD;
+    app->config.binary_protocol = false;
+    evil_bw16_uart_renegotiate(app->uart_worker);
+    CHECK(evil_bw16_host_app_wait_event(app, EvilBw16EventLinkReady, LINK_TIMEOUT_MS));
+    test_check_link(app, &device, DEVICE_BOOT_BAUD, false);
+
+    evil_bw16_host_app_free(app);
+    test_device_stop(&device);
+}
+
+int main(void) {
+    RUN_TEST(test_negotiates_highest_rate);
+    RUN_TEST(test_falls_back_when_rate_refused);
+    RUN_TEST(test_boot_rate_when_nothing_faster);
+    RUN_TEST(test_text_without_binary_ack);
+    RUN_TEST(test_renegotiate_down);
+    return host_test_result();
+}
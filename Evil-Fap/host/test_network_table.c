@@ -0,0 +1,517 @@
+#include "host_test.h"
+#include "host_app.h"
+
+// Scan list storage. The table's statics are reached by building its source into this
+// test, so it links without evil_bw16_network_table.o. The test is the only thread, so
+// lookups are made without holding the table lock.
+#include "../evil_bw16_network_table.c"
+
+#define TEST_BUDGET_MIN (0)  // Rounds up to one block of NETWORK_BLOCK_SIZE
+
+// A network with a BSSID made from id, heard at rssi on channel
+static EvilBw16Network test_network(uint16_t id, int8_t rssi, uint8_t channel) {
+    EvilBw16Network network = {0};
+    network.bssid[0] = 0x02;  // Locally administered, like the simulator's
+    network.bssid[4] = id >> 8;
+    network.bssid[5] = id & 0xFF;
+    network.rssi = rssi;
+    network.channel = channel;
+    network.band = channel > 14 ? EvilBw16Band5GHz : EvilBw16Band24GHz;
+    return network;
+}
+
+static EvilBw16NetworkHandle test_upsert(EvilBw16NetworkTable* table, uint16_t id, int8_t rssi, const char* ssid, bool* created) {
+    const EvilBw16Network network = test_network(id, rssi, 1 + id % 11);
+    return evil_bw16_network_table_upsert(table, &network, evil_bw16_line_view(ssid, strlen(ssid)), created);
+}
+
+// Whether handle still names the network made from id
+static bool test_names(EvilBw16NetworkTable* table, EvilBw16NetworkHandle handle, uint16_t id) {
+    const EvilBw16Network* entry = evil_bw16_network_table_get(table, handle);
+    const EvilBw16Network expected = test_network(id, 0, 0);
+    return entry && memcmp(entry->bssid, expected.bssid, sizeof(expected.bssid)) == 0;
+}
+
+static void test_dedupe(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    evil_bw16_network_table_begin_scan(table);
+
+    bool created;
+    const EvilBw16NetworkHandle first = test_upsert(table, 7, -60, "home", &created);
+    CHECK(first != EVIL_BW16_NETWORK_NONE);
+    CHECK(created);
+    CHECK_EQ(test_upsert(table, 7, -50, "home", &created), first);
+    CHECK(!created);
+    CHECK_EQ(evil_bw16_network_table_count(table), 1);
+    CHECK_EQ(evil_bw16_network_table_get(table, first)->rssi, -50);
+
+    // One differing byte is another network
+    const EvilBw16NetworkHandle second = test_upsert(table, 7 + 256, -70, "home", &created);
+    CHECK(created);
+    CHECK(second != first);
+    const EvilBw16Network probe = test_network(7, 0, 0);
+    CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), first);
+
+    EvilBw16NetworkTableStats stats;
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.count, 2);
+    CHECK_EQ(stats.duplicates, 1);
+    CHECK_EQ(stats.ssids_shared, 1);
+    evil_bw16_network_table_free(table);
+}
+
+// The fixed list stopped at 50
+static void test_grows_past_50(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(16 * 1024);
+    evil_bw16_network_table_begin_scan(table);
+
+    EvilBw16NetworkHandle handles[200];
+    char ssid[16];
+    for(uint16_t id = 0; id < COUNT_OF(handles); id++) {
+        snprintf(ssid, sizeof(ssid), "net%u", id % 64);
+        handles[id] = test_upsert(table, id, -40 - id % 50, ssid, NULL);
+        CHECK(handles[id] != EVIL_BW16_NETWORK_NONE);
+    }
+    CHECK_EQ(evil_bw16_network_table_count(table), COUNT_OF(handles));
+    for(uint16_t id = 0; id < COUNT_OF(handles); id++) {
+        const EvilBw16Network probe = test_network(id, 0, 0);
+        CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), handles[id]);
+        CHECK_EQ(evil_bw16_network_table_at(table, id), handles[id]);
+    }
+
+    EvilBw16NetworkTableStats stats;
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK(stats.capacity >= COUNT_OF(handles));
+    CHECK(stats.bytes <= stats.budget);
+    CHECK_EQ(stats.rejected, 0);
+    evil_bw16_network_table_free(table);
+}
+
+// A full table turns new networks away while everything in it was heard this scan
+static void test_rejects_over_budget(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(TEST_BUDGET_MIN);
+    evil_bw16_network_table_begin_scan(table);
+
+    EvilBw16NetworkTableStats stats;
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.capacity, NETWORK_BLOCK_SIZE);
+    for(uint16_t id = 0; id < stats.capacity; id++) {
+        CHECK(test_upsert(table, id, -60, "", NULL) != EVIL_BW16_NETWORK_NONE);
+    }
+
+    bool created;
+    CHECK_EQ(test_upsert(table, 100, -30, "late", &created), EVIL_BW16_NETWORK_NONE);
+    CHECK(created);
+    const EvilBw16Network probe = test_network(100, 0, 0);
+    CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), EVIL_BW16_NETWORK_NONE);
+    // Networks already in still update
+    CHECK(test_upsert(table, 3, -35, "", &created) != EVIL_BW16_NETWORK_NONE);
+    CHECK(!created);
+
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.count, NETWORK_BLOCK_SIZE);
+    CHECK_EQ(stats.rejected, 1);
+    CHECK_EQ(stats.evicted, 0);
+    evil_bw16_network_table_free(table);
+}
+
+// A handle keeps naming its network while others come and go around it
+static void test_handles_stable(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    evil_bw16_network_table_begin_scan(table);
+
+    EvilBw16NetworkHandle handles[54];
+    for(uint16_t id = 0; id < 40; id++) {
+        handles[id] = test_upsert(table, id, -60, "stable", NULL);
+    }
+    for(uint16_t id = 0; id < 40; id += 3) {
+        evil_bw16_network_table_remove(table, handles[id]);
+        CHECK(evil_bw16_network_table_get(table, handles[id]) == NULL);
+    }
+    CHECK_EQ(evil_bw16_network_table_count(table), 40 - 14);
+
+    // Freed slots are handed out again, to the new networks
+    for(uint16_t id = 40; id < COUNT_OF(handles); id++) {
+        handles[id] = test_upsert(table, id, -60, "stable", NULL);
+        CHECK(handles[id] < 40);
+        CHECK(test_names(table, handles[id], id));
+    }
+    for(uint16_t id = 0; id < 40; id++) {
+        if(id % 3) CHECK(test_names(table, handles[id], id));
+    }
+    // Positions close up; the order is still first seen first
+    CHECK_EQ(evil_bw16_network_table_at(table, 0), handles[1]);
+    CHECK_EQ(evil_bw16_network_table_at(table, 26), handles[40]);
+    evil_bw16_network_table_free(table);
+}
+
+// Long enough to be aged out by TEST_MAX_AGE, with room for a slow scheduler either side
+#define TEST_MAX_AGE (100)
+#define TEST_AGE_GAP (2 * TEST_MAX_AGE)
+
+// Whether position walks in every sort order list exactly the handles in order
+static bool test_sorts_hold_order(EvilBw16NetworkTable* table) {
+    const size_t count = evil_bw16_network_table_count(table);
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        for(size_t i = 0; i < count; i++) {
+            const EvilBw16NetworkHandle handle = evil_bw16_network_table_at(table, i);
+            size_t found = 0;
+            for(size_t position = 0; position < count; position++) {
+                found += evil_bw16_network_table_sorted_at(table, sort, position) == handle;
+            }
+            if(found != 1) return false;
+        }
+        if(evil_bw16_network_table_sorted_at(table, sort, count) != EVIL_BW16_NETWORK_NONE) return false;
+    }
+    return true;
+}
+
+// Networks not heard within max_age go from every array, and the arena is repacked
+static void test_age(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    evil_bw16_network_table_begin_scan(table);
+
+    EvilBw16NetworkHandle handles[10];
+    char ssid[16];
+    for(uint16_t id = 0; id < COUNT_OF(handles); id++) {
+        snprintf(ssid, sizeof(ssid), "%s-%u", id % 2 ? "kept" : "aged", id);
+        handles[id] = test_upsert(table, id, -80 + id, ssid, NULL);
+    }
+    EvilBw16NetworkTableStats before;
+    evil_bw16_network_table_get_stats(table, &before);
+
+    // The odd ones are heard again, stronger, which moves them in the RSSI order
+    furi_delay_ms(TEST_AGE_GAP);
+    for(uint16_t id = 1; id < COUNT_OF(handles); id += 2) {
+        snprintf(ssid, sizeof(ssid), "kept-%u", id);
+        test_upsert(table, id, -30 - id, ssid, NULL);
+    }
+    CHECK_EQ(evil_bw16_network_table_age(table, TEST_MAX_AGE), 5);
+
+    CHECK_EQ(evil_bw16_network_table_count(table), 5);
+    CHECK_EQ(evil_bw16_network_table_heard_count(table), 5);
+    CHECK(test_sorts_hold_order(table));
+    for(size_t position = 0; position < 5; position++) {
+        const EvilBw16NetworkHandle handle = evil_bw16_network_table_sorted_at(table, EvilBw16NetworkSortRssi, position);
+        CHECK_EQ(handle, handles[9 - 2 * position]);  // The smoothed RSSI leaves 9 strongest
+        CHECK_EQ(evil_bw16_network_table_heard_at(table, position), handles[1 + 2 * position]);
+    }
+    for(uint16_t id = 0; id < COUNT_OF(handles); id++) {
+        const EvilBw16Network probe = test_network(id, 0, 0);
+        if(id % 2) {
+            snprintf(ssid, sizeof(ssid), "kept-%u", id);
+            CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), handles[id]);
+            CHECK(strcmp(evil_bw16_network_table_get_ssid(table, evil_bw16_network_table_get(table, handles[id])), ssid) == 0);
+        } else {
+            CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), EVIL_BW16_NETWORK_NONE);
+            CHECK(evil_bw16_network_table_get(table, handles[id]) == NULL);
+        }
+    }
+
+    EvilBw16NetworkTableStats after;
+    evil_bw16_network_table_get_stats(table, &after);
+    CHECK_EQ(after.ssid_bytes, before.ssid_bytes / 2);
+    CHECK(!table->ssid_stale);
+    evil_bw16_network_table_free(table);
+}
+
+// Collect ids whose BSSIDs hash home to slot, up to count
+static size_t test_find_homes(EvilBw16NetworkTable* table, uint32_t slot, uint16_t* ids, size_t count) {
+    size_t found = 0;
+    for(uint32_t id = 0; id <= UINT16_MAX && found < count; id++) {
+        const EvilBw16Network network = test_network(id, 0, 0);
+        if(hash_home(table, network.bssid) == slot) ids[found++] = id;
+    }
+    return found;
+}
+
+// Removing from a probe run pulls the entries behind it back, and leaves those already
+// at home alone
+static void test_hash_delete_run(bool wrap) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    evil_bw16_network_table_begin_scan(table);
+    const uint32_t mask = table->hash_mask;
+    const uint32_t home = wrap ? mask - 1 : 17;
+
+    // A, B and C share a home; D's home is the slot after it and E's four on
+    uint16_t ids[5];
+    CHECK_EQ(test_find_homes(table, home, ids, 3), 3);
+    CHECK_EQ(test_find_homes(table, (home + 1) & mask, &ids[3], 1), 1);
+    CHECK_EQ(test_find_homes(table, (home + 4) & mask, &ids[4], 1), 1);
+    EvilBw16NetworkHandle handles[5];
+    for(size_t i = 0; i < COUNT_OF(ids); i++) {
+        handles[i] = test_upsert(table, ids[i], -60, "", NULL);
+    }
+    for(size_t i = 0; i < COUNT_OF(ids); i++) {
+        CHECK_EQ(table->hash[(home + i) & mask], handles[i]);
+    }
+
+    evil_bw16_network_table_remove(table, handles[0]);
+    CHECK_EQ(table->hash[home], handles[1]);
+    CHECK_EQ(table->hash[(home + 1) & mask], handles[2]);
+    CHECK_EQ(table->hash[(home + 2) & mask], handles[3]);
+    CHECK_EQ(table->hash[(home + 3) & mask], EVIL_BW16_NETWORK_NONE);
+    CHECK_EQ(table->hash[(home + 4) & mask], handles[4]);
+
+    evil_bw16_network_table_remove(table, handles[1]);
+    CHECK_EQ(table->hash[home], handles[2]);
+    CHECK_EQ(table->hash[(home + 1) & mask], handles[3]);
+    CHECK_EQ(table->hash[(home + 2) & mask], EVIL_BW16_NETWORK_NONE);
+
+    for(size_t i = 0; i < COUNT_OF(ids); i++) {
+        const EvilBw16Network probe = test_network(ids[i], 0, 0);
+        CHECK_EQ(evil_bw16_network_table_find(table, probe.bssid), i < 2 ? EVIL_BW16_NETWORK_NONE : handles[i]);
+    }
+    evil_bw16_network_table_free(table);
+}
+
+static void test_hash_delete(void) {
+    test_hash_delete_run(false);
+    test_hash_delete_run(true);  // The run wraps past the last slot
+}
+
+// A full table makes room by dropping the network heard longest ago, never one heard in
+// the current scan
+static void test_evict_stalest(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(TEST_BUDGET_MIN);
+    evil_bw16_network_table_begin_scan(table);
+
+    EvilBw16NetworkHandle handles[NETWORK_BLOCK_SIZE];
+    for(uint16_t id = 0; id < COUNT_OF(handles); id++) {
+        handles[id] = test_upsert(table, id, -60, "", NULL);
+    }
+    furi_delay_ms(5);
+    test_upsert(table, 4, -60, "", NULL);  // Heard later than the rest
+    furi_delay_ms(5);
+
+    evil_bw16_network_table_begin_scan(table);
+    for(uint16_t id = 0; id < 4; id++) {
+        test_upsert(table, id, -60, "", NULL);
+    }
+    // 5 to 15 go first, the oldest (ties in arrival order), then 4
+    for(uint16_t id = 100; id < 112; id++) {
+        const EvilBw16NetworkHandle handle = test_upsert(table, id, -60, "", NULL);
+        const uint16_t evicted = id < 111 ? id - 95 : 4;
+        CHECK_EQ(handle, handles[evicted]);
+        CHECK(test_names(table, handle, id));
+    }
+    for(uint16_t id = 0; id < 4; id++) {
+        CHECK(test_names(table, handles[id], id));
+    }
+    CHECK_EQ(evil_bw16_network_table_count(table), NETWORK_BLOCK_SIZE);
+
+    // Everything left was heard in this scan
+    CHECK_EQ(test_upsert(table, 200, -60, "", NULL), EVIL_BW16_NETWORK_NONE);
+    EvilBw16NetworkTableStats stats;
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.evicted, 12);
+    CHECK_EQ(stats.rejected, 1);
+    evil_bw16_network_table_free(table);
+}
+
+// The arena makes room from the SSIDs of renamed networks before evicting any, and by
+// evicting once those are gone
+static void test_ssid_repack(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(TEST_BUDGET_MIN);
+    evil_bw16_network_table_begin_scan(table);
+
+    char ssid[EVIL_BW16_SSID_MAX_LEN + 1];
+    for(uint16_t id = 0; id < 8; id++) {
+        snprintf(ssid, sizeof(ssid), "first-%u", id);
+        test_upsert(table, id, -60, ssid, NULL);
+    }
+    for(uint16_t id = 0; id < 8; id++) {
+        snprintf(ssid, sizeof(ssid), "second-%u", id);
+        test_upsert(table, id, -60, ssid, NULL);
+    }
+    CHECK(table->ssid_stale);
+    CHECK_EQ(table->ssid_count, NETWORK_BLOCK_SIZE);
+
+    // A new SSID no longer fits, and every network could be evicted
+    furi_delay_ms(5);
+    evil_bw16_network_table_begin_scan(table);
+    CHECK(test_upsert(table, 8, -60, "third", NULL) != EVIL_BW16_NETWORK_NONE);
+    EvilBw16NetworkTableStats stats;
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.evicted, 0);
+    CHECK_EQ(stats.count, 9);
+    CHECK_EQ(stats.ssid_bytes, 8 * sizeof("second-0") + sizeof("third"));
+    for(uint16_t id = 0; id < 9; id++) {
+        snprintf(ssid, sizeof(ssid), id < 8 ? "second-%u" : "third", id);
+        const EvilBw16Network probe = test_network(id, 0, 0);
+        const EvilBw16Network* entry = evil_bw16_network_table_get(table, evil_bw16_network_table_find(table, probe.bssid));
+        CHECK(strcmp(evil_bw16_network_table_get_ssid(table, entry), ssid) == 0);
+    }
+
+    // Fill the one chunk with longest SSIDs, seven to a chunk
+    evil_bw16_network_table_clear(table);
+    evil_bw16_network_table_begin_scan(table);
+    for(uint16_t id = 0; id < 8; id++) {
+        snprintf(ssid, sizeof(ssid), "%0*u", EVIL_BW16_SSID_MAX_LEN, id);
+        const EvilBw16NetworkHandle handle = test_upsert(table, id, -60, ssid, NULL);
+        CHECK(id < 7 ? handle != EVIL_BW16_NETWORK_NONE : handle == EVIL_BW16_NETWORK_NONE);
+    }
+    furi_delay_ms(5);
+    evil_bw16_network_table_begin_scan(table);
+    CHECK(test_upsert(table, 7, -60, ssid, NULL) != EVIL_BW16_NETWORK_NONE);
+    evil_bw16_network_table_get_stats(table, &stats);
+    CHECK_EQ(stats.evicted, 1);
+    CHECK_EQ(stats.count, 7);
+    for(uint16_t id = 1; id < 8; id++) {
+        snprintf(ssid, sizeof(ssid), "%0*u", EVIL_BW16_SSID_MAX_LEN, id);
+        const EvilBw16Network probe = test_network(id, 0, 0);
+        const EvilBw16Network* entry = evil_bw16_network_table_get(table, evil_bw16_network_table_find(table, probe.bssid));
+        CHECK(strcmp(evil_bw16_network_table_get_ssid(table, entry), ssid) == 0);
+    }
+    evil_bw16_network_table_free(table);
+}
+
+// Deterministic stand-in for a busy air: a small LCG
+static uint32_t test_random(uint32_t* state) {
+    *state = *state * 1103515245U + 12345U;
+    return *state >> 16;
+}
+
+static const char* const test_ssids[] = {"alpha", "Alpha", "beta", "", "Cafe", "cafe-5G", "delta", ""};
+
+// Report network id with a random RSSI, channel and SSID
+static EvilBw16NetworkHandle test_upsert_random(EvilBw16NetworkTable* table, uint16_t id, uint32_t* state) {
+    static const uint8_t channels[] = {1, 6, 11, 36, 44, 149};
+    const uint8_t channel = channels[test_random(state) % COUNT_OF(channels)];
+    const EvilBw16Network network = test_network(id, -90 + (int8_t)(test_random(state) % 60), channel);
+    const char* ssid = test_ssids[test_random(state) % COUNT_OF(test_ssids)];
+    return evil_bw16_network_table_upsert(table, &network, evil_bw16_line_view(ssid, strlen(ssid)), NULL);
+}
+
+static EvilBw16NetworkTable* test_sort_table;
+static EvilBw16NetworkSort test_sort_key;
+
+static int test_sort_reference(const void* a, const void* b) {
+    const EvilBw16NetworkTable* table = test_sort_table;
+    return sort_compare(table, test_sort_key, pool_slot(table, *(const uint16_t*)a), pool_slot(table, *(const uint16_t*)b));
+}
+
+// Whether every kept permutation matches a fresh sort of the arrival order. Equal keys
+// may sit in either order, so positions are compared by key.
+static bool test_sorts_match(EvilBw16NetworkTable* table) {
+    if(!test_sorts_hold_order(table)) return false;
+    const size_t count = evil_bw16_network_table_count(table);
+    uint16_t reference[EVIL_BW16_NETWORK_TABLE_MAX];
+    for(uint8_t sort = EvilBw16NetworkSortArrival + 1; sort < EvilBw16NetworkSortNum; sort++) {
+        memcpy(reference, table->order, count * sizeof(uint16_t));
+        test_sort_table = table;
+        test_sort_key = sort;
+        qsort(reference, count, sizeof(uint16_t), test_sort_reference);
+        for(size_t position = 0; position < count; position++) {
+            const EvilBw16Network* kept = pool_slot(table, evil_bw16_network_table_sorted_at(table, sort, position));
+            if(sort_compare(table, sort, kept, pool_slot(table, reference[position])) != 0) return false;
+        }
+    }
+    return true;
+}
+
+// The permutations follow inserts, updates that move a network's keys, removals and
+// ageing without ever being re-sorted
+static void test_sorted_permutations(void) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(EVIL_BW16_NETWORK_RAM_DEFAULT * 1024);
+    evil_bw16_network_table_begin_scan(table);
+    uint32_t state = 1;
+
+    for(uint16_t id = 0; id < 80; id++) {
+        test_upsert_random(table, id, &state);
+    }
+    CHECK(test_sorts_match(table));
+
+    // RSSI changes on nearly every report, channel and SSID now and then
+    for(uint16_t round = 0; round < 200; round++) {
+        test_upsert_random(table, test_random(&state) % 80, &state);
+    }
+    CHECK(test_sorts_match(table));
+
+    for(uint16_t id = 0; id < 80; id += 4) {
+        const EvilBw16Network probe = test_network(id, 0, 0);
+        evil_bw16_network_table_remove(table, evil_bw16_network_table_find(table, probe.bssid));
+    }
+    CHECK_EQ(evil_bw16_network_table_count(table), 60);
+    CHECK(test_sorts_match(table));
+
+    // Half are heard again before the rest age out
+    furi_delay_ms(TEST_AGE_GAP);
+    for(uint16_t id = 1; id < 80; id += 2) {
+        test_upsert_random(table, id, &state);
+    }
+    CHECK_EQ(evil_bw16_network_table_age(table, TEST_MAX_AGE), 20);
+    CHECK_EQ(evil_bw16_network_table_count(table), 40);
+    CHECK(test_sorts_match(table));
+
+    // New networks take the freed slots
+    for(uint16_t id = 100; id < 140; id++) {
+        test_upsert_random(table, id, &state);
+    }
+    CHECK(test_sorts_match(table));
+    evil_bw16_network_table_free(table);
+}
+
+// The record and fixed list the table replaced
+#define LEGACY_MAX_NETWORKS (50)
+
+typedef struct {
+    uint8_t index;
+    uint8_t device_index;
+    char ssid[64];
+    char bssid[18];
+    int channel;
+    int rssi;
+    EvilBw16Band band;
+    bool selected;
+} LegacyNetwork;
+
+// Fill a table at budget with networks named like a busy area's, mostly distinct SSIDs
+// of 8 to 12 characters, and return what it holds
+static void test_fill(size_t budget, EvilBw16NetworkTableStats* stats) {
+    EvilBw16NetworkTable* table = evil_bw16_network_table_alloc(budget);
+    evil_bw16_network_table_begin_scan(table);
+    char ssid[16];
+    for(uint16_t id = 0; id < EVIL_BW16_NETWORK_TABLE_MAX; id++) {
+        snprintf(ssid, sizeof(ssid), "%s-%u", id % 4 ? "Network" : "Guest", id % 400);
+        if(test_upsert(table, id, -50, ssid, NULL) == EVIL_BW16_NETWORK_NONE) break;
+    }
+    evil_bw16_network_table_get_stats(table, stats);
+    evil_bw16_network_table_free(table);
+}
+
+// Bytes per network before and after. The target was several hundred networks in the
+// RAM 50 took; the record alone is a quarter of the old one, but with the hashes, sort
+// orders and SSID arena the table reaches about 80 there.
+static void test_bytes_per_network(void) {
+    const size_t legacy_bytes = LEGACY_MAX_NETWORKS * sizeof(LegacyNetwork);
+    printf("Before: %zu B per network, %u networks in %zu B\n", sizeof(LegacyNetwork), LEGACY_MAX_NETWORKS, legacy_bytes);
+    printf("After: %zu B record\n", sizeof(EvilBw16Network));
+
+    EvilBw16NetworkTableStats stats;
+    test_fill(legacy_bytes, &stats);
+    printf("  %zu B: %zu networks, %zu B used, %zu B per network\n", stats.budget, stats.count, stats.bytes, stats.bytes / stats.count);
+    CHECK(stats.count > LEGACY_MAX_NETWORKS);
+    CHECK(stats.bytes <= stats.budget);
+
+    for(size_t kb = 4; kb <= 32; kb *= 2) {
+        test_fill(kb * 1024, &stats);
+        printf("  %zu B: %zu networks, %zu B used, %zu B per network\n", stats.budget, stats.count, stats.bytes, stats.bytes / stats.count);
+        CHECK_EQ(stats.count, stats.capacity);
+        CHECK(stats.bytes <= stats.budget);
+    }
+}
+
+int main(void) {
+    RUN_TEST(test_dedupe);
+    RUN_TEST(test_grows_past_50);
+    RUN_TEST(test_rejects_over_budget);
+    RUN_TEST(test_handles_stable);
+    RUN_TEST(test_bytes_per_network);
+    RUN_TEST(test_age);
+    RUN_TEST(test_hash_delete);
+    RUN_TEST(test_evict_stalest);
+    RUN_TEST(test_ssid_repack);
+    RUN_TEST(test_sorted_permutations);
+    return host_test_result();
+}
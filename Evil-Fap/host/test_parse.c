@@ -0,0 +1,131 @@
+#include "host_test.h"
+#include "host_app.h"
+
+// Line classification, scan result parsing and the WebUI line filter
+
+static EvilBw16LineView view(const char* text) {
+    return evil_bw16_line_view(text, strlen(text));
+}
+
+static void test_classify_tags(void) {
+    CHECK_EQ(evil_bw16_classify_line(view("[INFO] Scan started")), EvilBw16ResponseInfo);
+    CHECK_EQ(evil_bw16_classify_line(view("[ERROR] bad channel")), EvilBw16ResponseError);
+    CHECK_EQ(evil_bw16_classify_line(view("[DEBUG] heap 1234")), EvilBw16ResponseDebug);
+    CHECK_EQ(evil_bw16_classify_line(view("[DATA] ch 6")), EvilBw16ResponseData);
+    CHECK_EQ(evil_bw16_classify_line(view("[CMD] scan")), EvilBw16ResponseCommand);
+    CHECK_EQ(evil_bw16_classify_line(view("[MGMT] beacon")), EvilBw16ResponseMgmt);
+    CHECK_EQ(evil_bw16_classify_line(view("[HOP] 11")), EvilBw16ResponseChannelHop);
+    CHECK_EQ(evil_bw16_classify_line(view("RAW UART RX: scan")), EvilBw16ResponseDebug);
+    CHECK_EQ(evil_bw16_classify_line(view("SCAN COMMAND received")), EvilBw16ResponseDebug);
+}
+
+static void test_classify_rejects(void) {
+    CHECK_EQ(evil_bw16_classify_line(view("")), EvilBw16ResponseUnknown);
+    CHECK_EQ(evil_bw16_classify_line(view("[INF] short")), EvilBw16ResponseUnknown);
+    CHECK_EQ(evil_bw16_classify_line(view("[INFORMATION] long")), EvilBw16ResponseUnknown);
+    CHECK_EQ(evil_bw16_classify_line(view("[INFO")), EvilBw16ResponseUnknown);
+    CHECK_EQ(evil_bw16_classify_line(view("INFO] no bracket")), EvilBw16ResponseUnknown);
+    // The tag must be complete inside the view, not just in the buffer behind it
+    CHECK_EQ(evil_bw16_classify_line(evil_bw16_line_view("[INFO] x", 5)), EvilBw16ResponseUnknown);
+}
+
+static void test_scan_result_fields(void) {
+    EvilBw16Network network = {0};
+    EvilBw16LineView ssid;
+    CHECK(evil_bw16_parse_scan_result(view("[INFO] 3\tfirst home\t\t11:22:33:44:55:66\t\t6\t-45\t2.4GHz"), &network, &ssid));
+    CHECK_EQ(network.device_index, 3);
+    CHECK_EQ(network.channel, 6);
+    CHECK_EQ(network.rssi, -45);
+    CHECK_EQ(network.band, EvilBw16Band24GHz);
+    CHECK_EQ(network.bssid[0], 0x11);
+    CHECK_EQ(network.bssid[5], 0x66);
+    CHECK(ssid.len == 10 && memcmp(ssid.data, "first home", 10) == 0);
+}
+
+static void test_scan_result_band_and_ssid(void) {
+    EvilBw16Network network = {0};
+    EvilBw16LineView ssid;
+
+    // No frequency field: the band follows from the channel
+    CHECK(evil_bw16_parse_scan_result(view("12\tfive\taa:bb:cc:dd:ee:ff\t149\t-70\r\n"), &network, &ssid));
+    CHECK_EQ(network.band, EvilBw16Band5GHz);
+    CHECK_EQ(network.channel, 149);
+    CHECK_EQ(network.bssid[0], 0xAA);
+
+    // Hidden network, and an SSID with a tab in it
+    CHECK(evil_bw16_parse_scan_result(view("0\t\t\t11:22:33:44:55:66\t\t1\t-30\t2.4GHz"), &network, &ssid));
+    CHECK_EQ(ssid.len, 0);
+    CHECK(evil_bw16_parse_scan_result(view("1\ta\tb\t11:22:33:44:55:66\t1\t-30\t5GHz"), &network, &ssid));
+    CHECK(ssid.len == 3 && memcmp(ssid.data, "a\tb", 3) == 0);
+    CHECK_EQ(network.band, EvilBw16Band5GHz);
+}
+
+static void test_scan_result_rejects(void) {
+    EvilBw16Network network = {0};
+    EvilBw16LineView ssid;
+    CHECK(!evil_bw16_parse_scan_result(view("[INFO] Scan completed"), &network, &ssid));
+    CHECK(!evil_bw16_parse_scan_result(view("x\tname\t11:22:33:44:55:66\t1\t-30"), &network, &ssid));
+    CHECK(!evil_bw16_parse_scan_result(view("0\tname\t11:22:33:44:55\t1\t-30"), &network, &ssid));
+    CHECK(!evil_bw16_parse_scan_result(view("0\tname\t11-22-33-44-55-66\t1\t-30"), &network, &ssid));
+    CHECK(!evil_bw16_parse_scan_result(view("0\tname\t11:22:33:44:55:66\t1\t"), &network, &ssid));
+    CHECK(!evil_bw16_parse_scan_result(view("99999999999\tname\t11:22:33:44:55:66\t1\t-30"), &network, &ssid));
+}
+
+static void test_parse_int(void) {
+    int value = 0;
+    CHECK(evil_bw16_line_parse_int(view(" -42"), &value) && value == -42);
+    CHECK(evil_bw16_line_parse_int(view("+7"), &value) && value == 7);
+    CHECK(evil_bw16_line_parse_int(view("2147483647"), &value) && value == 2147483647);
+    CHECK(evil_bw16_line_parse_int(view("-2147483648"), &value) && value == (-2147483647 - 1));
+    CHECK(!evil_bw16_line_parse_int(view("2147483648"), &value));
+    CHECK(!evil_bw16_line_parse_int(view("-"), &value));
+    CHECK(!evil_bw16_line_parse_int(view(""), &value));
+}
+
+static void test_line_fields(void) {
+    EvilBw16LineView rest = view("a,,bc");
+    EvilBw16LineView field;
+    CHECK(evil_bw16_line_next_field(&rest, ',', &field) && field.len == 1 && field.data[0] == 'a');
+    CHECK(evil_bw16_line_next_field(&rest, ',', &field) && field.len == 0);
+    CHECK(evil_bw16_line_next_field(&rest, ',', &field) && field.len == 2);
+    CHECK(!evil_bw16_line_next_field(&rest, ',', &field));
+
+    CHECK(evil_bw16_line_contains(view("abcabd"), "abd"));
+    CHECK(!evil_bw16_line_contains(view("abcab"), "abd"));
+}
+
+static void test_filter(void) {
+    static const EvilBw16FilterRule rules[] = {
+        {.pattern = "WebSocket"},
+        {.pattern = "HTTP GET"},
+        {.pattern = "\"type\"", .first_char = '{'},
+    };
+    EvilBw16LineFilter* filter = evil_bw16_filter_alloc(rules, COUNT_OF(rules));
+    CHECK(filter);
+
+    CHECK_EQ(evil_bw16_filter_match(filter, view("[INFO] WebSocket client 1")), 0);
+    CHECK_EQ(evil_bw16_filter_match(filter, view("HTTP GET /")), 1);
+    CHECK_EQ(evil_bw16_filter_match(filter, view("{\"type\":\"status\"}")), 2);
+    // Anchored rule: the pattern alone does not drop the line
+    CHECK_EQ(evil_bw16_filter_match(filter, view("[INFO] \"type\" field")), -1);
+    CHECK_EQ(evil_bw16_filter_match(filter, view("[INFO] Web Socket")), -1);
+    CHECK_EQ(evil_bw16_filter_match(filter, view("")), -1);
+
+    uint32_t lines, bytes;
+    evil_bw16_filter_get_stats(filter, 0, &lines, &bytes);
+    CHECK_EQ(lines, 1);
+    CHECK_EQ(bytes, strlen("[INFO] WebSocket client 1"));
+    evil_bw16_filter_free(filter);
+}
+
+int main(void) {
+    RUN_TEST(test_classify_tags);
+    RUN_TEST(test_classify_rejects);
+    RUN_TEST(test_scan_result_fields);
+    RUN_TEST(test_scan_result_band_and_ssid);
+    RUN_TEST(test_scan_result_rejects);
+    RUN_TEST(test_parse_int);
+    RUN_TEST(test_line_fields);
+    RUN_TEST(test_filter);
+    return host_test_result();
+}
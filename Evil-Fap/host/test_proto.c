@@ -0,0 +1,227 @@
+#include "host_test.h"
+#include "host_app.h"
+
+// Binary framing: CRC-16, frame and payload codecs, stream decoding and resync, and the
+// worker's handling of bad frames
+
+static void test_crc16_vectors(void) {
+    // CRC-16/CCITT-FALSE check value
+    CHECK_EQ(evil_bw16_proto_crc16(0xFFFF, (const uint8_t*)"123456789", 9), 0x29B1);
+    CHECK_EQ(evil_bw16_proto_crc16(0xFFFF, NULL, 0), 0xFFFF);
+
+    // Running the CRC in pieces gives the same result
+    const uint16_t head = evil_bw16_proto_crc16(0xFFFF, (const uint8_t*)"1234", 4);
+    CHECK_EQ(evil_bw16_proto_crc16(head, (const uint8_t*)"56789", 5), 0x29B1);
+}
+
+static void test_encode_layout(void) {
+    uint8_t frame[EVIL_BW16_PROTO_MAX_FRAME];
+    CHECK_EQ(evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"hi", 2, frame, sizeof(frame)), 8);
+    const uint8_t expected[] = {0xA5, 0x5A, 0x02, 0x01, 'h', 'i', 0x94, 0x21};
+    CHECK(memcmp(frame, expected, sizeof(expected)) == 0);
+
+    // Empty payload, CRC over len and type only
+    CHECK_EQ(evil_bw16_proto_encode(EvilBw16ProtoTypeScanDone, NULL, 0, frame, sizeof(frame)), 6);
+    CHECK_EQ(frame[4], 0x6C);
+    CHECK_EQ(frame[5], 0x2D);
+
+    // Too big for the payload limit or the output buffer
+    uint8_t payload[EVIL_BW16_PROTO_MAX_PAYLOAD + 1] = {0};
+    CHECK_EQ(evil_bw16_proto_encode(EvilBw16ProtoTypeText, payload, sizeof(payload), frame, sizeof(frame)), 0);
+    CHECK_EQ(evil_bw16_proto_encode(EvilBw16ProtoTypeText, payload, 10, frame, 15), 0);
+    CHECK_EQ(evil_bw16_proto_encode(EvilBw16ProtoTypeText, payload, 10, frame, 16), 16);
+}
+
+// Feed a whole buffer, collecting the frames it completes
+static size_t test_decode_all(EvilBw16ProtoDecoder* decoder, const uint8_t* data, size_t len, uint8_t* types, size_t max_frames) {
+    size_t frames = 0;
+    size_t pos = 0;
+    while(pos < len) {
+        bool frame;
+        pos += evil_bw16_proto_decoder_feed(decoder, data + pos, len - pos, &frame);
+        if(frame && frames < max_frames) types[frames++] = decoder->type;
+    }
+    return frames;
+}
+
+static void test_scan_result_round_trip(void) {
+    EvilBw16ProtoDecoder decoder;
+    evil_bw16_proto_decoder_init(&decoder);
+
+    for(uint8_t index = 0; index < 50; index++) {
+        EvilBw16ProtoScanResult sent, received;
+        evil_bw16_proto_standin_network(0x5EED, index, &sent);
+        uint8_t frame[EVIL_BW16_PROTO_MAX_FRAME];
+        const size_t len = evil_bw16_proto_encode_scan_result(&sent, frame, sizeof(frame));
+        CHECK(len > 0);
+
+        // Byte by byte, so every decoder state sees a block boundary
+        bool done = false;
+        for(size_t i = 0; i < len; i++) {
+            bool frame_done;
+            CHECK_EQ(evil_bw16_proto_decoder_feed(&decoder, frame + i, 1, &frame_done), 1);
+            CHECK(!done);
+            done = frame_done;
+        }
+        CHECK(done);
+        CHECK_EQ(decoder.type, EvilBw16ProtoTypeScanResult);
+        CHECK(evil_bw16_proto_parse_scan_result(decoder.payload, decoder.len, &received));
+        CHECK_EQ(received.index, sent.index);
+        CHECK_EQ(received.channel, sent.channel);
+        CHECK_EQ(received.rssi, sent.rssi);
+        CHECK_EQ(received.band_5ghz, sent.band_5ghz);
+        CHECK(memcmp(received.bssid, sent.bssid, 6) == 0);
+        CHECK_EQ(received.ssid_len, sent.ssid_len);
+        CHECK(strcmp(received.ssid, sent.ssid) == 0);
+    }
+    CHECK_EQ(decoder.frames, 50);
+    CHECK_EQ(decoder.crc_errors, 0);
+    CHECK_EQ(decoder.skipped, 0);
+}
+
+static void test_frame_info_round_trip(void) {
+    const EvilBw16ProtoFrameInfo sent = {.data = true, .eapol = true, .subtype = 8, .channel = 149, .rssi = -77};
+    EvilBw16ProtoFrameInfo received;
+    uint8_t frame[EVIL_BW16_PROTO_MAX_FRAME];
+    const size_t len = evil_bw16_proto_encode_frame_info(&sent, frame, sizeof(frame));
+
+    EvilBw16ProtoDecoder decoder;
+    evil_bw16_proto_decoder_init(&decoder);
+    bool done;
+    CHECK_EQ(evil_bw16_proto_decoder_feed(&decoder, frame, len, &done), len);
+    CHECK(done);
+    CHECK(evil_bw16_proto_parse_frame_info(decoder.payload, decoder.len, &received));
+    CHECK(received.data && received.eapol);
+    CHECK_EQ(received.subtype, 8);
+    CHECK_EQ(received.channel, 149);
+    CHECK_EQ(received.rssi, -77);
+
+    // Payloads of the wrong size are rejected
+    CHECK(!evil_bw16_proto_parse_frame_info(decoder.payload, 3, &received));
+    EvilBw16ProtoScanResult result;
+    CHECK(!evil_bw16_proto_parse_scan_result(decoder.payload, 9, &result));
+}
+
+static void test_crc_mismatch_dropped(void) {
+    uint8_t stream[64];
+    size_t len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"bad", 3, stream, sizeof(stream));
+    stream[5] ^= 0x01;  // Flip a payload bit
+    len += evil_bw16_proto_encode(EvilBw16ProtoTypeScanDone, (const uint8_t*)"\x07", 1, stream + len, sizeof(stream) - len);
+
+    EvilBw16ProtoDecoder decoder;
+    evil_bw16_proto_decoder_init(&decoder);
+    uint8_t types[4];
+    CHECK_EQ(test_decode_all(&decoder, stream, len, types, COUNT_OF(types)), 1);
+    CHECK_EQ(types[0], EvilBw16ProtoTypeScanDone);
+    CHECK_EQ(decoder.payload[0], 7);
+    CHECK_EQ(decoder.crc_errors, 1);
+    CHECK_EQ(decoder.frames, 1);
+
+    // A corrupted CRC byte is dropped the same way
+    len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"ok", 2, stream, sizeof(stream));
+    stream[len - 1] ^= 0x80;
+    CHECK_EQ(test_decode_all(&decoder, stream, len, types, COUNT_OF(types)), 0);
+    CHECK_EQ(decoder.crc_errors, 2);
+}
+
+static void test_resync_after_garbage(void) {
+    uint8_t stream[128];
+    size_t len = 0;
+    // Text noise, a lone first sync byte, and a sync byte repeated right before a real frame
+    const char noise[] = "boot: rtl8720dn\r\n";
+    memcpy(stream, noise, sizeof(noise) - 1);
+    len += sizeof(noise) - 1;
+    stream[len++] = EVIL_BW16_PROTO_SYNC1;
+    stream[len++] = 'x';
+    stream[len++] = EVIL_BW16_PROTO_SYNC1;
+    len += evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"[INFO] up", 9, stream + len, sizeof(stream) - len);
+    len += evil_bw16_proto_encode(EvilBw16ProtoTypeScanDone, (const uint8_t*)"\x00", 1, stream + len, sizeof(stream) - len);
+
+    EvilBw16ProtoDecoder decoder;
+    evil_bw16_proto_decoder_init(&decoder);
+    uint8_t types[4];
+    CHECK_EQ(test_decode_all(&decoder, stream, len, types, COUNT_OF(types)), 2);
+    CHECK_EQ(types[0], EvilBw16ProtoTypeText);
+    CHECK_EQ(types[1], EvilBw16ProtoTypeScanDone);
+    // The noise, the lone pair, and the first of the two sync bytes
+    CHECK_EQ(decoder.skipped, sizeof(noise) - 1 + 3);
+    CHECK_EQ(decoder.crc_errors, 0);
+
+    // A reset mid-frame drops the partial frame but keeps the counters
+    evil_bw16_proto_decoder_reset(&decoder);
+    bool done;
+    evil_bw16_proto_decoder_feed(&decoder, stream + sizeof(noise) + 2, 5, &done);
+    evil_bw16_proto_decoder_reset(&decoder);
+    CHECK_EQ(test_decode_all(&decoder, stream + sizeof(noise) + 2, len - sizeof(noise) - 2, types, COUNT_OF(types)), 2);
+    CHECK_EQ(decoder.frames, 4);
+}
+
+// The worker drops bad frames, and falls back to text when only text arrives
+typedef struct {
+    uint32_t lines;
+    char last[64];
+} TestInfoLines;
+
+static void test_record_info(EvilBw16LineView line, void* context) {
+    TestInfoLines* seen = context;
+    const size_t len = MIN(line.len, sizeof(seen->last) - 1);
+    memcpy(seen->last, line.data, len);
+    seen->last[len] = '\0';
+    __atomic_add_fetch(&seen->lines, 1, __ATOMIC_RELEASE);
+}
+
+static void test_inject(EvilBw16UartWorker* worker, const uint8_t* data, size_t len) {
+    CHECK_EQ(evil_bw16_uart_inject_rx(worker, data, len, true), len);
+    for(uint32_t waited = 0; evil_bw16_uart_rx_available(worker) && waited < 1000; waited++) {
+        furi_delay_ms(1);
+    }
+    furi_delay_ms(5);  // The last line or frame is handled after its bytes are released
+}
+
+static void test_worker_crc_and_fallback(void) {
+    EvilBw16App* app = evil_bw16_host_app_alloc();
+    evil_bw16_host_app_start(app);
+    EvilBw16UartWorker* worker = app->uart_worker;
+    TestInfoLines seen = {0};
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseInfo, test_record_info, &seen);
+    evil_bw16_uart_pause_rx(worker, true);
+    evil_bw16_uart_force_protocol(worker, true);
+
+    uint8_t stream[EVIL_BW16_PROTO_MAX_FRAME * 2];
+    size_t len = evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"[INFO] corrupted", 16, stream, sizeof(stream));
+    stream[8] ^= 0x20;
+    len += evil_bw16_proto_encode(EvilBw16ProtoTypeText, (const uint8_t*)"[INFO] framed", 13, stream + len, sizeof(stream) - len);
+    test_inject(worker, stream, len);
+
+    EvilBw16UartStats stats;
+    evil_bw16_uart_get_stats(worker, &stats);
+    CHECK(stats.binary_protocol);
+    CHECK_EQ(stats.frames, 1);
+    CHECK_EQ(stats.frame_crc_errors, 1);
+    CHECK_EQ(seen.lines, 1);
+    CHECK(strcmp(seen.last, "[INFO] framed") == 0);
+
+    // The BW16 rebooted into text: give up on frames once enough bytes fail to decode
+    const char* reboot = "[INFO] Evil-BW16 ready\r\n[INFO] Evil-BW16 firmware v1.0, 115200 baud\r\n[INFO] after\r\n";
+    test_inject(worker, (const uint8_t*)reboot, strlen(reboot));
+    evil_bw16_uart_get_stats(worker, &stats);
+    CHECK(!stats.binary_protocol);
+    CHECK_EQ(stats.proto_fallbacks, 1);
+
+    const char* text = "[INFO] text again\r\n";
+    test_inject(worker, (const uint8_t*)text, strlen(text));
+    CHECK(strcmp(seen.last, "[INFO] text again") == 0);
+
+    evil_bw16_host_app_free(app);
+}
+
+int main(void) {
+    RUN_TEST(test_crc16_vectors);
+    RUN_TEST(test_encode_layout);
+    RUN_TEST(test_scan_result_round_trip);
+    RUN_TEST(test_frame_info_round_trip);
+    RUN_TEST(test_crc_mismatch_dropped);
+    RUN_TEST(test_resync_after_garbage);
+    RUN_TEST(test_worker_crc_and_fallback);
+    return host_test_result();
+}
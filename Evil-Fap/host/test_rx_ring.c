@@ -0,0 +1,257 @@
+#include "host_test.h"
+#include "host_app.h"
+#include <sys/socket.h>
+#include <unistd.h>
+
+// RX ring and line framing. The worker's statics are reached by building the UART
+// source into this test, so it links without evil_bw16_uart.o.
+#include "../evil_bw16_uart.c"
+
+#define TEST_MAX_LINES (16)
+
+typedef struct {
+    char lines[TEST_MAX_LINES][LINE_BUFFER_SIZE];
+    size_t count;
+} TestLines;
+
+static void test_record_line(EvilBw16LineView line, void* context) {
+    TestLines* seen = context;
+    furi_check(seen->count < TEST_MAX_LINES);
+    memcpy(seen->lines[seen->count], line.data, line.len);
+    seen->lines[seen->count][line.len] = '\0';
+    seen->count++;
+}
+
+// A worker without a thread or serial port: the test is the ISR and drains by hand
+static EvilBw16UartWorker* test_worker_alloc(size_t ring_size, TestLines* seen) {
+    EvilBw16UartWorker* worker = malloc(sizeof(EvilBw16UartWorker));
+    worker->webui_filter = evil_bw16_filter_alloc(uart_webui_filter_rules, COUNT_OF(uart_webui_filter_rules));
+    worker->rx_ring.data = malloc(ring_size);
+    worker->rx_ring.mask = ring_size - 1;
+    worker->echo_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->waiter_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->capture_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    worker->line_buffer = malloc(LINE_BUFFER_SIZE);
+    for(size_t type = 0; type < EvilBw16ResponseTypeNum; type++) {
+        evil_bw16_uart_set_response_handler(worker, type, test_record_line, seen);
+    }
+    return worker;
+}
+
+static void test_worker_free(EvilBw16UartWorker* worker) {
+    evil_bw16_filter_free(worker->webui_filter);
+    furi_mutex_free(worker->echo_mutex);
+    furi_mutex_free(worker->waiter_mutex);
+    furi_mutex_free(worker->capture_mutex);
+    free(worker->rx_ring.data);
+    free(worker->line_buffer);
+    free(worker);
+}
+
+// Receive bytes the way uart_on_irq_cb() does; the test keeps them within the free space
+static void test_receive(EvilBw16UartWorker* worker, const char* text) {
+    EvilBw16RxRing* ring = &worker->rx_ring;
+    const size_t len = strlen(text);
+    furi_check(ring->head - ring->tail + len <= ring->mask + 1);
+    for(size_t i = 0; i < len; i++) {
+        ring->data[(ring->head + i) & ring->mask] = (uint8_t)text[i];
+    }
+    __atomic_store_n(&ring->head, ring->head + len, __ATOMIC_RELEASE);
+}
+
+static void test_line_completes_in_place(void) {
+    TestLines seen = {0};
+    EvilBw16UartWorker* worker = test_worker_alloc(64, &seen);
+
+    // A partial line stays in the ring and the next drain only scans what is new
+    test_receive(worker, "[INFO] hel");
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 0);
+    CHECK_EQ(worker->rx_ring.tail, 0);
+    CHECK_EQ(worker->scan_pos, 10);
+    CHECK_EQ(worker->line_len, 0);
+
+    test_receive(worker, "lo\r\n");
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 1);
+    CHECK(strcmp(seen.lines[0], "[INFO] hello") == 0);
+    CHECK_EQ(worker->rx_ring.tail, 14);
+    CHECK_EQ(worker->scan_pos, 0);
+
+    test_worker_free(worker);
+}
+
+static void test_line_straddles_wrap(void) {
+    TestLines seen = {0};
+    EvilBw16UartWorker* worker = test_worker_alloc(64, &seen);
+
+    test_receive(worker, "[INFO] first line that fills most of it\n");  // 40 bytes
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 1);
+    CHECK_EQ(worker->rx_ring.tail, 40);
+
+    // The next line runs into the end of the ring memory: what is there gets stashed
+    test_receive(worker, "[DATA] second line runs ");  // 24 bytes, up to the wrap
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 1);
+    CHECK_EQ(worker->rx_ring.tail, 64);
+    CHECK_EQ(worker->line_len, 24);
+    CHECK_EQ(worker->scan_pos, 0);
+
+    // Its end arrives at the start of the ring memory, in two pieces
+    test_receive(worker, "over the ");
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 1);
+    CHECK_EQ(worker->line_len, 24);
+    CHECK_EQ(worker->scan_pos, 9);
+
+    test_receive(worker, "wrap\nnext\n");
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 3);
+    CHECK(strcmp(seen.lines[1], "[DATA] second line runs over the wrap") == 0);
+    CHECK(strcmp(seen.lines[2], "next") == 0);
+    CHECK_EQ(worker->line_len, 0);
+    CHECK_EQ(worker->scan_pos, 0);
+    CHECK_EQ(worker->rx_ring.tail, worker->rx_ring.head);
+
+    test_worker_free(worker);
+}
+
+static void test_line_end_at_wrap(void) {
+    TestLines seen = {0};
+    EvilBw16UartWorker* worker = test_worker_alloc(32, &seen);
+
+    // "\r" is the last byte of the ring memory and "\n" the first: one line, no empty one
+    test_receive(worker, "[INFO] ends right at the wraps!\r");
+    CHECK_EQ(worker->rx_ring.head, 32);
+    uart_drain_rx(worker);
+    test_receive(worker, "\n[CMD] ok\n");
+    uart_drain_rx(worker);
+    CHECK_EQ(seen.count, 2);
+    CHECK(strcmp(seen.lines[0], "[INFO] ends right at the wraps!") == 0);
+    CHECK(strcmp(seen.lines[1], "[CMD] ok") == 0);
+    CHECK_EQ(worker->line_len, 0);
+
+    test_worker_free(worker);
+}
+
+static void test_overlong_line_dropped(void) {
+    TestLines seen = {0};
+    EvilBw16UartWorker* worker = test_worker_alloc(1024, &seen);
+
+    // Longer than the stash: dropped whole, including the part after the wrap
+    char text[LINE_BUFFER_SIZE + 100];
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    test_receive(worker, "[INFO] before\n");
+    test_receive(worker, text);
+    uart_drain_rx(worker);
+    CHECK_EQ(worker->truncated_lines, 1);
+    CHECK(worker->line_overflow);
+    test_receive(worker, text + 300);  // Crosses the wrap
+    test_receive(worker, "\n[INFO] after\n");
+    uart_drain_rx(worker);
+
+    CHECK_EQ(seen.count, 2);
+    CHECK(strcmp(seen.lines[0], "[INFO] before") == 0);
+    CHECK(strcmp(seen.lines[1], "[INFO] after") == 0);
+    CHECK(!worker->line_overflow);
+    CHECK_EQ(worker->truncated_lines, 1);
+
+    test_worker_free(worker);
+}
+
+// Sustained line rate through the real ISR path: a socket stands in for the UART, the
+// serial stand-in's reader thread delivers it at the wire rate into uart_on_irq_cb() and
+// the worker thread frames. The lines are written all at once; the wire paces them.
+#ifdef __SANITIZE_THREAD__
+// ThreadSanitizer slows the worker several times over; check the same path at a rate it keeps up with
+#define SUSTAINED_BAUD (230400)
+#else
+#define SUSTAINED_BAUD (921600)
+#endif
+#define SUSTAINED_LINES (SUSTAINED_BAUD / 230)  // About two seconds of back to back lines at that rate
+#define SUSTAINED_STALL_MS (1000)  // No new line for this long means the rest was lost
+
+typedef struct {
+    uint32_t next_seq;
+    uint32_t bad;
+} SustainedState;
+
+static int sustained_format(char* out, size_t size, uint32_t seq, const char* end) {
+    return snprintf(out, size, "[DATA] seq %08lu ch 6 rssi -42 len 118%s", (unsigned long)seq, end);
+}
+
+static void test_sustained_line(EvilBw16LineView line, void* context) {
+    SustainedState* state = context;
+    char expected[64];
+    const int len = sustained_format(expected, sizeof(expected), state->next_seq, "");
+    if(line.len != (size_t)len || memcmp(line.data, expected, len) != 0) {
+        state->bad++;
+    }
+    __atomic_store_n(&state->next_seq, state->next_seq + 1, __ATOMIC_RELEASE);
+}
+
+static void test_sustained_rate(void) {
+    int fds[2];
+    furi_check(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    furi_hal_serial_host_connect(FuriHalSerialIdUsart, fds[0]);
+
+    EvilBw16App* app = evil_bw16_host_app_alloc();
+    evil_bw16_host_app_start(app);
+    EvilBw16UartWorker* worker = app->uart_worker;
+    furi_hal_serial_set_br(worker->serial_handle, SUSTAINED_BAUD);
+    SustainedState state = {0};
+    evil_bw16_uart_set_response_handler(worker, EvilBw16ResponseData, test_sustained_line, &state);
+
+    const uint32_t start = furi_get_tick();
+    size_t sent_bytes = 0;
+    char line[64];
+    for(uint32_t seq = 0; seq < SUSTAINED_LINES; seq++) {
+        const int len = sustained_format(line, sizeof(line), seq, "\r\n");
+        furi_check(write(fds[1], line, len) == len);
+        sent_bytes += len;
+    }
+
+    // Wait for as long as lines keep arriving, however slowly a loaded host delivers them
+    const uint32_t wire_ms = (uint32_t)((uint64_t)sent_bytes * 10 * 1000 / SUSTAINED_BAUD);
+    uint32_t seen = 0;
+    uint32_t last_progress = start;
+    for(;;) {
+        const uint32_t next_seq = __atomic_load_n(&state.next_seq, __ATOMIC_ACQUIRE);
+        if(next_seq >= SUSTAINED_LINES) break;
+        if(next_seq != seen) {
+            seen = next_seq;
+            last_progress = furi_get_tick();
+        } else if(furi_get_tick() - last_progress >= SUSTAINED_STALL_MS) {
+            break;
+        }
+        furi_delay_ms(10);
+    }
+    const uint32_t elapsed = furi_get_tick() - start;
+
+    EvilBw16UartStats stats;
+    evil_bw16_uart_get_stats(worker, &stats);
+    CHECK_EQ(__atomic_load_n(&state.next_seq, __ATOMIC_ACQUIRE), SUSTAINED_LINES);
+    CHECK_EQ(state.bad, 0);
+    CHECK_EQ(stats.dropped_bytes, 0);
+    CHECK_EQ(stats.truncated_lines, 0);
+    CHECK(elapsed >= wire_ms);
+    printf("     %u lines, %zu bytes in %lu ms (wire %lu ms), ring high water %lu of %lu\n",
+           SUSTAINED_LINES, sent_bytes, (unsigned long)elapsed, (unsigned long)wire_ms,
+           (unsigned long)stats.high_water, (unsigned long)stats.ring_size);
+
+    evil_bw16_host_app_free(app);
+    furi_hal_serial_host_connect(FuriHalSerialIdUsart, -1);
+    close(fds[1]);
+    close(fds[0]);
+}
+
+int main(void) {
+    RUN_TEST(test_line_completes_in_place);
+    RUN_TEST(test_line_straddles_wrap);
+    RUN_TEST(test_line_end_at_wrap);
+    RUN_TEST(test_overlong_line_dropped);
+    RUN_TEST(test_sustained_rate);
+    return host_test_result();
+}